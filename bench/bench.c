@@ -0,0 +1,651 @@
+#include "bench_suite.h"
+#include "eventemitter.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifdef EVENTEMITTER_THREADS
+#include "eventemitter_concurrent.h"
+#include "eventemitter_sharded.h"
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+#if defined(EVENTEMITTER_THREADS) && defined(__linux__)
+#include "eventemitter_bus.h"
+#include <sched.h>
+#include <sys/wait.h>
+#endif
+
+#define BENCH_OPERATIONS     1000000
+#define BENCH_MAX_THREADS    64
+#define BENCH_THREAD_EVENTS  64
+#define BENCH_QUEUE_BATCH    1024
+#define BENCH_EMIT_BATCH     256
+#define BENCH_HEAVY_EVENTS   200
+#define BENCH_HEAVY_WORK     20000
+#define BENCH_BUS_CAPACITY   1024
+#define BENCH_BUS_ROUNDTRIPS 20000
+
+#ifdef EVENTEMITTER_THREADS
+struct BenchThread
+{
+  pthread_t                     thread;
+  struct EventEmitter           *event_emitter;
+  pthread_mutex_t               *lock;
+  struct EventEmitterConcurrent *concurrent_emitter;
+  struct EventEmitter           *shard;
+  size_t                        invoked;
+};
+#endif
+
+static int _bench_sink = 0;
+
+
+static double _bench_now(void)
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+
+  return((double)now.tv_sec * 1e9 + (double)now.tv_nsec);
+}
+
+
+static void _bench_listener(void *event_data, void *context)
+{
+  (void)event_data;
+  (void)context;
+
+  _bench_sink++;
+}
+
+
+static int _bench_event_id(size_t index)
+{
+  // spread the IDs so they do not form a single dense block
+  return((int)(index * 7919));
+}
+
+
+static void _bench_event_ids(size_t event_count)
+{
+  struct EventEmitter *event_emitter = eventemitter_new();
+
+  double              start = _bench_now();
+
+  for (size_t index = 0; index < event_count; index++)
+  {
+    eventemitter_on(event_emitter, _bench_event_id(index), _bench_listener, NULL);
+  }
+  double add_ns = (_bench_now() - start) / (double)event_count;
+
+  start = _bench_now();
+  for (size_t index = 0; index < BENCH_OPERATIONS; index++)
+  {
+    eventemitter_emit(event_emitter, _bench_event_id((index * 31) % event_count), NULL);
+  }
+  double emit_ns = (_bench_now() - start) / BENCH_OPERATIONS;
+
+  start = _bench_now();
+  for (size_t index = 0; index < event_count; index++)
+  {
+    eventemitter_remove_listener(event_emitter, _bench_event_id(index), (unsigned int)(index + 1));
+  }
+  double remove_ns = (_bench_now() - start) / (double)event_count;
+
+  printf("%-10zu %12.1f %12.1f %12.1f\n", event_count, add_ns, emit_ns, remove_ns);
+
+  eventemitter_release(event_emitter);
+}
+
+
+static void _bench_id_range(const char *name, struct EventEmitter *event_emitter, size_t event_count)
+{
+  for (size_t index = 0; index < event_count; index++)
+  {
+    eventemitter_on(event_emitter, (int)index, _bench_listener, NULL);
+  }
+
+  double start = _bench_now();
+  for (size_t index = 0; index < BENCH_OPERATIONS; index++)
+  {
+    eventemitter_emit(event_emitter, (int)(index % event_count), NULL);
+  }
+  double emit_ns = (_bench_now() - start) / BENCH_OPERATIONS;
+
+  printf("%-10s %12.1f\n", name, emit_ns);
+
+  eventemitter_release(event_emitter);
+}
+
+
+static void _bench_listeners(size_t listener_count)
+{
+  struct EventEmitter *event_emitter = eventemitter_new();
+
+  for (size_t index = 0; index < listener_count; index++)
+  {
+    eventemitter_on(event_emitter, 1, _bench_listener, NULL);
+  }
+
+  size_t operations = BENCH_OPERATIONS / listener_count + 1;
+  double start      = _bench_now();
+  for (size_t index = 0; index < operations; index++)
+  {
+    eventemitter_emit(event_emitter, 1, NULL);
+  }
+  double emit_ns = (_bench_now() - start) / (double)operations;
+
+  printf("%-10zu %12.1f %12.2f\n", listener_count, emit_ns, emit_ns / (double)listener_count);
+
+  eventemitter_release(event_emitter);
+}
+
+
+static void _bench_remove_by_id(size_t listener_count)
+{
+  struct EventEmitter *event_emitter = eventemitter_new();
+
+  for (size_t index = 0; index < listener_count; index++)
+  {
+    eventemitter_on(event_emitter, 1, _bench_listener, NULL);
+  }
+
+  // remove in an order unrelated to the registration order
+  double start = _bench_now();
+  for (size_t index = 0; index < listener_count; index++)
+  {
+    eventemitter_remove_listener_by_id(event_emitter, (unsigned int)((index * 7919) % listener_count + 1));
+  }
+  double remove_ns = (_bench_now() - start) / (double)listener_count;
+
+  printf("%-10zu %12.1f\n", listener_count, remove_ns);
+
+  eventemitter_release(event_emitter);
+}
+
+
+static void _bench_add_listeners(size_t listener_count)
+{
+  struct EventEmitterListenerSpec *specs = malloc(listener_count * sizeof(struct EventEmitterListenerSpec));
+
+  for (size_t index = 0; index < listener_count; index++)
+  {
+    specs[index].event_id = _bench_event_id(index % 64);
+    specs[index].callback = _bench_listener;
+    specs[index].context  = NULL;
+    specs[index].once     = false;
+    specs[index].prepend  = false;
+  }
+
+  struct EventEmitter *event_emitter = eventemitter_new();
+  double              start          = _bench_now();
+  for (size_t index = 0; index < listener_count; index++)
+  {
+    eventemitter_on(event_emitter, specs[index].event_id, specs[index].callback, specs[index].context);
+  }
+  double add_ns = (_bench_now() - start) / (double)listener_count;
+  eventemitter_release(event_emitter);
+
+  event_emitter = eventemitter_new();
+  start         = _bench_now();
+  eventemitter_add_listeners(event_emitter, specs, listener_count, NULL);
+  double bulk_ns = (_bench_now() - start) / (double)listener_count;
+  eventemitter_release(event_emitter);
+
+  printf("%-10zu %12.1f %12.1f\n", listener_count, add_ns, bulk_ns);
+
+  free(specs);
+}
+
+
+static void _bench_emit_batch(size_t event_count)
+{
+  struct EventEmitter *event_emitter = eventemitter_new();
+
+  int                 event_ids[BENCH_EMIT_BATCH];
+  void                *event_data[BENCH_EMIT_BATCH];
+
+  for (size_t index = 0; index < event_count; index++)
+  {
+    eventemitter_on(event_emitter, _bench_event_id(index), _bench_listener, NULL);
+  }
+  for (size_t index = 0; index < BENCH_EMIT_BATCH; index++)
+  {
+    event_ids[index]  = _bench_event_id(index % event_count);
+    event_data[index] = NULL;
+  }
+
+  size_t rounds = BENCH_OPERATIONS / BENCH_EMIT_BATCH;
+  double start  = _bench_now();
+  for (size_t round = 0; round < rounds; round++)
+  {
+    for (size_t index = 0; index < BENCH_EMIT_BATCH; index++)
+    {
+      eventemitter_emit(event_emitter, event_ids[index], event_data[index]);
+    }
+  }
+  double emit_ns = (_bench_now() - start) / (double)(rounds * BENCH_EMIT_BATCH);
+
+  start = _bench_now();
+  for (size_t round = 0; round < rounds; round++)
+  {
+    eventemitter_emit_batch(event_emitter, event_ids, event_data, BENCH_EMIT_BATCH);
+  }
+  double batch_ns = (_bench_now() - start) / (double)(rounds * BENCH_EMIT_BATCH);
+
+  printf("%-10zu %12.1f %12.1f\n", event_count, emit_ns, batch_ns);
+
+  eventemitter_release(event_emitter);
+}
+
+#ifdef EVENTEMITTER_THREADS
+
+
+static void _bench_thread_listener(void *event_data, void *context)
+{
+  (void)context;
+
+  // each thread counts into its own stack counter, counters packed in the shared threads array would share cache lines
+  (*(size_t *)event_data)++;
+}
+
+
+static void *_bench_locked_emit_thread(void *context)
+{
+  struct BenchThread *bench_thread = (struct BenchThread *)context;
+  size_t             invoked       = 0;
+
+  for (size_t index = 0; index < BENCH_OPERATIONS; index++)
+  {
+    pthread_mutex_lock(bench_thread->lock);
+    eventemitter_emit(bench_thread->event_emitter, (int)(index % BENCH_THREAD_EVENTS), &invoked);
+    pthread_mutex_unlock(bench_thread->lock);
+  }
+  bench_thread->invoked = invoked;
+
+  return(NULL);
+}
+
+
+static void *_bench_concurrent_emit_thread(void *context)
+{
+  struct BenchThread *bench_thread = (struct BenchThread *)context;
+  size_t             invoked       = 0;
+
+  for (size_t index = 0; index < BENCH_OPERATIONS; index++)
+  {
+    eventemitter_concurrent_emit(bench_thread->concurrent_emitter, (int)(index % BENCH_THREAD_EVENTS), &invoked);
+  }
+  bench_thread->invoked = invoked;
+
+  return(NULL);
+}
+
+
+static void *_bench_sharded_emit_thread(void *context)
+{
+  struct BenchThread *bench_thread = (struct BenchThread *)context;
+  size_t             invoked       = 0;
+
+  for (size_t index = 0; index < BENCH_OPERATIONS; index++)
+  {
+    eventemitter_emit(bench_thread->shard, (int)(index % BENCH_THREAD_EVENTS), &invoked);
+  }
+  bench_thread->invoked = invoked;
+
+  return(NULL);
+}
+
+
+static double _bench_run_threads(struct BenchThread *threads, size_t thread_count, void *(*run)(void *))
+{
+  double start = _bench_now();
+
+  for (size_t index = 0; index < thread_count; index++)
+  {
+    pthread_create(&threads[index].thread, NULL, run, &threads[index]);
+  }
+  for (size_t index = 0; index < thread_count; index++)
+  {
+    pthread_join(threads[index].thread, NULL);
+    _bench_sink = _bench_sink + (int)(threads[index].invoked > 0);
+  }
+
+  // million emits per second over all threads
+  return((double)(thread_count * BENCH_OPERATIONS) * 1e3 / (_bench_now() - start));
+}
+
+
+static void _bench_threads(size_t thread_count)
+{
+  struct EventEmitter           *event_emitter      = eventemitter_new();
+  struct EventEmitterConcurrent *concurrent_emitter = eventemitter_concurrent_new();
+  struct EventEmitterSharded    *sharded_emitter    = eventemitter_sharded_new(thread_count, BENCH_THREAD_EVENTS);
+  pthread_mutex_t               lock;
+
+  pthread_mutex_init(&lock, NULL);
+  for (int index = 0; index < BENCH_THREAD_EVENTS; index++)
+  {
+    eventemitter_on(event_emitter, index, _bench_thread_listener, NULL);
+    eventemitter_on(event_emitter, index, _bench_thread_listener, NULL);
+    eventemitter_concurrent_add_listener(concurrent_emitter, index, _bench_thread_listener, NULL);
+    eventemitter_concurrent_add_listener(concurrent_emitter, index, _bench_thread_listener, NULL);
+  }
+
+  struct BenchThread threads[BENCH_MAX_THREADS];
+  for (size_t index = 0; index < thread_count; index++)
+  {
+    threads[index].event_emitter      = event_emitter;
+    threads[index].lock               = &lock;
+    threads[index].concurrent_emitter = concurrent_emitter;
+    threads[index].shard              = eventemitter_sharded_get_shard(sharded_emitter, index);
+    threads[index].invoked            = 0;
+    for (int event_id = 0; event_id < BENCH_THREAD_EVENTS; event_id++)
+    {
+      eventemitter_on(threads[index].shard, event_id, _bench_thread_listener, NULL);
+      eventemitter_on(threads[index].shard, event_id, _bench_thread_listener, NULL);
+    }
+  }
+
+  double locked_mops     = _bench_run_threads(threads, thread_count, _bench_locked_emit_thread);
+  double concurrent_mops = _bench_run_threads(threads, thread_count, _bench_concurrent_emit_thread);
+  double sharded_mops    = _bench_run_threads(threads, thread_count, _bench_sharded_emit_thread);
+
+  printf("%-10zu %14.2f %14.2f %14.2f\n", thread_count, locked_mops, concurrent_mops, sharded_mops);
+
+  pthread_mutex_destroy(&lock);
+  eventemitter_sharded_release(sharded_emitter);
+  eventemitter_concurrent_release(concurrent_emitter);
+  eventemitter_release(event_emitter);
+}
+
+
+static void _bench_queue(void)
+{
+  struct EventEmitter *event_emitter = eventemitter_new();
+
+  eventemitter_init_queue(event_emitter, BENCH_QUEUE_BATCH);
+  for (int index = 0; index < BENCH_THREAD_EVENTS; index++)
+  {
+    eventemitter_on(event_emitter, index, _bench_listener, NULL);
+  }
+
+  double start = _bench_now();
+  for (size_t index = 0; index < BENCH_OPERATIONS; index++)
+  {
+    eventemitter_emit(event_emitter, (int)(index % BENCH_THREAD_EVENTS), NULL);
+  }
+  double emit_ns = (_bench_now() - start) / BENCH_OPERATIONS;
+
+  // events are queued and dispatched in batches
+  double enqueue_ns  = 0;
+  double dispatch_ns = 0;
+  for (size_t batch = 0; batch < BENCH_OPERATIONS / BENCH_QUEUE_BATCH; batch++)
+  {
+    start = _bench_now();
+    for (size_t index = 0; index < BENCH_QUEUE_BATCH; index++)
+    {
+      eventemitter_enqueue(event_emitter, (int)(index % BENCH_THREAD_EVENTS), NULL);
+    }
+    double middle = _bench_now();
+    eventemitter_dispatch(event_emitter, 0);
+    enqueue_ns  = enqueue_ns + middle - start;
+    dispatch_ns = dispatch_ns + _bench_now() - middle;
+  }
+  size_t operations = BENCH_OPERATIONS / BENCH_QUEUE_BATCH * BENCH_QUEUE_BATCH;
+
+  // the same batches with the eventfd signaled by the first event of each batch and reset by the pending dispatch
+  double pending_ns = 0;
+  if (eventemitter_get_fd(event_emitter) >= 0)
+  {
+    start = _bench_now();
+    for (size_t batch = 0; batch < BENCH_OPERATIONS / BENCH_QUEUE_BATCH; batch++)
+    {
+      for (size_t index = 0; index < BENCH_QUEUE_BATCH; index++)
+      {
+        eventemitter_enqueue(event_emitter, (int)(index % BENCH_THREAD_EVENTS), NULL);
+      }
+      eventemitter_dispatch_pending(event_emitter);
+    }
+    pending_ns = _bench_now() - start;
+  }
+
+  printf("%-10s %12.1f\n", "emit", emit_ns);
+  printf("%-10s %12.1f\n", "enqueue", enqueue_ns / (double)operations);
+  printf("%-10s %12.1f\n", "dispatch", dispatch_ns / (double)operations);
+  printf("%-10s %12.1f\n", "eventfd", pending_ns / (double)operations);
+
+  eventemitter_release(event_emitter);
+}
+
+
+static void _bench_heavy_listener(void *event_data, void *context)
+{
+  (void)event_data;
+  (void)context;
+
+  // simulates a CPU heavy listener
+  volatile size_t value = 0;
+  for (size_t index = 0; index < BENCH_HEAVY_WORK; index++)
+  {
+    value = value + index;
+  }
+}
+
+
+static void _bench_emit_async(size_t worker_count)
+{
+  struct EventEmitter *event_emitter = eventemitter_new();
+
+  eventemitter_start_workers(event_emitter, worker_count);
+  for (int index = 0; index < 8; index++)
+  {
+    eventemitter_on(event_emitter, 1, _bench_heavy_listener, NULL);
+  }
+
+  double start = _bench_now();
+  for (size_t index = 0; index < BENCH_HEAVY_EVENTS; index++)
+  {
+    eventemitter_emit(event_emitter, 1, NULL);
+  }
+  double emit_us = (_bench_now() - start) / 1e3 / BENCH_HEAVY_EVENTS;
+
+  start = _bench_now();
+  for (size_t index = 0; index < BENCH_HEAVY_EVENTS; index++)
+  {
+    eventemitter_wait_async_emit(eventemitter_emit_async(event_emitter, 1, NULL));
+  }
+  double async_us = (_bench_now() - start) / 1e3 / BENCH_HEAVY_EVENTS;
+
+  printf("%-10zu %12.1f %12.1f\n", worker_count, emit_us, async_us);
+
+  eventemitter_release(event_emitter);
+}
+
+#endif
+
+#if defined(EVENTEMITTER_THREADS) && defined(__linux__)
+
+
+static void _bench_bus_listener(void *event_data, void *context)
+{
+  struct EventEmitterBusPayload *payload = (struct EventEmitterBusPayload *)event_data;
+
+  // reads the payload in place, as a real listener would
+  *(size_t *)context = *(size_t *)context + ((const unsigned char *)payload->data)[payload->size - 1];
+}
+
+
+static void _bench_bus_echo_listener(void *event_data, void *context)
+{
+  struct EventEmitterBusPayload *payload = (struct EventEmitterBusPayload *)event_data;
+
+  eventemitter_bus_emit((struct EventEmitterBus *)context, 1, payload->data, payload->size);
+}
+
+
+static void _bench_bus_receive(struct EventEmitterBus *bus, struct EventEmitter *event_emitter, size_t event_count)
+{
+  for (size_t received = 0; received < event_count; )
+  {
+    eventemitter_bus_wait(bus, -1);
+    received = received + (size_t)eventemitter_bus_dispatch(bus, event_emitter, event_count - received);
+  }
+}
+
+
+static void _bench_bus(size_t payload_size)
+{
+  struct EventEmitterBus *bus       = eventemitter_bus_create(BENCH_BUS_CAPACITY, payload_size);
+  struct EventEmitterBus *reply_bus = eventemitter_bus_create(BENCH_BUS_CAPACITY, payload_size);
+  char                   payload[1024];
+  size_t                 sum = 0;
+
+  memset(payload, 1, sizeof(payload));
+
+  // throughput, a child process emits and this process dispatches
+  double start = _bench_now();
+  pid_t  pid   = fork();
+  if (!pid)
+  {
+    for (size_t index = 0; index < BENCH_OPERATIONS; index++)
+    {
+      while (!eventemitter_bus_emit(bus, 1, payload, payload_size))
+      {
+        sched_yield();
+      }
+    }
+    _exit(0);
+  }
+  struct EventEmitter *event_emitter = eventemitter_new();
+  eventemitter_on(event_emitter, 1, _bench_bus_listener, &sum);
+  _bench_bus_receive(bus, event_emitter, BENCH_OPERATIONS);
+  double mevents = (double)BENCH_OPERATIONS * 1e3 / (_bench_now() - start);
+  waitpid(pid, NULL, 0);
+  eventemitter_release(event_emitter);
+
+  // round trip latency, a child process echoes each event back on the reply bus
+  pid = fork();
+  if (!pid)
+  {
+    struct EventEmitter *echo_emitter = eventemitter_new();
+    eventemitter_on(echo_emitter, 1, _bench_bus_echo_listener, reply_bus);
+    _bench_bus_receive(bus, echo_emitter, BENCH_BUS_ROUNDTRIPS);
+    _exit(0);
+  }
+  event_emitter = eventemitter_new();
+  eventemitter_on(event_emitter, 1, _bench_bus_listener, &sum);
+  start = _bench_now();
+  for (size_t index = 0; index < BENCH_BUS_ROUNDTRIPS; index++)
+  {
+    eventemitter_bus_emit(bus, 1, payload, payload_size);
+    _bench_bus_receive(reply_bus, event_emitter, 1);
+  }
+  double roundtrip_us = (_bench_now() - start) / 1e3 / BENCH_BUS_ROUNDTRIPS;
+  waitpid(pid, NULL, 0);
+
+  printf("%-10zu %12.2f %12.2f\n", payload_size, mevents, roundtrip_us);
+  _bench_sink = _bench_sink + (int)(sum > 0);
+
+  eventemitter_release(event_emitter);
+  eventemitter_bus_release(reply_bus);
+  eventemitter_bus_release(bus);
+} /* _bench_bus */
+
+#endif
+
+
+int main(int argc, char *argv[])
+{
+  // the scenario suite in a machine readable format for tracking regressions
+  if (argc > 1)
+  {
+    if (!strcmp(argv[1], "--csv"))
+    {
+      return(bench_suite_run(BENCH_SUITE_FORMAT_CSV) ? 0 : 1);
+    }
+    if (!strcmp(argv[1], "--json"))
+    {
+      return(bench_suite_run(BENCH_SUITE_FORMAT_JSON) ? 0 : 1);
+    }
+
+    fprintf(stderr, "usage: %s [--csv | --json]\n", argv[0]);
+    return(1);
+  }
+
+  printf("%-10s %12s %12s %12s\n", "events", "add ns/op", "emit ns/op", "remove ns/op");
+
+  for (size_t event_count = 10; event_count <= 100000; event_count = event_count * 10)
+  {
+    _bench_event_ids(event_count);
+  }
+
+  printf("\n%-10s %12s\n", "lookup", "emit ns/op");
+  _bench_id_range("hashed", eventemitter_new(), 64);
+  _bench_id_range("id range", eventemitter_new_with_id_range(0, 63), 64);
+
+  printf("\n%-10s %12s %12s\n", "listeners", "emit ns/op", "ns/listener");
+  size_t listener_counts[] = { 1, 8, 64, 1024 };
+  for (size_t index = 0; index < sizeof(listener_counts) / sizeof(size_t); index++)
+  {
+    _bench_listeners(listener_counts[index]);
+  }
+
+  printf("\n%-10s %12s\n", "listeners", "remove ns/op");
+  for (size_t listener_count = 100; listener_count <= 100000; listener_count = listener_count * 10)
+  {
+    _bench_remove_by_id(listener_count);
+  }
+
+  // listeners spread over 64 events
+  printf("\n%-10s %12s %12s\n", "listeners", "add ns/op", "bulk ns/op");
+  for (size_t listener_count = 1000; listener_count <= 100000; listener_count = listener_count * 10)
+  {
+    _bench_add_listeners(listener_count);
+  }
+
+  // a batch of 256 events over the given amount of distinct event IDs
+  printf("\n%-10s %12s %12s\n", "events", "emit ns/op", "batch ns/op");
+  size_t batch_event_counts[] = { 1, 8, 256 };
+  for (size_t index = 0; index < sizeof(batch_event_counts) / sizeof(size_t); index++)
+  {
+    _bench_emit_batch(batch_event_counts[index]);
+  }
+
+#ifdef EVENTEMITTER_THREADS
+  // emit throughput of a mutex protected emitter vs the concurrent emitter vs a shard per thread
+  long   cores       = sysconf(_SC_NPROCESSORS_ONLN);
+  size_t max_threads = cores > 0 ? (size_t)cores * 2 : 2;
+  printf("\n%-10s %14s %14s %14s\n", "threads", "mutex Mops/s", "lockfree Mops/s", "sharded Mops/s");
+  for (size_t thread_count = 1; thread_count <= max_threads && thread_count <= BENCH_MAX_THREADS; thread_count = thread_count * 2)
+  {
+    _bench_threads(thread_count);
+  }
+
+  printf("\n%-10s %12s\n", "queue", "ns/event");
+  _bench_queue();
+
+  // latency of an event with 8 CPU heavy listeners
+  printf("\n%-10s %12s %12s\n", "workers", "emit us", "async us");
+  for (size_t worker_count = 1; worker_count <= max_threads && worker_count <= BENCH_MAX_THREADS; worker_count = worker_count * 2)
+  {
+    _bench_emit_async(worker_count);
+  }
+#endif
+
+#if defined(EVENTEMITTER_THREADS) && defined(__linux__)
+  // events between two processes over the shared memory bus
+  printf("\n%-10s %12s %12s\n", "payload", "Mevents/s", "rtt us");
+  size_t bus_payload_sizes[] = { 8, 64, 1024 };
+  for (size_t index = 0; index < sizeof(bus_payload_sizes) / sizeof(size_t); index++)
+  {
+    _bench_bus(bus_payload_sizes[index]);
+  }
+#endif
+
+  return(_bench_sink > 0 ? 0 : 1);
+}
+
@@ -0,0 +1,566 @@
+#include "bench_suite.h"
+#include "eventemitter.h"
+#include "eventemitter_typed.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_SUITE_SAMPLES              20000
+#define BENCH_SUITE_SAMPLE_OPERATIONS    8
+#define BENCH_SUITE_WARMUP_OPERATIONS    10000
+#define BENCH_SUITE_TIMER_CALIBRATIONS   1000
+#define BENCH_SUITE_CHURN_LISTENERS      64
+#define BENCH_SUITE_PRIORITIES           8
+#define BENCH_SUITE_LARGE_EVENTS         100000
+#define BENCH_SUITE_TYPED_EVENTS         64
+#define BENCH_SUITE_TYPED_LISTENERS      8
+#define BENCH_SUITE_COALESCE_TICK        1000
+#define BENCH_SUITE_PAYLOAD_SIZE         64
+
+struct BenchSuiteContext
+{
+  struct EventEmitter *event_emitter;
+  size_t              allocations;
+  size_t              events;
+  size_t              listeners;
+  size_t              cursor;
+  unsigned int        *callback_ids;
+};
+
+struct BenchSuiteScenario
+{
+  const char *name;
+  size_t     events;
+  size_t     listeners;
+  bool       (*setup)(struct BenchSuiteContext *);
+  void       (*run)(struct BenchSuiteContext *, size_t /* operations */);
+};
+
+static int _bench_suite_sink = 0;
+
+EVENTEMITTER_DEFINE_TYPED(bench_suite_typed, size_t, void *, BENCH_SUITE_TYPED_EVENTS, BENCH_SUITE_TYPED_LISTENERS)
+
+static struct bench_suite_typed _bench_suite_typed_emitter;
+
+
+static double _bench_suite_now(void)
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+
+  return((double)now.tv_sec * 1e9 + (double)now.tv_nsec);
+}
+
+
+static double _bench_suite_timer_overhead(void)
+{
+  // the cheapest back to back reading, removed from each sample since the samples are only a few operations long
+  double overhead = 1e9;
+
+  for (size_t index = 0; index < BENCH_SUITE_TIMER_CALIBRATIONS; index++)
+  {
+    double start   = _bench_suite_now();
+    double elapsed = _bench_suite_now() - start;
+    if (elapsed < overhead)
+    {
+      overhead = elapsed;
+    }
+  }
+
+  return(overhead);
+}
+
+
+static void *_bench_suite_allocate(size_t size, void *context)
+{
+  ((struct BenchSuiteContext *)context)->allocations++;
+
+  return(malloc(size));
+}
+
+
+static void *_bench_suite_reallocate(void *pointer, size_t size, void *context)
+{
+  ((struct BenchSuiteContext *)context)->allocations++;
+
+  return(realloc(pointer, size));
+}
+
+
+static void _bench_suite_deallocate(void *pointer, void *context)
+{
+  (void)context;
+
+  free(pointer);
+}
+
+
+static void _bench_suite_listener(void *event_data, void *context)
+{
+  (void)event_data;
+  (void)context;
+
+  _bench_suite_sink++;
+}
+
+
+static void _bench_suite_unhandled_listener(int event_id, void *event_data, void *context)
+{
+  (void)event_id;
+  (void)event_data;
+  (void)context;
+
+  _bench_suite_sink++;
+}
+
+
+static int _bench_suite_event_id(size_t index)
+{
+  // spread the IDs so they do not form a single dense block
+  return((int)(index * 7919));
+}
+
+
+static int _bench_suite_large_event_id(size_t index)
+{
+  // scatter the IDs over the whole int range
+  return((int)(unsigned int)(index * 2654435761u));
+}
+
+
+static int _bench_suite_compare(const void *first, const void *second)
+{
+  double first_value  = *(const double *)first;
+  double second_value = *(const double *)second;
+
+  return((first_value > second_value) - (first_value < second_value));
+}
+
+
+static bool _bench_suite_setup_emit(struct BenchSuiteContext *context)
+{
+  for (size_t event = 0; event < context->events; event++)
+  {
+    for (size_t listener = 0; listener < context->listeners; listener++)
+    {
+      if (!eventemitter_on(context->event_emitter, _bench_suite_event_id(event), _bench_suite_listener, NULL))
+      {
+        return(false);
+      }
+    }
+  }
+
+  return(true);
+}
+
+
+static void _bench_suite_run_emit(struct BenchSuiteContext *context, size_t operations)
+{
+  for (size_t index = 0; index < operations; index++)
+  {
+    eventemitter_emit(context->event_emitter, _bench_suite_event_id(context->cursor % context->events), NULL);
+    context->cursor = context->cursor + 31;
+  }
+}
+
+
+static bool _bench_suite_setup_frozen(struct BenchSuiteContext *context)
+{
+  return(_bench_suite_setup_emit(context) && eventemitter_freeze(context->event_emitter));
+}
+
+
+static bool _bench_suite_setup_coalesce(struct BenchSuiteContext *context)
+{
+  return(_bench_suite_setup_emit(context) && eventemitter_init_coalescing(context->event_emitter, EVENTEMITTER_COALESCE_KEEP_LAST, NULL, NULL));
+}
+
+
+static void _bench_suite_run_coalesce(struct BenchSuiteContext *context, size_t operations)
+{
+  // producers queue many events per consumer tick, the cursor step is coprime to the tick
+  // so the tick is reached once per tick operations regardless of the sample size
+  for (size_t index = 0; index < operations; index++)
+  {
+    eventemitter_coalesce(context->event_emitter, _bench_suite_event_id(context->cursor % context->events), 0, NULL);
+    context->cursor = context->cursor + 31;
+    if (!(context->cursor % BENCH_SUITE_COALESCE_TICK))
+    {
+      eventemitter_dispatch_coalesced(context->event_emitter);
+    }
+  }
+}
+
+
+static void _bench_suite_run_copy_emit(struct BenchSuiteContext *context, size_t operations)
+{
+  char source[BENCH_SUITE_PAYLOAD_SIZE] = { 0 };
+
+  // the per event deep copy which owned payloads replace
+  for (size_t index = 0; index < operations; index++)
+  {
+    void *payload = malloc(BENCH_SUITE_PAYLOAD_SIZE);
+    context->allocations++;
+    memcpy(payload, source, BENCH_SUITE_PAYLOAD_SIZE);
+    eventemitter_emit(context->event_emitter, _bench_suite_event_id(context->cursor % context->events), payload);
+    free(payload);
+    context->cursor++;
+  }
+}
+
+
+static void _bench_suite_run_owned_emit(struct BenchSuiteContext *context, size_t operations)
+{
+  char source[BENCH_SUITE_PAYLOAD_SIZE] = { 0 };
+
+  for (size_t index = 0; index < operations; index++)
+  {
+    void *payload = eventemitter_payload_new(context->event_emitter, BENCH_SUITE_PAYLOAD_SIZE, NULL);
+    memcpy(payload, source, BENCH_SUITE_PAYLOAD_SIZE);
+    eventemitter_emit_owned(context->event_emitter, _bench_suite_event_id(context->cursor % context->events), payload);
+    context->cursor++;
+  }
+}
+
+
+static bool _bench_suite_setup_typed(struct BenchSuiteContext *context)
+{
+  bench_suite_typed_init(&_bench_suite_typed_emitter);
+  for (size_t event = 0; event < context->events; event++)
+  {
+    for (size_t listener = 0; listener < context->listeners; listener++)
+    {
+      if (!bench_suite_typed_on(&_bench_suite_typed_emitter, event, _bench_suite_listener, NULL))
+      {
+        return(false);
+      }
+    }
+  }
+
+  return(true);
+}
+
+
+static void _bench_suite_run_typed(struct BenchSuiteContext *context, size_t operations)
+{
+  for (size_t index = 0; index < operations; index++)
+  {
+    bench_suite_typed_emit(&_bench_suite_typed_emitter, context->cursor % context->events, NULL);
+    context->cursor = context->cursor + 31;
+  }
+}
+
+
+static bool _bench_suite_setup_unhandled_hit(struct BenchSuiteContext *context)
+{
+  return(_bench_suite_setup_emit(context) && eventemitter_else(context->event_emitter, _bench_suite_unhandled_listener, NULL));
+}
+
+
+static void _bench_suite_run_unhandled(struct BenchSuiteContext *context, size_t operations)
+{
+  for (size_t index = 0; index < operations; index++)
+  {
+    // odd IDs are never registered
+    eventemitter_emit(context->event_emitter, _bench_suite_event_id(context->cursor % context->events) + 1, NULL);
+    context->cursor = context->cursor + 31;
+  }
+}
+
+
+static void _bench_suite_run_once_churn(struct BenchSuiteContext *context, size_t operations)
+{
+  for (size_t index = 0; index < operations; index++)
+  {
+    int event_id = _bench_suite_event_id(context->cursor % context->events);
+    eventemitter_once(context->event_emitter, event_id, _bench_suite_listener, NULL);
+    eventemitter_emit(context->event_emitter, event_id, NULL);
+    context->cursor++;
+  }
+}
+
+
+static bool _bench_suite_setup_empty(struct BenchSuiteContext *context)
+{
+  (void)context;
+
+  return(true);
+}
+
+
+static bool _bench_suite_setup_retention(struct BenchSuiteContext *context)
+{
+  return(eventemitter_set_retention(context->event_emitter, context->events));
+}
+
+
+static void _bench_suite_run_add_remove_churn(struct BenchSuiteContext *context, size_t operations)
+{
+  for (size_t index = 0; index < operations; index++)
+  {
+    unsigned int callback_id = eventemitter_on(context->event_emitter, _bench_suite_event_id(context->cursor % context->events), _bench_suite_listener, NULL);
+    eventemitter_remove_listener_by_id(context->event_emitter, callback_id);
+    context->cursor++;
+  }
+}
+
+
+static bool _bench_suite_setup_prepend(struct BenchSuiteContext *context)
+{
+  context->callback_ids = malloc(context->listeners * sizeof(unsigned int));
+  if (context->callback_ids == NULL)
+  {
+    return(false);
+  }
+
+  for (size_t index = 0; index < context->listeners; index++)
+  {
+    context->callback_ids[index] = eventemitter_prepend_listener(context->event_emitter, 1, _bench_suite_listener, NULL);
+    if (!context->callback_ids[index])
+    {
+      return(false);
+    }
+  }
+
+  return(true);
+}
+
+
+static void _bench_suite_run_prepend(struct BenchSuiteContext *context, size_t operations)
+{
+  for (size_t index = 0; index < operations; index++)
+  {
+    // the oldest listener is at the back, replace it with a new one at the front
+    size_t slot = context->cursor % context->listeners;
+    eventemitter_remove_listener_by_id(context->event_emitter, context->callback_ids[slot]);
+    context->callback_ids[slot] = eventemitter_prepend_listener(context->event_emitter, 1, _bench_suite_listener, NULL);
+    eventemitter_emit(context->event_emitter, 1, NULL);
+    context->cursor++;
+  }
+}
+
+
+static bool _bench_suite_setup_priority(struct BenchSuiteContext *context)
+{
+  context->callback_ids = malloc(context->listeners * sizeof(unsigned int));
+  if (context->callback_ids == NULL)
+  {
+    return(false);
+  }
+
+  for (size_t index = 0; index < context->listeners; index++)
+  {
+    context->callback_ids[index] = eventemitter_add_listener_with_priority(context->event_emitter, 1, (int)(index % BENCH_SUITE_PRIORITIES), _bench_suite_listener, NULL);
+    if (!context->callback_ids[index])
+    {
+      return(false);
+    }
+  }
+
+  return(true);
+}
+
+
+static void _bench_suite_run_priority(struct BenchSuiteContext *context, size_t operations)
+{
+  for (size_t index = 0; index < operations; index++)
+  {
+    // replace the oldest listener with a new one in the middle of the priority order
+    size_t slot = context->cursor % context->listeners;
+    eventemitter_remove_listener_by_id(context->event_emitter, context->callback_ids[slot]);
+    context->callback_ids[slot] = eventemitter_add_listener_with_priority(context->event_emitter, 1, (int)(context->cursor % BENCH_SUITE_PRIORITIES), _bench_suite_listener, NULL);
+    eventemitter_emit(context->event_emitter, 1, NULL);
+    context->cursor++;
+  }
+}
+
+
+static bool _bench_suite_setup_large(struct BenchSuiteContext *context)
+{
+  for (size_t event = 0; event < context->events; event++)
+  {
+    if (!eventemitter_on(context->event_emitter, _bench_suite_large_event_id(event), _bench_suite_listener, NULL))
+    {
+      return(false);
+    }
+  }
+
+  return(true);
+}
+
+
+static void _bench_suite_run_large_hit(struct BenchSuiteContext *context, size_t operations)
+{
+  for (size_t index = 0; index < operations; index++)
+  {
+    eventemitter_emit(context->event_emitter, _bench_suite_large_event_id(context->cursor % context->events), NULL);
+    context->cursor = context->cursor + 7919;
+  }
+}
+
+
+static void _bench_suite_run_large_miss(struct BenchSuiteContext *context, size_t operations)
+{
+  for (size_t index = 0; index < operations; index++)
+  {
+    // indexes past the registered ones map to unknown IDs
+    eventemitter_emit(context->event_emitter, _bench_suite_large_event_id(context->events + context->cursor % context->events), NULL);
+    context->cursor = context->cursor + 7919;
+  }
+}
+
+
+static bool _bench_suite_setup_ranges(struct BenchSuiteContext *context)
+{
+  // consecutive ranges of 16 event IDs, each with its own listeners
+  for (size_t range = 0; range < context->events; range++)
+  {
+    for (size_t listener = 0; listener < context->listeners; listener++)
+    {
+      if (!eventemitter_on_range(context->event_emitter, (int)(range * 16), (int)(range * 16 + 15), _bench_suite_unhandled_listener, NULL))
+      {
+        return(false);
+      }
+    }
+  }
+
+  return(true);
+}
+
+
+static void _bench_suite_run_ranges(struct BenchSuiteContext *context, size_t operations)
+{
+  for (size_t index = 0; index < operations; index++)
+  {
+    eventemitter_emit(context->event_emitter, (int)(context->cursor % (context->events * 16)), NULL);
+    context->cursor = context->cursor + 7919;
+  }
+}
+
+
+static const struct BenchSuiteScenario _bench_suite_scenarios[] =
+{
+  { "emit",                1,                        1,                           _bench_suite_setup_emit,          _bench_suite_run_emit             },
+  { "emit",                1,                        8,                           _bench_suite_setup_emit,          _bench_suite_run_emit             },
+  { "emit",                64,                       1,                           _bench_suite_setup_emit,          _bench_suite_run_emit             },
+  { "emit",                64,                       8,                           _bench_suite_setup_emit,          _bench_suite_run_emit             },
+  { "emit",                4096,                     1,                           _bench_suite_setup_emit,          _bench_suite_run_emit             },
+  { "emit",                4096,                     8,                           _bench_suite_setup_emit,          _bench_suite_run_emit             },
+  { "frozen_emit",         1,                        8,                           _bench_suite_setup_frozen,        _bench_suite_run_emit             },
+  { "frozen_emit",         64,                       8,                           _bench_suite_setup_frozen,        _bench_suite_run_emit             },
+  { "frozen_emit",         4096,                     1,                           _bench_suite_setup_frozen,        _bench_suite_run_emit             },
+  { "frozen_emit",         4096,                     8,                           _bench_suite_setup_frozen,        _bench_suite_run_emit             },
+  { "typed_emit",          1,                        8,                           _bench_suite_setup_typed,         _bench_suite_run_typed            },
+  { "typed_emit",          BENCH_SUITE_TYPED_EVENTS, BENCH_SUITE_TYPED_LISTENERS, _bench_suite_setup_typed,         _bench_suite_run_typed            },
+  { "coalesce",            64,                       8,                           _bench_suite_setup_coalesce,      _bench_suite_run_coalesce         },
+  { "copy_emit",           64,                       8,                           _bench_suite_setup_emit,          _bench_suite_run_copy_emit        },
+  { "owned_emit",          64,                       8,                           _bench_suite_setup_emit,          _bench_suite_run_owned_emit       },
+  { "unhandled_hit",       64,                       1,                           _bench_suite_setup_unhandled_hit, _bench_suite_run_unhandled        },
+  { "unhandled_miss",      64,                       1,                           _bench_suite_setup_emit,          _bench_suite_run_unhandled        },
+  { "once_churn",          64,                       1,                           _bench_suite_setup_emit,          _bench_suite_run_once_churn       },
+  { "once_roundtrip",      64,                       0,                           _bench_suite_setup_empty,         _bench_suite_run_once_churn       },
+  { "once_retained",       64,                       0,                           _bench_suite_setup_retention,     _bench_suite_run_once_churn       },
+  { "add_remove_churn",    64,                       BENCH_SUITE_CHURN_LISTENERS, _bench_suite_setup_emit,          _bench_suite_run_add_remove_churn },
+  { "prepend_heavy",       1,                        BENCH_SUITE_CHURN_LISTENERS, _bench_suite_setup_prepend,       _bench_suite_run_prepend          },
+  { "priority_churn",      1,                        BENCH_SUITE_CHURN_LISTENERS, _bench_suite_setup_priority,      _bench_suite_run_priority         },
+  { "large_id_space_hit",  BENCH_SUITE_LARGE_EVENTS, 1,                           _bench_suite_setup_large,         _bench_suite_run_large_hit        },
+  { "large_id_space_miss", BENCH_SUITE_LARGE_EVENTS, 1,                           _bench_suite_setup_large,         _bench_suite_run_large_miss       },
+  { "range",               64,                       1,                           _bench_suite_setup_ranges,        _bench_suite_run_ranges           },
+  { "range",               4096,                     1,                           _bench_suite_setup_ranges,        _bench_suite_run_ranges           },
+};
+
+
+static bool _bench_suite_run_scenario(const struct BenchSuiteScenario *scenario, enum BenchSuiteFormat format, bool first)
+{
+  struct BenchSuiteContext     context   = { NULL, 0, scenario->events, scenario->listeners, 0, NULL };
+  struct EventEmitterAllocator allocator = { _bench_suite_allocate, _bench_suite_reallocate, _bench_suite_deallocate, &context };
+  static double                samples[BENCH_SUITE_SAMPLES];
+
+  context.event_emitter = eventemitter_new_with_allocator(&allocator);
+  bool done = context.event_emitter != NULL && scenario->setup(&context);
+  if (done)
+  {
+    // warm up so pools and tables reach their steady state size before measuring
+    scenario->run(&context, BENCH_SUITE_WARMUP_OPERATIONS);
+
+    // samples of a few operations each, so the percentiles show the per operation tail instead of averaging it out
+    double overhead = _bench_suite_timer_overhead();
+    context.allocations = 0;
+    double total_ns = 0;
+    for (size_t sample = 0; sample < BENCH_SUITE_SAMPLES; sample++)
+    {
+      double start = _bench_suite_now();
+      scenario->run(&context, BENCH_SUITE_SAMPLE_OPERATIONS);
+      double elapsed  = _bench_suite_now() - start - overhead;
+      samples[sample] = (elapsed > 0 ? elapsed : 0) / BENCH_SUITE_SAMPLE_OPERATIONS;
+      total_ns        = total_ns + samples[sample];
+    }
+    qsort(samples, BENCH_SUITE_SAMPLES, sizeof(double), _bench_suite_compare);
+
+    size_t operations     = (size_t)BENCH_SUITE_SAMPLES * BENCH_SUITE_SAMPLE_OPERATIONS;
+    double ns_per_op      = total_ns / BENCH_SUITE_SAMPLES;
+    double p50            = samples[BENCH_SUITE_SAMPLES * 50 / 100];
+    double p90            = samples[BENCH_SUITE_SAMPLES * 90 / 100];
+    double p99            = samples[BENCH_SUITE_SAMPLES * 99 / 100];
+    double allocations_op = (double)context.allocations / (double)operations;
+
+    if (format == BENCH_SUITE_FORMAT_JSON)
+    {
+      printf("%s\n    {\"scenario\": \"%s\", \"events\": %zu, \"listeners\": %zu, \"operations\": %zu, "
+             "\"ns_per_op\": %.2f, \"p50_ns\": %.2f, \"p90_ns\": %.2f, \"p99_ns\": %.2f, \"allocations_per_op\": %.4f}",
+             first ? "" : ",", scenario->name, scenario->events, scenario->listeners, operations,
+             ns_per_op, p50, p90, p99, allocations_op);
+    }
+    else
+    {
+      printf("%s,%zu,%zu,%zu,%.2f,%.2f,%.2f,%.2f,%.4f\n",
+             scenario->name, scenario->events, scenario->listeners, operations,
+             ns_per_op, p50, p90, p99, allocations_op);
+    }
+  }
+
+  eventemitter_release(context.event_emitter);
+  free(context.callback_ids);
+
+  return(done);
+} /* _bench_suite_run_scenario */
+
+
+bool bench_suite_run(enum BenchSuiteFormat format)
+{
+  size_t scenario_count = sizeof(_bench_suite_scenarios) / sizeof(struct BenchSuiteScenario);
+  bool   done           = true;
+
+  if (format == BENCH_SUITE_FORMAT_JSON)
+  {
+    printf("{\n  \"benchmarks\": [");
+  }
+  else
+  {
+    printf("scenario,events,listeners,operations,ns_per_op,p50_ns,p90_ns,p99_ns,allocations_per_op\n");
+  }
+
+  size_t printed = 0;
+  for (size_t index = 0; index < scenario_count; index++)
+  {
+    if (_bench_suite_run_scenario(&_bench_suite_scenarios[index], format, printed == 0))
+    {
+      printed++;
+    }
+    else
+    {
+      fprintf(stderr, "scenario %s failed\n", _bench_suite_scenarios[index].name);
+      done = false;
+    }
+  }
+
+  if (format == BENCH_SUITE_FORMAT_JSON)
+  {
+    printf("\n  ]\n}\n");
+  }
+
+  return(done && _bench_suite_sink > 0);
+}
+
@@ -0,0 +1,24 @@
+#ifndef BENCH_SUITE_H
+#define BENCH_SUITE_H
+
+#include <stdbool.h>
+
+enum BenchSuiteFormat
+{
+  BENCH_SUITE_FORMAT_CSV,
+  BENCH_SUITE_FORMAT_JSON,
+};
+
+/**
+ * Runs all scenarios of the benchmark suite and prints the results to stdout
+ * in a machine readable format.
+ * Each result holds the mean ns/op, the p50/p90/p99 ns/op over samples of a few
+ * operations each (without the timer overhead) and the amount of allocations done per operation.
+ *
+ * @param format - The output format
+ * @returns True if all scenarios ran successfully
+ */
+bool bench_suite_run(enum BenchSuiteFormat);
+
+#endif
+
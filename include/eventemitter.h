@@ -2,8 +2,86 @@
 #define EVENTEMITTER_H
 
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// the max amount of event IDs in the range of an emitter created with eventemitter_new_with_id_range
+#define EVENTEMITTER_MAX_ID_RANGE    (1 << 20)
 
 struct EventEmitter;
+struct EventEmitterAsyncEmit;
+
+/**
+ * Memory allocation hooks used by the emitter for all its internal allocations.
+ * All hooks are called with the allocator context.
+ */
+struct EventEmitterAllocator
+{
+  void *(*allocate)(size_t /* size */, void * /* context */);
+  void *(*reallocate)(void * /* pointer */, size_t /* size */, void * /* context */);
+  void (*deallocate)(void * /* pointer */, void * /* context */);
+  void *context;
+};
+
+/**
+ * Runtime counters (available when built with EVENTEMITTER_STATS).
+ */
+struct EventEmitterStats
+{
+  // amount of emit calls, including batched, queued and async emits
+  uint64_t emits;
+  // amount of invoked listeners (including range and mask listeners), excluding unhandled listeners
+  uint64_t invocations;
+  // amount of emits which had no listeners and were given to the unhandled listeners
+  uint64_t unhandled;
+  // amount of 'once' listeners removed since triggered
+  uint64_t once_removals;
+  // the max amount of listeners registered at the same time
+  size_t   peak_listeners;
+};
+
+/**
+ * Describes a single event listener for the bulk add listeners function.
+ */
+struct EventEmitterListenerSpec
+{
+  int  event_id;
+  void (*callback)(void *event_data, void *context);
+  void *context;
+  // removed once triggered, same as the add once listener functions
+  bool once;
+  // added at the start of the listeners list, same as the prepend listener functions
+  bool prepend;
+};
+
+/**
+ * Tracing hooks invoked around every dispatch (available when built with EVENTEMITTER_TRACE).
+ * The timestamps are in nanoseconds from a monotonic clock. Any of the hooks may be NULL.
+ */
+struct EventEmitterTraceHooks
+{
+  // invoked before the listeners of the event are invoked
+  void (*pre_emit)(int event_id, uint64_t timestamp, void *context);
+  // invoked after all listeners of the event were invoked, with the amount of invoked listeners
+  void (*post_emit)(int event_id, int callback_counter, uint64_t timestamp, void *context);
+  // invoked before/after each listener, including unhandled listeners
+  void (*pre_listener)(int event_id, unsigned int callback_id, uint64_t timestamp, void *context);
+  void (*post_listener)(int event_id, unsigned int callback_id, uint64_t timestamp, void *context);
+  void *context;
+};
+
+/**
+ * Defines which event data is dispatched for coalesced events of the same event ID and key.
+ */
+enum EventEmitterCoalescePolicy
+{
+  // the event data of the latest event replaces the queued event data
+  EVENTEMITTER_COALESCE_KEEP_LAST,
+  // the queued event data (of the first event) is kept
+  EVENTEMITTER_COALESCE_KEEP_FIRST,
+  // the merge callback combines the queued event data with the event data of the latest event
+  EVENTEMITTER_COALESCE_MERGE,
+};
 
 /**
  * Creates and returns a new event emitter.
@@ -11,6 +89,31 @@ struct EventEmitter;
  */
 struct EventEmitter *eventemitter_new(void);
 
+/**
+ * Creates and returns a new event emitter optimized for the given contiguous range of event IDs.
+ * Listeners of event IDs in the range are kept in a flat array indexed by the event ID,
+ * so emitting them does not require any lookup.
+ * Event IDs outside the range are still supported but are handled via the generic lookup.
+ * The array holds a pointer per event ID, so the range is limited to EVENTEMITTER_MAX_ID_RANGE event IDs.
+ * Once no longer needed, it must be released.
+ *
+ * @param min event ID - The first event ID of the range (inclusive)
+ * @param max event ID - The last event ID of the range (inclusive)
+ * @returns the new emitter or NULL in case of invalid range (including ranges larger than EVENTEMITTER_MAX_ID_RANGE)
+ */
+struct EventEmitter *eventemitter_new_with_id_range(int /* min event ID */, int /* max event ID */);
+
+/**
+ * Creates and returns a new event emitter which uses the provided allocator
+ * for all its internal memory (including the emitter itself).
+ * The allocator struct is copied, but its context must remain valid until the emitter is released.
+ * Once no longer needed, it must be released.
+ *
+ * @param allocator - The allocation hooks (all hooks must be provided)
+ * @returns the new emitter or NULL in case of invalid input
+ */
+struct EventEmitter *eventemitter_new_with_allocator(const struct EventEmitterAllocator *);
+
 /**
  * Frees the memory of the provided emitter.
  */
@@ -86,6 +189,21 @@ unsigned int eventemitter_once(struct EventEmitter *, int /* event ID */, void (
  */
 unsigned int eventemitter_prepend_once_listener(struct EventEmitter *, int /* event ID */, void (*callback)(void * /* event data */, void * /* context */), void * /* context */);
 
+/**
+ * Same as the add listener, but the listener is invoked according to the given priority.
+ * Listeners with a higher priority are invoked first, listeners with the same priority are invoked
+ * in registration order and listeners added by the other add functions have priority 0.
+ * Prepended listeners are placed before the other listeners of the same priority.
+ *
+ * @param event emitter - The emitter struct
+ * @param event ID - The event ID that listeners have registered on
+ * @param priority - The listener priority, higher priorities are invoked first
+ * @param callback - Will be called when the event ID is triggered via emit
+ * @param context - Will be passed to this specific callback when an event is triggered
+ * @returns 0 in case of error or the callback ID which can be used to remove the listener
+ */
+unsigned int eventemitter_add_listener_with_priority(struct EventEmitter *, int /* event ID */, int /* priority */, void (*callback)(void * /* event data */, void * /* context */), void * /* context */);
+
 /**
  * Adds a new event listener which will be invoked for any event ID without registered listeners.
  * The provided optional context will be provided to the callback when the event is triggered.
@@ -119,6 +237,39 @@ unsigned int eventemitter_else(struct EventEmitter *, void (*callback)(int /* ev
  */
 unsigned int eventemitter_prepend_unhandled_listener(struct EventEmitter *, void (*callback)(int /* event ID */, void * /* event data */, void * /* context */), void * /* context */);
 
+/**
+ * Adds a new event listener which will be invoked for every event ID in the given inclusive range.
+ * Range listeners are invoked after the listeners of the exact event ID, ordered by range
+ * (min and then max event ID) and by registration order within the same range.
+ * Events which only have range or mask listeners are not passed to the unhandled listeners.
+ * Range and mask listeners are removed via the remove listener by ID function and are not
+ * included in the event listeners count.
+ * In case of invalid input, 0 will be returned.
+ *
+ * @param event emitter - The emitter struct
+ * @param min event ID - The first event ID of the range
+ * @param max event ID - The last event ID of the range (not lower than the min event ID)
+ * @param callback - Will be called with the triggered event ID
+ * @param context - Will be passed to this specific callback when an event is triggered
+ * @returns 0 in case of error or the callback ID which can be used to remove the listener
+ */
+unsigned int eventemitter_on_range(struct EventEmitter *, int /* min event ID */, int /* max event ID */, void (*callback)(int /* event ID */, void * /* event data */, void * /* context */), void * /* context */);
+
+/**
+ * Adds a new event listener which will be invoked for every event ID for which (event ID & mask) == value.
+ * Mask listeners are invoked after the range listeners, grouped by mask in the order the masks
+ * were first used and by registration order within the same mask and value.
+ * In case of invalid input (including a value with bits outside of the mask), 0 will be returned.
+ *
+ * @param event emitter - The emitter struct
+ * @param mask - The event ID bits to compare
+ * @param value - The expected value of the masked event ID bits
+ * @param callback - Will be called with the triggered event ID
+ * @param context - Will be passed to this specific callback when an event is triggered
+ * @returns 0 in case of error or the callback ID which can be used to remove the listener
+ */
+unsigned int eventemitter_on_mask(struct EventEmitter *, int /* mask */, int /* value */, void (*callback)(int /* event ID */, void * /* event data */, void * /* context */), void * /* context */);
+
 /**
  * Removes the listener for the given event ID and callback ID if exists.
  *
@@ -148,6 +299,92 @@ int eventemitter_off(struct EventEmitter *, int /* event ID */, unsigned int /*
  */
 int eventemitter_remove_unhandled_listener(struct EventEmitter *, unsigned int /* callback ID */);
 
+/**
+ * Removes the listener (event or unhandled events listener) for the given callback ID if exists.
+ * Unlike remove listener, the event ID is not needed.
+ *
+ * @param event emitter - The emitter struct
+ * @param callback ID - The callback ID returned from any of the add listener functions
+ * @returns -1 for invalid input, 0 for callback not found, 1 for removed
+ */
+int eventemitter_remove_listener_by_id(struct EventEmitter *, unsigned int /* callback ID */);
+
+/**
+ * Adds the listener the same as eventemitter_on but returns a 64 bit listener handle instead of a callback ID.
+ * Handles encode the listener slot and its generation, so unlike callback IDs (which wrap around
+ * after 2^32 listeners) a handle of a removed listener never matches a newer listener.
+ *
+ * @param event emitter - The emitter struct
+ * @param event ID - The event ID to listen to
+ * @param callback - The callback function to invoke
+ * @param context - Any context data which will be provided to the callback
+ * @returns the listener handle or 0 in case of any error
+ */
+uint64_t eventemitter_on_with_handle(struct EventEmitter *, int /* event ID */, void (*callback)(void * /* event data */, void * /* context */), void * /* context */);
+
+/**
+ * Adds the listener the same as eventemitter_once but returns a 64 bit listener handle instead of a callback ID.
+ *
+ * @param event emitter - The emitter struct
+ * @param event ID - The event ID to listen to
+ * @param callback - The callback function to invoke
+ * @param context - Any context data which will be provided to the callback
+ * @returns the listener handle or 0 in case of any error
+ */
+uint64_t eventemitter_once_with_handle(struct EventEmitter *, int /* event ID */, void (*callback)(void * /* event data */, void * /* context */), void * /* context */);
+
+/**
+ * Removes the listener (of any kind) for the given handle if it is still registered.
+ * Handles of removed listeners are rejected without any lookup.
+ *
+ * @param event emitter - The emitter struct
+ * @param handle - The listener handle
+ * @returns -1 for invalid input, 0 for listener not found, 1 for removed
+ */
+int eventemitter_remove_listener_by_handle(struct EventEmitter *, uint64_t /* handle */);
+
+/**
+ * Returns the handle of the listener registered with the given callback ID.
+ *
+ * @param event emitter - The emitter struct
+ * @param callback ID - The callback ID returned from any of the add listener functions
+ * @returns the listener handle or 0 if not found or in case of invalid input
+ */
+uint64_t eventemitter_get_listener_handle(struct EventEmitter *, unsigned int /* callback ID */);
+
+/**
+ * Returns the callback ID of the listener with the given handle.
+ *
+ * @param event emitter - The emitter struct
+ * @param handle - The listener handle
+ * @returns the callback ID or 0 if the listener is no longer registered or in case of invalid input
+ */
+unsigned int eventemitter_get_listener_id(struct EventEmitter *, uint64_t /* handle */);
+
+/**
+ * Adds all the given event listeners, same as calling the matching add/prepend/once function
+ * for each spec in order, while the listeners storage of each event is grown only once.
+ * Either all listeners are added or none, in which case the events are left as they were.
+ *
+ * @param event emitter - The emitter struct
+ * @param specs - The listeners to add (all callbacks must be provided)
+ * @param count - The amount of specs
+ * @param callback IDs - Optional output array of count size for the new callback IDs (may be NULL)
+ * @returns true if all listeners were added, false in case of invalid input or allocation failure
+ */
+bool eventemitter_add_listeners(struct EventEmitter *, const struct EventEmitterListenerSpec *, size_t /* count */, unsigned int * /* callback IDs */);
+
+/**
+ * Removes all the listeners (event or unhandled events listeners) for the given callback IDs.
+ * Unknown callback IDs are ignored.
+ *
+ * @param event emitter - The emitter struct
+ * @param callback IDs - The callback IDs returned from any of the add listener functions
+ * @param count - The amount of callback IDs
+ * @returns the amount of removed listeners or -1 for invalid input
+ */
+int eventemitter_remove_listeners(struct EventEmitter *, const unsigned int * /* callback IDs */, size_t /* count */);
+
 /**
  * Removes all listeners for the given event ID.
  *
@@ -173,6 +410,28 @@ bool eventemitter_remove_all_unhandled_listeners(struct EventEmitter *);
  */
 bool eventemitter_remove_all_listeners(struct EventEmitter *);
 
+/**
+ * Sets how many events without listeners keep their internal listeners memory for reuse (0 by default).
+ * Workloads which repeatedly add and remove (or trigger 'once') listeners of the same events can
+ * then add listeners again without allocating. Above the limit, the memory of events left without
+ * listeners is released immediately.
+ * Lowering the limit below the amount of currently kept events releases all of them.
+ *
+ * @param event emitter - The emitter struct
+ * @param max retained events - The max amount of events without listeners to keep
+ * @returns true if set, false in case of invalid input
+ */
+bool eventemitter_set_retention(struct EventEmitter *, size_t /* max retained events */);
+
+/**
+ * Releases the memory kept for events without listeners by the retention policy.
+ * The internal listeners memory blocks left unused are then returned to the allocator.
+ *
+ * @param event emitter - The emitter struct
+ * @returns the amount of released events or -1 in case of invalid input
+ */
+int eventemitter_compact(struct EventEmitter *);
+
 /**
  * Returns the listeners count for the given event ID.
  * In case of invalid input, -1 will be returned.
@@ -186,6 +445,10 @@ int eventemitter_listeners_count(struct EventEmitter *, int /* event ID */);
 /**
  * Triggers an event for the given event ID.
  * The event data would be given to all relevant event listeners.
+ * Callbacks may add and remove listeners (including of the emitted event) and emit recursively.
+ * Listeners removed during emit are not invoked, while listeners added during emit of the same
+ * event are only invoked by emits that start after the outermost emit of that event is done.
+ * Releasing the emitter from within a callback is not supported.
  *
  * @param event emitter - The emitter struct
  * @param event data - The event data passed to all relevant listeners
@@ -193,5 +456,287 @@ int eventemitter_listeners_count(struct EventEmitter *, int /* event ID */);
  */
 int eventemitter_emit(struct EventEmitter *, int /* event ID */, void * /* event data */);
 
+/**
+ * Triggers the given events in order, same as calling emit for each of them.
+ * The listeners of each event ID are looked up once per batch and the removed records
+ * (including invoked 'once' listeners) are cleaned up once the batch is done.
+ * Listeners added by callbacks to events already triggered by the batch may not be invoked
+ * until the batch is done, same for unhandled listeners added by callbacks.
+ * Listeners added after all listeners of an event were removed are invoked by the rest of the batch.
+ *
+ * @param event emitter - The emitter struct
+ * @param event IDs - The event IDs to trigger
+ * @param event data - The event data of each event (may be NULL for no data)
+ * @param count - The amount of events
+ * @returns the total amount of callbacks invoked (including unhandled) or returns -1 in case of invalid input
+ */
+int eventemitter_emit_batch(struct EventEmitter *, const int * /* event IDs */, void ** /* event data */, size_t /* count */);
+
+/**
+ * Compiles the current listeners into a read only dispatch table, a minimal perfect hash over
+ * the event IDs with the listeners of all events stored in a single contiguous array.
+ * Once frozen, all add and remove functions fail as invalid input and emit only reads the table,
+ * so it does not take any lock and can be called from any amount of threads concurrently
+ * (as long as the emitter is not released).
+ * Frozen emits are traced but not counted by the stats.
+ * Emitters with 'once', range or mask listeners can not be frozen, same as during emit.
+ *
+ * @param event emitter - The emitter struct
+ * @returns true if frozen (or already frozen), false in case of invalid input, unsupported listeners or allocation failure
+ */
+bool eventemitter_freeze(struct EventEmitter *);
+
+/**
+ * Returns true if the emitter was frozen.
+ *
+ * @param event emitter - The emitter struct
+ * @returns true if frozen, false if not frozen or in case of invalid input
+ */
+bool eventemitter_is_frozen(struct EventEmitter *);
+
+/**
+ * Creates the events queue used by enqueue/dispatch (available when built with EVENTEMITTER_THREADS).
+ * Must be called once, before any thread enqueues events.
+ *
+ * @param event emitter - The emitter struct
+ * @param capacity - The max amount of queued events (rounded up to a power of 2)
+ * @returns true if created, false in case of invalid input, allocation failure or if the queue already exists
+ */
+bool eventemitter_init_queue(struct EventEmitter *, size_t /* capacity */);
+
+/**
+ * Queues an event for the given event ID, to be emitted by a later dispatch call.
+ * Can be called from any amount of threads concurrently and does not take any lock.
+ *
+ * @param event emitter - The emitter struct
+ * @param event ID - The event ID
+ * @param event data - The event data passed to all relevant listeners once dispatched
+ * @returns true if queued, false in case of invalid input, missing queue or if the queue is full
+ */
+bool eventemitter_enqueue(struct EventEmitter *, int /* event ID */, void * /* event data */);
+
+/**
+ * Emits the queued events in their queue order.
+ * Must only be called from the thread that owns the emitter (the one adding listeners and emitting).
+ *
+ * @param event emitter - The emitter struct
+ * @param max events - The max amount of events to dispatch or 0 to dispatch all events queued before the call
+ * @returns the amount of dispatched events or -1 in case of invalid input
+ */
+int eventemitter_dispatch(struct EventEmitter *, size_t /* max events */);
+
+/**
+ * Returns an eventfd which becomes readable when queued events are pending, to be added to an event loop (epoll, poll...).
+ * Available on Linux, the eventfd is created by the first call which must be done before other threads enqueue events.
+ * The eventfd is owned by the emitter and closed when it is released.
+ * Once readable, the events should be dispatched via eventemitter_dispatch_pending which also resets the eventfd.
+ * Wakeups are coalesced, only the first event queued after the pending events were dispatched writes to the eventfd.
+ *
+ * @param event emitter - The emitter struct
+ * @returns the eventfd or -1 in case of invalid input, missing queue or failure to create it
+ */
+int eventemitter_get_fd(struct EventEmitter *);
+
+/**
+ * Resets the eventfd returned by eventemitter_get_fd and emits all the events queued before the call, without blocking.
+ * Must only be called from the thread that owns the emitter (the one adding listeners and emitting).
+ *
+ * @param event emitter - The emitter struct
+ * @returns the amount of dispatched events or -1 in case of invalid input
+ */
+int eventemitter_dispatch_pending(struct EventEmitter *);
+
+/**
+ * Enables coalescing of events queued via eventemitter_coalesce.
+ * Events queued for the same event ID and key are merged into a single pending event, so the listeners
+ * are invoked once per dispatch regardless of how many times the event was queued.
+ *
+ * @param event emitter - The emitter struct
+ * @param policy - The event data to dispatch for merged events
+ * @param merge - Returns the new queued event data from the queued and latest event data (required by the merge policy)
+ * @param context - Any context data which will be provided to the merge callback
+ * @returns true if enabled, false in case of invalid input, allocation failure or if already enabled
+ */
+bool eventemitter_init_coalescing(struct EventEmitter *, enum EventEmitterCoalescePolicy, void *(*merge)(int /* event ID */, void * /* queued data */, void * /* event data */, void * /* context */), void * /* context */);
+
+/**
+ * Queues an event for the next coalesced dispatch, merged with a pending event of the same event ID and key if there is one.
+ * Must only be called from the thread that owns the emitter (the one adding listeners and emitting).
+ *
+ * @param event emitter - The emitter struct
+ * @param event ID - The event ID
+ * @param key - Separates events of the same event ID which should not be merged (for example an object ID), or 0
+ * @param event data - The event data passed to all relevant listeners once dispatched (subject to the coalesce policy)
+ * @returns true if queued or merged, false in case of invalid input, coalescing not enabled or allocation failure
+ */
+bool eventemitter_coalesce(struct EventEmitter *, int /* event ID */, unsigned int /* key */, void * /* event data */);
+
+/**
+ * Emits the pending coalesced events in the order they were first queued.
+ * Events coalesced by the listeners during the dispatch are pending for the next dispatch.
+ *
+ * @param event emitter - The emitter struct
+ * @returns the amount of dispatched events or -1 in case of invalid input
+ */
+int eventemitter_dispatch_coalesced(struct EventEmitter *);
+
+/**
+ * Starts the worker threads used by emit async (available when built with EVENTEMITTER_THREADS).
+ * The threads are owned by the emitter and stopped when it is released.
+ *
+ * @param event emitter - The emitter struct
+ * @param worker count - The amount of worker threads
+ * @returns true if started, false in case of invalid input, failure or if the workers were already started
+ */
+bool eventemitter_start_workers(struct EventEmitter *, size_t /* worker count */);
+
+/**
+ * Triggers an event for the given event ID, where the listeners are invoked in parallel by the emitter workers.
+ * Same as emit, matching range and mask listeners handle the event as well.
+ * The listeners are resolved (and 'once' listeners are removed) before this function returns, so later
+ * listener changes do not affect the event.
+ * Listeners are invoked on the worker threads, so they must not access the emitter and the allocator
+ * must be thread safe.
+ * The returned handle must be waited for, before the emitter is released.
+ *
+ * @param event emitter - The emitter struct
+ * @param event ID - The event ID
+ * @param event data - The event data passed to all relevant listeners
+ * @returns the handle to wait for or NULL in case of invalid input, allocation failure or if the workers were not started
+ */
+struct EventEmitterAsyncEmit *eventemitter_emit_async(struct EventEmitter *, int /* event ID */, void * /* event data */);
+
+/**
+ * Same as emit async, but instead of returning a handle, the provided callback is invoked once all listeners are done.
+ * The callback is invoked on a worker thread (or directly in case there are no listeners).
+ *
+ * @param event emitter - The emitter struct
+ * @param event ID - The event ID
+ * @param event data - The event data passed to all relevant listeners
+ * @param callback - Invoked with the amount of invoked listeners (including unhandled) once all listeners are done
+ * @param context - Will be passed to the callback
+ * @returns true if the event was triggered
+ */
+bool eventemitter_emit_async_with_callback(struct EventEmitter *, int /* event ID */, void * /* event data */, void (*callback)(int /* callback counter */, void * /* context */), void * /* context */);
+
+/**
+ * Blocks until all listeners of the async emit are done and frees the handle.
+ *
+ * @param handle - The handle returned from emit async
+ * @returns the amount of callbacks invoked (including unhandled) or returns -1 in case of invalid input
+ */
+int eventemitter_wait_async_emit(struct EventEmitterAsyncEmit *);
+
+/**
+ * Creates an owned payload, which is freed once its last reference is released.
+ * The caller holds the first reference. Owned emits take over one reference each and release it once
+ * their listeners are done, while listeners which keep the payload after they return retain it.
+ * Small payloads are allocated from the emitter payload arena, so a payload must be released before its emitter.
+ * Can be called from any thread (the allocator must be thread safe for payloads which do not fit the arena).
+ *
+ * @param event emitter - The emitter struct
+ * @param size - The payload size
+ * @param release - Optional callback invoked with the payload once the last reference is released, before its memory is freed
+ * @returns the payload memory (max aligned) or NULL in case of invalid input or allocation failure
+ */
+void *eventemitter_payload_new(struct EventEmitter *, size_t /* size */, void (*release)(void *payload));
+
+/**
+ * Adds a reference to the owned payload.
+ * Can be called from any thread.
+ *
+ * @param payload - The payload created via eventemitter_payload_new
+ * @returns the payload
+ */
+void *eventemitter_payload_retain(void * /* payload */);
+
+/**
+ * Removes a reference from the owned payload, the last reference frees it.
+ * Can be called from any thread.
+ *
+ * @param payload - The payload created via eventemitter_payload_new (may be NULL)
+ */
+void eventemitter_payload_release(void * /* payload */);
+
+/**
+ * Same as emit, where the event data is an owned payload.
+ * Takes over a reference of the caller, which is released once the listeners are done.
+ *
+ * @param event emitter - The emitter struct
+ * @param event ID - The event ID
+ * @param payload - The payload created via eventemitter_payload_new, passed as the event data to all relevant listeners
+ * @returns the amount of callbacks invoked (including unhandled) or -1 in case of invalid input (the reference is not released)
+ */
+int eventemitter_emit_owned(struct EventEmitter *, int /* event ID */, void * /* payload */);
+
+/**
+ * Same as enqueue, where the event data is an owned payload (available when built with EVENTEMITTER_THREADS).
+ * Takes over a reference of the caller, which is released once the event is dispatched (or the emitter is released).
+ *
+ * @param event emitter - The emitter struct
+ * @param event ID - The event ID
+ * @param payload - The payload created via eventemitter_payload_new, passed as the event data to all relevant listeners
+ * @returns true if queued, false in case of invalid input, missing queue or if the queue is full (the reference is not released)
+ */
+bool eventemitter_enqueue_owned(struct EventEmitter *, int /* event ID */, void * /* payload */);
+
+/**
+ * Same as emit async, where the event data is an owned payload (available when built with EVENTEMITTER_THREADS).
+ * Takes over a reference of the caller, which is released on a worker thread once all listeners are done.
+ *
+ * @param event emitter - The emitter struct
+ * @param event ID - The event ID
+ * @param payload - The payload created via eventemitter_payload_new, passed as the event data to all relevant listeners
+ * @returns true if the event was triggered, false in case of invalid input, allocation failure or if the workers were not started (the reference is not released)
+ */
+bool eventemitter_emit_async_owned(struct EventEmitter *, int /* event ID */, void * /* payload */);
+
+/**
+ * Returns the counters of the entire emitter (available when built with EVENTEMITTER_STATS).
+ *
+ * @param event emitter - The emitter struct
+ * @param stats - Populated with the counters
+ * @returns true if populated, false in case of invalid input
+ */
+bool eventemitter_get_stats(struct EventEmitter *, struct EventEmitterStats *);
+
+/**
+ * Returns the counters of the given event ID (available when built with EVENTEMITTER_STATS).
+ * The counters of an event are kept from the first time a listener was added to it until the
+ * emitter is released, while emits are only counted when the event has listeners.
+ *
+ * @param event emitter - The emitter struct
+ * @param event ID - The event ID
+ * @param stats - Populated with the counters
+ * @returns true if populated, false in case of invalid input or if the event never had listeners
+ */
+bool eventemitter_get_event_stats(struct EventEmitter *, int /* event ID */, struct EventEmitterStats *);
+
+/**
+ * Invokes the callback with the counters of each event ID (available when built with EVENTEMITTER_STATS).
+ * The callback must not add listeners to the emitter.
+ *
+ * @param event emitter - The emitter struct
+ * @param callback - Invoked for each event ID with its counters
+ * @param context - Will be passed to the callback
+ * @returns true if done, false in case of invalid input
+ */
+bool eventemitter_iterate_event_stats(struct EventEmitter *, void (*callback)(int /* event ID */, const struct EventEmitterStats * /* stats */, void * /* context */), void * /* context */);
+
+/**
+ * Sets the tracing hooks of the emitter (available when built with EVENTEMITTER_TRACE).
+ * The hooks are copied and used by emit, emit batch, queue dispatch and frozen emits.
+ * Async emits invoke the emit hooks when started and once their last listener is done, and the
+ * listener hooks on the worker threads, with the hooks set when the async emit was started.
+ * Hooks used by async or concurrent frozen emits must be thread safe, and the hooks of a frozen
+ * emitter must not be changed while it is emitted from other threads.
+ * While no hooks are set, each emit only checks a single flag.
+ *
+ * @param event emitter - The emitter struct
+ * @param hooks - The hooks to invoke or NULL to stop tracing
+ * @returns true if set, false in case of invalid input
+ */
+bool eventemitter_set_trace_hooks(struct EventEmitter *, const struct EventEmitterTraceHooks *);
+
 #endif
 
@@ -0,0 +1,110 @@
+#ifndef EVENTEMITTER_BUS_H
+#define EVENTEMITTER_BUS_H
+
+#include "eventemitter.h"
+
+/**
+ * Cross process event bus (available on Linux when built with EVENTEMITTER_THREADS).
+ *
+ * The bus is a bounded ring buffer in shared memory (memfd), which any amount of processes
+ * (and threads) can emit events to, without taking any lock.
+ * A single consumer at a time dispatches the received events to the listeners of an ordinary
+ * local emitter. Payloads are copied into the ring by the emitting process and passed to the
+ * listeners in place, without being copied again.
+ * The consumer can sleep until events arrive, emitting processes only wake it (via futex)
+ * when it is sleeping.
+ */
+struct EventEmitterBus;
+
+/**
+ * The event data passed to the local listeners for each received event.
+ * The payload is only valid during the listener invocation.
+ */
+struct EventEmitterBusPayload
+{
+  const void *data;
+  size_t     size;
+};
+
+/**
+ * Creates a new bus in a new shared memory file.
+ * Other processes attach to it via eventemitter_bus_open with the bus file descriptor
+ * (inherited via fork or passed via a unix socket).
+ * Once no longer needed, it must be released.
+ *
+ * @param capacity - The max amount of queued events (rounded up to a power of 2)
+ * @param max payload size - The max size of the payload of each event
+ * @returns the new bus or NULL in case of invalid input or failure to create the shared memory
+ */
+struct EventEmitterBus *eventemitter_bus_create(size_t /* capacity */, size_t /* max payload size */);
+
+/**
+ * Attaches to an existing bus via its file descriptor.
+ * The file descriptor is duplicated, so the caller still owns (and may close) the provided one.
+ * Once no longer needed, it must be released.
+ *
+ * @param fd - The bus file descriptor
+ * @returns the bus or NULL in case of invalid input, failure to map the memory or if the file is not a bus
+ */
+struct EventEmitterBus *eventemitter_bus_open(int /* fd */);
+
+/**
+ * Unmaps the bus and closes its file descriptor.
+ * The shared memory is freed once all the processes released the bus.
+ */
+void eventemitter_bus_release(struct EventEmitterBus *);
+
+/**
+ * Returns the file descriptor of the bus, which other processes use to open it.
+ *
+ * @param bus - The bus
+ * @returns the file descriptor or -1 in case of invalid input
+ */
+int eventemitter_bus_get_fd(struct EventEmitterBus *);
+
+/**
+ * Returns the max payload size of the bus events.
+ *
+ * @param bus - The bus
+ * @returns the max payload size or 0 in case of invalid input
+ */
+size_t eventemitter_bus_max_payload_size(struct EventEmitterBus *);
+
+/**
+ * Copies the event into the bus, to be emitted by the next dispatch of the consumer.
+ * Can be called from any amount of processes and threads concurrently and does not take any lock.
+ *
+ * @param bus - The bus
+ * @param event ID - The event ID
+ * @param payload - The payload bytes (may be NULL if the size is 0)
+ * @param size - The payload size
+ * @returns true if queued, false in case of invalid input, a payload above the max payload size or if the bus is full
+ */
+bool eventemitter_bus_emit(struct EventEmitterBus *, int /* event ID */, const void * /* payload */, size_t /* size */);
+
+/**
+ * Emits the queued events on the provided local emitter, in their queue order.
+ * The listeners get a struct EventEmitterBusPayload as the event data, which points to the payload in the bus.
+ * Each event is kept in the bus until its listeners return, so listeners emitting to the same bus need free capacity for
+ * their events.
+ * Must only be called by a single consumer at a time, nested calls (from listeners) dispatch nothing.
+ *
+ * @param bus - The bus
+ * @param event emitter - The local emitter
+ * @param max events - The max amount of events to dispatch or 0 to dispatch all events queued before the call
+ * @returns the amount of dispatched events or -1 in case of invalid input
+ */
+int eventemitter_bus_dispatch(struct EventEmitterBus *, struct EventEmitter *, size_t /* max events */);
+
+/**
+ * Waits until the bus has events to dispatch.
+ * Must only be called by the consumer.
+ *
+ * @param bus - The bus
+ * @param timeout - The max time to wait in milliseconds or a negative value to wait without a limit
+ * @returns 1 if events are queued, 0 on timeout or -1 in case of invalid input or wait failure
+ */
+int eventemitter_bus_wait(struct EventEmitterBus *, int /* timeout */);
+
+#endif
+
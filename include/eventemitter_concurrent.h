@@ -0,0 +1,153 @@
+#ifndef EVENTEMITTER_CONCURRENT_H
+#define EVENTEMITTER_CONCURRENT_H
+
+#include "eventemitter.h"
+
+/**
+ * Thread safe event emitter variant (available when built with EVENTEMITTER_THREADS).
+ *
+ * Emit does not take any lock, it reads an immutable listeners table which is replaced
+ * with a new version on every add/remove call. Add/remove calls are serialized by a writer
+ * lock and old table versions are freed once no emit can still be reading them.
+ * It is therefore optimized for many concurrent emits and infrequent listener changes.
+ *
+ * Callbacks may call any of the functions (except release) on the same emitter.
+ * Listener changes are visible to emits that start after the change function returned.
+ * 'once' listeners are not supported.
+ */
+struct EventEmitterConcurrent;
+
+/**
+ * Creates and returns a new concurrent event emitter.
+ * Once no longer needed, it must be released.
+ */
+struct EventEmitterConcurrent *eventemitter_concurrent_new(void);
+
+/**
+ * Creates and returns a new concurrent event emitter which uses the provided allocator
+ * for all its internal memory (including the emitter itself).
+ * The allocator is only invoked by add/remove/release calls, which are serialized.
+ * Once no longer needed, it must be released.
+ *
+ * @param allocator - The allocation hooks (all hooks must be provided)
+ * @returns the new emitter or NULL in case of invalid input
+ */
+struct EventEmitterConcurrent *eventemitter_concurrent_new_with_allocator(const struct EventEmitterAllocator *);
+
+/**
+ * Frees the memory of the provided emitter.
+ * Must not be called while other threads are still using the emitter.
+ */
+void eventemitter_concurrent_release(struct EventEmitterConcurrent *);
+
+/**
+ * Adds a new event listener for the given event ID.
+ *
+ * @param event emitter - The emitter struct
+ * @param event ID - The event ID that listeners have registered on
+ * @param callback - Will be called when the event ID is triggered via emit
+ * @param context - Will be passed to this specific callback when an event is triggered
+ * @returns 0 in case of error or the callback ID which can be used to remove the listener
+ */
+unsigned int eventemitter_concurrent_add_listener(struct EventEmitterConcurrent *, int /* event ID */, void (*callback)(void * /* event data */, void * /* context */), void * /* context */);
+
+/**
+ * Same as the add listener, but it adds it to the start of the listener list.
+ *
+ * @param event emitter - The emitter struct
+ * @param event ID - The event ID that listeners have registered on
+ * @param callback - Will be called when the event ID is triggered via emit
+ * @param context - Will be passed to this specific callback when an event is triggered
+ * @returns 0 in case of error or the callback ID which can be used to remove the listener
+ */
+unsigned int eventemitter_concurrent_prepend_listener(struct EventEmitterConcurrent *, int /* event ID */, void (*callback)(void * /* event data */, void * /* context */), void * /* context */);
+
+/**
+ * Adds a new event listener which will be invoked for any event ID without registered listeners.
+ *
+ * @param event emitter - The emitter struct
+ * @param callback - Will be called when the event ID is triggered via emit
+ * @param context - Will be passed to this specific callback when an event is triggered
+ * @returns 0 in case of error or the callback ID which can be used to remove the listener
+ */
+unsigned int eventemitter_concurrent_add_unhandled_listener(struct EventEmitterConcurrent *, void (*callback)(int /* event ID */, void * /* event data */, void * /* context */), void * /* context */);
+
+/**
+ * Removes the listener (event or unhandled events listener) for the given callback ID if exists.
+ *
+ * @param event emitter - The emitter struct
+ * @param callback ID - The callback ID returned from any of the add listener functions
+ * @returns -1 for invalid input or allocation failure, 0 for callback not found, 1 for removed
+ */
+int eventemitter_concurrent_remove_listener(struct EventEmitterConcurrent *, unsigned int /* callback ID */);
+
+/**
+ * Removes all listeners for the given event ID.
+ *
+ * @param event emitter - The emitter struct
+ * @param event ID - The event ID that listeners have registered on
+ * @returns true in case of valid input and no allocation failure
+ */
+bool eventemitter_concurrent_remove_all_event_listeners(struct EventEmitterConcurrent *, int /* event ID */);
+
+/**
+ * Removes all listeners for all events (including unhandled events listeners).
+ *
+ * @param event emitter - The emitter struct
+ * @returns true in case of valid input
+ */
+bool eventemitter_concurrent_remove_all_listeners(struct EventEmitterConcurrent *);
+
+/**
+ * Returns the listeners count for the given event ID.
+ *
+ * @param event emitter - The emitter struct
+ * @param event ID - The event ID that listeners have registered on
+ * @returns the amount of callbacks registered for the given event ID or returns -1 in case of invalid input
+ */
+int eventemitter_concurrent_listeners_count(struct EventEmitterConcurrent *, int /* event ID */);
+
+/**
+ * Triggers an event for the given event ID without taking any lock.
+ * Can be called from any amount of threads concurrently.
+ *
+ * @param event emitter - The emitter struct
+ * @param event ID - The event ID
+ * @param event data - The event data passed to all relevant listeners
+ * @returns the amount of callbacks invoked (including unhandled) or returns -1 in case of invalid input
+ */
+int eventemitter_concurrent_emit(struct EventEmitterConcurrent *, int /* event ID */, void * /* event data */);
+
+/**
+ * Returns the counters of the entire emitter (available when built with EVENTEMITTER_STATS).
+ * Emits are counted with relaxed atomics, so counters of emits done concurrently may not be included yet.
+ *
+ * @param event emitter - The emitter struct
+ * @param stats - Populated with the counters
+ * @returns true if populated, false in case of invalid input
+ */
+bool eventemitter_concurrent_get_stats(struct EventEmitterConcurrent *, struct EventEmitterStats *);
+
+/**
+ * Returns the counters of the given event ID (available when built with EVENTEMITTER_STATS).
+ *
+ * @param event emitter - The emitter struct
+ * @param event ID - The event ID
+ * @param stats - Populated with the counters
+ * @returns true if populated, false in case of invalid input or if the event never had listeners
+ */
+bool eventemitter_concurrent_get_event_stats(struct EventEmitterConcurrent *, int /* event ID */, struct EventEmitterStats *);
+
+/**
+ * Invokes the callback with the counters of each event ID (available when built with EVENTEMITTER_STATS).
+ * The writer lock is held during the iteration so the callback must not change the listeners.
+ *
+ * @param event emitter - The emitter struct
+ * @param callback - Invoked for each event ID with its counters
+ * @param context - Will be passed to the callback
+ * @returns true if done, false in case of invalid input
+ */
+bool eventemitter_concurrent_iterate_event_stats(struct EventEmitterConcurrent *, void (*callback)(int /* event ID */, const struct EventEmitterStats * /* stats */, void * /* context */), void * /* context */);
+
+#endif
+
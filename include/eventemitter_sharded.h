@@ -0,0 +1,100 @@
+#ifndef EVENTEMITTER_SHARDED_H
+#define EVENTEMITTER_SHARDED_H
+
+#include "eventemitter.h"
+
+/**
+ * Sharded event emitter (available when built with EVENTEMITTER_THREADS).
+ *
+ * Holds one regular emitter (shard) per thread or core, each owned by a single thread which adds
+ * its listeners and emits its events on it directly, so local emits do not share any memory
+ * with the other threads.
+ * Events for other shards (and broadcasts to all shards) are queued in the lock free inbox
+ * of each target shard and emitted once its owner thread dispatches the inbox.
+ */
+struct EventEmitterSharded;
+
+/**
+ * Creates and returns a new sharded event emitter.
+ * Once no longer needed, it must be released.
+ *
+ * @param shard count - The amount of shards
+ * @param inbox capacity - The max amount of queued events of each shard (rounded up to a power of 2)
+ * @returns the new emitter or NULL in case of invalid input or allocation failure
+ */
+struct EventEmitterSharded *eventemitter_sharded_new(size_t /* shard count */, size_t /* inbox capacity */);
+
+/**
+ * Creates and returns a new sharded event emitter which uses the provided allocator
+ * for all its internal memory (including the shards).
+ * The allocator may be invoked concurrently by the shard owner threads.
+ * Once no longer needed, it must be released.
+ *
+ * @param allocator - The allocation hooks (all hooks must be provided)
+ * @param shard count - The amount of shards
+ * @param inbox capacity - The max amount of queued events of each shard (rounded up to a power of 2)
+ * @returns the new emitter or NULL in case of invalid input or allocation failure
+ */
+struct EventEmitterSharded *eventemitter_sharded_new_with_allocator(const struct EventEmitterAllocator *, size_t /* shard count */, size_t /* inbox capacity */);
+
+/**
+ * Frees the memory of the provided emitter and all its shards.
+ * Must not be called while other threads are still using the emitter.
+ */
+void eventemitter_sharded_release(struct EventEmitterSharded *);
+
+/**
+ * Returns the amount of shards.
+ *
+ * @param event emitter - The emitter struct
+ * @returns the amount of shards or 0 in case of invalid input
+ */
+size_t eventemitter_sharded_shards_count(struct EventEmitterSharded *);
+
+/**
+ * Returns the emitter of the given shard.
+ * It must only be used by the shard owner thread, which adds the shard listeners and emits local events
+ * with any of the eventemitter.h functions (except release and the queue functions).
+ *
+ * @param event emitter - The emitter struct
+ * @param shard - The shard index
+ * @returns the shard emitter or NULL in case of invalid input
+ */
+struct EventEmitter *eventemitter_sharded_get_shard(struct EventEmitterSharded *, size_t /* shard */);
+
+/**
+ * Queues an event in the inbox of the given shard, to be emitted by its next dispatch.
+ * Can be called from any amount of threads concurrently and does not take any lock.
+ *
+ * @param event emitter - The emitter struct
+ * @param shard - The target shard index
+ * @param event ID - The event ID
+ * @param event data - The event data passed to all relevant listeners of the shard once dispatched
+ * @returns true if queued, false in case of invalid input or if the inbox is full
+ */
+bool eventemitter_sharded_emit_to(struct EventEmitterSharded *, size_t /* shard */, int /* event ID */, void * /* event data */);
+
+/**
+ * Queues an event in the inbox of every shard.
+ * Can be called from any amount of threads concurrently and does not take any lock.
+ *
+ * @param event emitter - The emitter struct
+ * @param event ID - The event ID
+ * @param event data - The event data passed to all relevant listeners of each shard once dispatched
+ * @returns the amount of shards the event was queued for (less than the shards count if inboxes are full) or 0 in case of invalid input
+ */
+size_t eventemitter_sharded_broadcast(struct EventEmitterSharded *, int /* event ID */, void * /* event data */);
+
+/**
+ * Emits the events queued in the inbox of the given shard, in their queue order.
+ * Must only be called from the shard owner thread.
+ *
+ * @param event emitter - The emitter struct
+ * @param shard - The shard index
+ * @param max events - The max amount of events to dispatch or 0 to dispatch all events queued before the call
+ * @returns the amount of dispatched events or -1 in case of invalid input
+ */
+int eventemitter_sharded_dispatch(struct EventEmitterSharded *, size_t /* shard */, size_t /* max events */);
+
+#endif
+
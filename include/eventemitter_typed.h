@@ -0,0 +1,224 @@
+#ifndef EVENTEMITTER_TYPED_H
+#define EVENTEMITTER_TYPED_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * Generator of a type safe emitter for a fixed set of event IDs (0 to event count - 1, usually an enum)
+ * with a typed payload, for example:
+ *
+ *   enum Signal { SIGNAL_OPEN, SIGNAL_CLOSE, SIGNAL_COUNT };
+ *   EVENTEMITTER_DEFINE_TYPED(signals, enum Signal, const char *, SIGNAL_COUNT, 4)
+ *
+ *   struct signals emitter;
+ *   signals_init(&emitter);
+ *   signals_on(&emitter, SIGNAL_OPEN, on_open, NULL);
+ *   signals_emit(&emitter, SIGNAL_OPEN, "file.txt");
+ *
+ * All functions are static inline and the listeners are kept in a fixed size table inside the
+ * emitter struct (no memory is allocated), so emits of small static listener sets can be fully
+ * inlined by the compiler.
+ * The functions follow the semantics of the matching eventemitter.h functions: callbacks may add
+ * and remove listeners during emit, listeners added during emit of the same event are invoked from
+ * the next emit and removed listeners are not invoked.
+ * Unlike eventemitter.h, listeners can not be prepended while their event is dispatched and there
+ * are no unhandled events listeners.
+ *
+ * Generated for the given name:
+ *   struct name
+ *   void name_init(struct name *)
+ *   unsigned int name_on(struct name *, event_type, void (*callback)(payload_type, void *), void *)
+ *   unsigned int name_once(struct name *, event_type, void (*callback)(payload_type, void *), void *)
+ *   unsigned int name_prepend(struct name *, event_type, void (*callback)(payload_type, void *), void *)
+ *   int name_remove_listener(struct name *, event_type, unsigned int)
+ *   int name_listeners_count(const struct name *, event_type)
+ *   int name_emit(struct name *, event_type, payload_type)
+ * The add functions return 0 for invalid input or a full event table, otherwise the callback ID.
+ * Remove returns -1 for invalid input, 0 for callback not found and 1 for removed.
+ * Listeners count and emit return -1 for invalid event IDs.
+ *
+ * @param name - The emitter struct name and functions prefix
+ * @param event_type - The event ID type (an enum or an integer type)
+ * @param payload_type - The event data type passed to the listeners
+ * @param event_count - The amount of event IDs
+ * @param max_listeners - The max amount of listeners of each event ID
+ */
+#define EVENTEMITTER_DEFINE_TYPED(name, event_type, payload_type, event_count, max_listeners)                       \
+  struct name ## _listener                                                                                          \
+  {                                                                                                                 \
+    void         (*callback)(payload_type, void *);                                                                 \
+    void         *context;                                                                                          \
+    /* removed listeners are kept with ID 0 until the event is no longer dispatched */                              \
+    unsigned int id;                                                                                                \
+    bool         once;                                                                                              \
+  };                                                                                                                \
+                                                                                                                    \
+  struct name ## _event                                                                                             \
+  {                                                                                                                 \
+    struct name ## _listener listeners[max_listeners];                                                              \
+    size_t                   count;                                                                                 \
+    size_t                   removed;                                                                               \
+    unsigned int             dispatching;                                                                           \
+  };                                                                                                                \
+                                                                                                                    \
+  struct name                                                                                                       \
+  {                                                                                                                 \
+    struct name ## _event events[event_count];                                                                      \
+    unsigned int          next_callback_id;                                                                         \
+  };                                                                                                                \
+                                                                                                                    \
+  static inline void name ## _init(struct name *event_emitter)                                                      \
+  {                                                                                                                 \
+    for (size_t index = 0; index < (size_t)(event_count); index++)                                                  \
+    {                                                                                                               \
+      event_emitter->events[index].count       = 0;                                                                 \
+      event_emitter->events[index].removed     = 0;                                                                 \
+      event_emitter->events[index].dispatching = 0;                                                                 \
+    }                                                                                                               \
+    event_emitter->next_callback_id = 1;                                                                            \
+  }                                                                                                                 \
+                                                                                                                    \
+  static inline void _ ## name ## _compact(struct name ## _event *event)                                            \
+  {                                                                                                                 \
+    size_t output_index = 0;                                                                                        \
+    for (size_t index = 0; index < event->count; index++)                                                           \
+    {                                                                                                               \
+      if (event->listeners[index].id)                                                                               \
+      {                                                                                                             \
+        event->listeners[output_index] = event->listeners[index];                                                   \
+        output_index++;                                                                                             \
+      }                                                                                                             \
+    }                                                                                                               \
+    event->count   = output_index;                                                                                  \
+    event->removed = 0;                                                                                             \
+  }                                                                                                                 \
+                                                                                                                    \
+  static inline unsigned int _ ## name ## _add(struct name *event_emitter, event_type event_id, void (*callback)(payload_type, void *), void *context, bool once, bool prepend) \
+  {                                                                                                                 \
+    if (event_emitter == NULL || callback == NULL || (size_t)event_id >= (size_t)(event_count))                     \
+    {                                                                                                               \
+      return(0);                                                                                                    \
+    }                                                                                                               \
+                                                                                                                    \
+    struct name ## _event *event = &event_emitter->events[(size_t)event_id];                                        \
+    if (event->removed && !event->dispatching)                                                                      \
+    {                                                                                                               \
+      _ ## name ## _compact(event);                                                                                 \
+    }                                                                                                               \
+    if (event->count >= (size_t)(max_listeners) || (prepend && event->dispatching))                                 \
+    {                                                                                                               \
+      return(0);                                                                                                    \
+    }                                                                                                               \
+                                                                                                                    \
+    size_t position = event->count;                                                                                 \
+    if (prepend)                                                                                                    \
+    {                                                                                                               \
+      for (; position > 0; position--)                                                                              \
+      {                                                                                                             \
+        event->listeners[position] = event->listeners[position - 1];                                                \
+      }                                                                                                             \
+    }                                                                                                               \
+    event->listeners[position].callback = callback;                                                                 \
+    event->listeners[position].context  = context;                                                                  \
+    event->listeners[position].id       = event_emitter->next_callback_id;                                          \
+    event->listeners[position].once     = once;                                                                     \
+    event->count++;                                                                                                 \
+    event_emitter->next_callback_id++;                                                                              \
+    /* 0 marks removed listeners, so it is skipped once the counter wraps around */                                 \
+    if (!event_emitter->next_callback_id)                                                                           \
+    {                                                                                                               \
+      event_emitter->next_callback_id = 1;                                                                          \
+    }                                                                                                               \
+                                                                                                                    \
+    return(event->listeners[position].id);                                                                          \
+  }                                                                                                                 \
+                                                                                                                    \
+  static inline unsigned int name ## _on(struct name *event_emitter, event_type event_id, void (*callback)(payload_type, void *), void *context) \
+  {                                                                                                                 \
+    return(_ ## name ## _add(event_emitter, event_id, callback, context, false, false));                            \
+  }                                                                                                                 \
+                                                                                                                    \
+  static inline unsigned int name ## _once(struct name *event_emitter, event_type event_id, void (*callback)(payload_type, void *), void *context) \
+  {                                                                                                                 \
+    return(_ ## name ## _add(event_emitter, event_id, callback, context, true, false));                             \
+  }                                                                                                                 \
+                                                                                                                    \
+  static inline unsigned int name ## _prepend(struct name *event_emitter, event_type event_id, void (*callback)(payload_type, void *), void *context) \
+  {                                                                                                                 \
+    return(_ ## name ## _add(event_emitter, event_id, callback, context, false, true));                             \
+  }                                                                                                                 \
+                                                                                                                    \
+  static inline int name ## _remove_listener(struct name *event_emitter, event_type event_id, unsigned int callback_id) \
+  {                                                                                                                 \
+    if (event_emitter == NULL || !callback_id || (size_t)event_id >= (size_t)(event_count))                         \
+    {                                                                                                               \
+      return(-1);                                                                                                   \
+    }                                                                                                               \
+                                                                                                                    \
+    struct name ## _event *event = &event_emitter->events[(size_t)event_id];                                        \
+    for (size_t index = 0; index < event->count; index++)                                                           \
+    {                                                                                                               \
+      if (event->listeners[index].id == callback_id)                                                                \
+      {                                                                                                             \
+        event->listeners[index].id = 0;                                                                             \
+        event->removed++;                                                                                           \
+        if (!event->dispatching)                                                                                    \
+        {                                                                                                           \
+          _ ## name ## _compact(event);                                                                             \
+        }                                                                                                           \
+        return(1);                                                                                                  \
+      }                                                                                                             \
+    }                                                                                                               \
+                                                                                                                    \
+    return(0);                                                                                                      \
+  }                                                                                                                 \
+                                                                                                                    \
+  static inline int name ## _listeners_count(const struct name *event_emitter, event_type event_id)                 \
+  {                                                                                                                 \
+    if (event_emitter == NULL || (size_t)event_id >= (size_t)(event_count))                                         \
+    {                                                                                                               \
+      return(-1);                                                                                                   \
+    }                                                                                                               \
+                                                                                                                    \
+    const struct name ## _event *event = &event_emitter->events[(size_t)event_id];                                  \
+    return((int)(event->count - event->removed));                                                                   \
+  }                                                                                                                 \
+                                                                                                                    \
+  static inline int name ## _emit(struct name *event_emitter, event_type event_id, payload_type event_data)         \
+  {                                                                                                                 \
+    if (event_emitter == NULL || (size_t)event_id >= (size_t)(event_count))                                         \
+    {                                                                                                               \
+      return(-1);                                                                                                   \
+    }                                                                                                               \
+                                                                                                                    \
+    /* only the listeners added before the emit are invoked */                                                      \
+    struct name ## _event *event           = &event_emitter->events[(size_t)event_id];                              \
+    size_t                count            = event->count;                                                          \
+    int                   callback_counter = 0;                                                                     \
+    event->dispatching++;                                                                                           \
+    for (size_t index = 0; index < count; index++)                                                                  \
+    {                                                                                                               \
+      struct name ## _listener *listener = &event->listeners[index];                                                \
+      if (listener->id)                                                                                             \
+      {                                                                                                             \
+        if (listener->once)                                                                                         \
+        {                                                                                                           \
+          listener->id = 0;                                                                                         \
+          event->removed++;                                                                                         \
+        }                                                                                                           \
+        listener->callback(event_data, listener->context);                                                          \
+        callback_counter++;                                                                                         \
+      }                                                                                                             \
+    }                                                                                                               \
+    event->dispatching--;                                                                                           \
+    if (event->removed && !event->dispatching)                                                                      \
+    {                                                                                                               \
+      _ ## name ## _compact(event);                                                                                 \
+    }                                                                                                               \
+                                                                                                                    \
+    return(callback_counter);                                                                                       \
+  }
+
+#endif
+
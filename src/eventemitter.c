@@ -1,49 +1,149 @@
-#include "eventemitter.h"
-#include "vector.h"
-#include <stdlib.h>
-
-struct EventEmitter
-{
-  unsigned int  next_callback_id;
-  struct Vector *event_listeners;
-  struct Vector *unhandled_listeners;
-};
-
-struct EventEmitterEventListeners
+#include "eventemitter_internal.h"
+#include <limits.h>
+#include <stdint.h>
+#include <string.h>
+
+#ifdef EVENTEMITTER_THREADS
+#include "eventemitter_workers.h"
+#endif
+
+#ifdef EVENTEMITTER_TRACE
+#include <time.h>
+#endif
+
+#define EVENTEMITTER_LISTENERS_INITIAL_CAPACITY    4
+#define EVENTEMITTER_POOL_CHUNKS_PER_SLAB          64
+#define EVENTEMITTER_SLOT_PAGE_BITS                8
+#define EVENTEMITTER_SLOT_PAGE_SIZE                ((size_t)1 << EVENTEMITTER_SLOT_PAGE_BITS)
+#define EVENTEMITTER_BATCH_CACHE_SIZE              16
+#define EVENTEMITTER_RANGE_MATCHES_WINDOW          16
+#define EVENTEMITTER_MASKS_INITIAL_CAPACITY        4
+#define EVENTEMITTER_LISTENERS_INSERTION_SORT_MAX  16
+
+#ifdef EVENTEMITTER_THREADS
+// a single listener invocation of an async emit
+struct EventEmitterAsyncEmitTask
 {
-  int           event_id;
-  struct Vector *listeners;
+  struct EventEmitterWorkerTask    task;
+  struct EventEmitterAsyncEmit     *async_emit;
+  struct EventEmitterEventListener listener;
+  // unhandled, range and mask listeners are invoked with the event ID
+  bool                             unhandled;
 };
 
-struct EventEmitterEventListener
+struct EventEmitterAsyncEmit
 {
-  unsigned int id;
-  void         (*callback)(void *event_data, void *context);
-  void         *context;
-  bool         once;
-};
-
-struct EventEmitterUnhandledListener
-{
-  unsigned int id;
-  void         (*callback)(int event_id, void *event_data, void *context);
-  void         *context;
+  struct EventEmitterAllocator     allocator;
+  struct EventEmitterWorkers       *workers;
+  int                              event_id;
+  void                             *event_data;
+  void                             (*callback)(int callback_counter, void *context);
+  void                             *context;
+  int                              callback_counter;
+  atomic_size_t                    remaining;
+  atomic_bool                      done;
+#ifdef EVENTEMITTER_TRACE
+  // copy of the emitter trace hooks, all NULL while not tracing
+  struct EventEmitterTraceHooks    trace_hooks;
+#endif
+  struct EventEmitterAsyncEmitTask tasks[];
 };
+#endif
 
 // private functions
+static struct EventEmitter *_eventemitter_new(const struct EventEmitterAllocator *, int, size_t);
+static uint64_t _eventemitter_event_key(int);
 static struct EventEmitterEventListeners *_eventemitter_get_listeners_for_event_id(struct EventEmitter *, int);
-static unsigned int _eventemitter_add_listener(struct EventEmitter *, int, void (*callback)(void *, void *), void *, bool, bool);
+static bool _eventemitter_set_listeners_for_event_id(struct EventEmitter *, int, struct EventEmitterEventListeners *);
+static struct EventEmitterEventListeners *_eventemitter_get_or_create_listeners(struct EventEmitter *, int);
+static void _eventemitter_release_listeners(struct EventEmitter *, struct EventEmitterEventListeners *);
+static void _eventemitter_detach_listeners(struct EventEmitter *, struct EventEmitterEventListeners *);
+static void _eventemitter_release_empty_listeners(struct EventEmitter *, struct EventEmitterEventListeners *);
+static bool _eventemitter_retain_listeners(struct EventEmitter *, struct EventEmitterEventListeners *);
+static void _eventemitter_listeners_init(struct EventEmitterEventListeners *, int);
+static void _eventemitter_listeners_clear(struct EventEmitter *, struct EventEmitterEventListeners *);
+static void _eventemitter_listeners_release_records(struct EventEmitter *, struct EventEmitterEventListeners *);
+static bool _eventemitter_listeners_reserve(struct EventEmitter *, struct EventEmitterEventListeners *, size_t);
+static bool _eventemitter_listeners_insert(struct EventEmitter *, struct EventEmitterEventListeners *, struct EventEmitterEventListener, bool);
+static void _eventemitter_listeners_insert_staged(struct EventEmitter *, struct EventEmitterEventListeners *, struct EventEmitterEventListener *);
+static void _eventemitter_listeners_update_slots(struct EventEmitter *, struct EventEmitterEventListeners *, size_t);
+static size_t _eventemitter_listeners_search(const struct EventEmitterEventListener *, size_t, int, bool);
+static void _eventemitter_listeners_merge(struct EventEmitterEventListener *, const struct EventEmitterEventListener *, size_t, const struct EventEmitterEventListener *, size_t);
+static void _eventemitter_listeners_sort(struct EventEmitter *, struct EventEmitterEventListeners *);
+static void _eventemitter_listeners_compact(struct EventEmitter *, struct EventEmitterEventListeners *);
+static void _eventemitter_listeners_commit(struct EventEmitter *, struct EventEmitterEventListeners *);
+static void _eventemitter_listeners_remove_record(struct EventEmitter *, struct EventEmitterEventListeners *, struct EventEmitterEventListener *);
+static int _eventemitter_listeners_invoke(struct EventEmitter *, struct EventEmitterEventListeners *, void *);
+static int _eventemitter_unhandled_listeners_invoke(struct EventEmitterEventListeners *, int, void *);
+static void _eventemitter_listeners_unpin(struct EventEmitter *, struct EventEmitterEventListeners *);
+static int _eventemitter_remove_listener_in_slot(struct EventEmitter *, struct EventEmitterListenerSlot *);
+static struct EventEmitterListenerSlot *_eventemitter_get_slot(struct EventEmitter *, size_t);
+static bool _eventemitter_alloc_slot(struct EventEmitter *, size_t *);
+static void _eventemitter_release_slot(struct EventEmitter *, struct EventEmitterEventListener *);
+static uint64_t _eventemitter_slot_handle(const struct EventEmitterListenerSlot *);
+static struct EventEmitterListenerSlot *_eventemitter_get_slot_for_handle(struct EventEmitter *, uint64_t);
+static unsigned int _eventemitter_next_callback_id(struct EventEmitter *);
+static bool _eventemitter_index_record(struct EventEmitter *, struct EventEmitterEventListener *);
+static bool _eventemitter_add_record(struct EventEmitter *, struct EventEmitterEventListeners *, struct EventEmitterEventListener, bool);
+static unsigned int _eventemitter_add_listener(struct EventEmitter *, int, void (*callback)(void *, void *), void *, bool, bool, int);
 static unsigned int _eventemitter_add_unhandled_listener(struct EventEmitter *, void (*callback)(int, void *, void *), void *, bool);
+static uint64_t _eventemitter_mask_key(int, int);
+static bool _eventemitter_masks_acquire(struct EventEmitter *, int);
+static void _eventemitter_masks_release(struct EventEmitter *, int);
+static void _eventemitter_masks_compact(struct EventEmitter *);
+static struct EventEmitterEventListeners *_eventemitter_get_or_create_pattern_listeners(struct EventEmitter *, int, int, int);
+static unsigned int _eventemitter_add_pattern_listener(struct EventEmitter *, int, int, int, void (*callback)(int, void *, void *), void *);
+static bool _eventemitter_freeze_collect(struct EventEmitter *, struct EventEmitterEventListeners *, struct EventEmitterEventListeners **, size_t *);
+static int _eventemitter_frozen_dispatch(struct EventEmitter *, int, void *);
+static bool _eventemitter_has_patterns(struct EventEmitter *);
+static int _eventemitter_patterns_invoke(struct EventEmitter *, int, void *);
+static int _eventemitter_pattern_listeners_invoke(struct EventEmitter *, struct EventEmitterEventListeners *, int, void *);
+#ifdef EVENTEMITTER_STATS
+static void _eventemitter_stats_emit(struct EventEmitter *, struct EventEmitterEventListeners *, bool, int);
+static void _eventemitter_stats_once_removed(struct EventEmitter *, struct EventEmitterEventListeners *);
+static void _eventemitter_stats_added(struct EventEmitter *, struct EventEmitterEventListeners *);
+#endif
+#ifdef EVENTEMITTER_TRACE
+static int _eventemitter_trace_emit(struct EventEmitter *, int, void *);
+static int _eventemitter_trace_dispatch(struct EventEmitter *, struct EventEmitterEventListeners *, int, void *);
+static int _eventemitter_trace_listeners_invoke(struct EventEmitter *, struct EventEmitterEventListeners *, int, void *);
+#endif
+#ifdef EVENTEMITTER_THREADS
+static struct EventEmitterAsyncEmit *_eventemitter_emit_async(struct EventEmitter *, int, void *, void (*callback)(int, void *), void *);
+static size_t _eventemitter_async_count_records(struct EventEmitter *, struct EventEmitterEventListeners *);
+static size_t _eventemitter_async_collect_records(struct EventEmitter *, struct EventEmitterEventListeners *, struct EventEmitterAsyncEmitTask *, bool);
+static size_t _eventemitter_async_collect_patterns(struct EventEmitter *, int, struct EventEmitterAsyncEmitTask *);
+static void _eventemitter_async_emit_run(struct EventEmitterWorkerTask *);
+static void _eventemitter_async_emit_complete(struct EventEmitterAsyncEmit *);
+#endif
 
 struct EventEmitter *eventemitter_new(void)
 {
-  struct EventEmitter *event_emitter = malloc(sizeof(struct EventEmitter));
+  return(_eventemitter_new(&_eventemitter_default_allocator, 0, 0));
+}
+
+
+struct EventEmitter *eventemitter_new_with_id_range(int min_event_id, int max_event_id)
+{
+  if (max_event_id < min_event_id || (long long)max_event_id - (long long)min_event_id >= EVENTEMITTER_MAX_ID_RANGE)
+  {
+    return(NULL);
+  }
 
-  event_emitter->next_callback_id    = 1;
-  event_emitter->event_listeners     = vector_new();
-  event_emitter->unhandled_listeners = vector_new();
+  size_t range_size = (size_t)((long long)max_event_id - (long long)min_event_id) + 1;
 
-  return(event_emitter);
+  return(_eventemitter_new(&_eventemitter_default_allocator, min_event_id, range_size));
+}
+
+
+struct EventEmitter *eventemitter_new_with_allocator(const struct EventEmitterAllocator *allocator)
+{
+  if (allocator == NULL || allocator->allocate == NULL || allocator->reallocate == NULL || allocator->deallocate == NULL)
+  {
+    return(NULL);
+  }
+
+  return(_eventemitter_new(allocator, 0, 0));
 }
 
 
@@ -54,46 +154,92 @@ void eventemitter_release(struct EventEmitter *event_emitter)
     return;
   }
 
+#ifdef EVENTEMITTER_THREADS
+  _eventemitter_workers_release(event_emitter->workers);
+#endif
+  if (event_emitter->frozen != NULL)
+  {
+    _eventemitter_frozen_release(&event_emitter->allocator, event_emitter->frozen);
+    event_emitter->frozen = NULL;
+  }
   eventemitter_remove_all_listeners(event_emitter);
-  vector_release(event_emitter->event_listeners);
-  vector_release(event_emitter->unhandled_listeners);
-  free(event_emitter);
+  _eventemitter_coalescing_release(event_emitter);
+#ifdef EVENTEMITTER_THREADS
+  _eventemitter_queue_release(event_emitter);
+#endif
+  _eventemitter_pool_release(&event_emitter->payload_pool);
+  _eventemitter_map_release(&event_emitter->event_listeners);
+  _eventemitter_map_release(&event_emitter->listener_index);
+  _eventemitter_map_release(&event_emitter->mask_listeners);
+  _eventemitter_intervals_release(&event_emitter->interval_listeners);
+  _eventemitter_pool_release(&event_emitter->event_listeners_pool);
+  _eventemitter_pool_release(&event_emitter->listener_records_pool);
+#ifdef EVENTEMITTER_STATS
+  _eventemitter_map_release(&event_emitter->event_stats);
+  _eventemitter_pool_release(&event_emitter->event_stats_pool);
+#endif
+
+  // the emitter is freed with its own allocator so a copy is needed
+  struct EventEmitterAllocator allocator = event_emitter->allocator;
+  for (size_t index = 0; index < event_emitter->listener_slot_pages_count; index++)
+  {
+    allocator.deallocate(event_emitter->listener_slot_pages[index], allocator.context);
+  }
+  if (event_emitter->listener_slot_pages != NULL)
+  {
+    allocator.deallocate(event_emitter->listener_slot_pages, allocator.context);
+  }
+  if (event_emitter->range_listeners != NULL)
+  {
+    allocator.deallocate(event_emitter->range_listeners, allocator.context);
+  }
+  if (event_emitter->masks != NULL)
+  {
+    allocator.deallocate(event_emitter->masks, allocator.context);
+  }
+  allocator.deallocate(event_emitter, allocator.context);
 }
 
 
 unsigned int eventemitter_add_listener(struct EventEmitter *event_emitter, int event_id, void (*callback)(void *event_data, void *context), void *context)
 {
-  return(_eventemitter_add_listener(event_emitter, event_id, callback, context, false, false));
+  return(_eventemitter_add_listener(event_emitter, event_id, callback, context, false, false, 0));
 }
 
 
 unsigned int eventemitter_on(struct EventEmitter *event_emitter, int event_id, void (*callback)(void *event_data, void *context), void *context)
 {
-  return(_eventemitter_add_listener(event_emitter, event_id, callback, context, false, false));
+  return(_eventemitter_add_listener(event_emitter, event_id, callback, context, false, false, 0));
 }
 
 
 unsigned int eventemitter_prepend_listener(struct EventEmitter *event_emitter, int event_id, void (*callback)(void *event_data, void *context), void *context)
 {
-  return(_eventemitter_add_listener(event_emitter, event_id, callback, context, false, true));
+  return(_eventemitter_add_listener(event_emitter, event_id, callback, context, false, true, 0));
 }
 
 
 unsigned int eventemitter_add_once_listener(struct EventEmitter *event_emitter, int event_id, void (*callback)(void *event_data, void *context), void *context)
 {
-  return(_eventemitter_add_listener(event_emitter, event_id, callback, context, true, false));
+  return(_eventemitter_add_listener(event_emitter, event_id, callback, context, true, false, 0));
 }
 
 
 unsigned int eventemitter_once(struct EventEmitter *event_emitter, int event_id, void (*callback)(void *event_data, void *context), void *context)
 {
-  return(_eventemitter_add_listener(event_emitter, event_id, callback, context, true, false));
+  return(_eventemitter_add_listener(event_emitter, event_id, callback, context, true, false, 0));
 }
 
 
 unsigned int eventemitter_prepend_once_listener(struct EventEmitter *event_emitter, int event_id, void (*callback)(void *event_data, void *context), void *context)
 {
-  return(_eventemitter_add_listener(event_emitter, event_id, callback, context, true, true));
+  return(_eventemitter_add_listener(event_emitter, event_id, callback, context, true, true, 0));
+}
+
+
+unsigned int eventemitter_add_listener_with_priority(struct EventEmitter *event_emitter, int event_id, int priority, void (*callback)(void *event_data, void *context), void *context)
+{
+  return(_eventemitter_add_listener(event_emitter, event_id, callback, context, false, false, priority));
 }
 
 
@@ -115,40 +261,43 @@ unsigned int eventemitter_prepend_unhandled_listener(struct EventEmitter *event_
 }
 
 
-int eventemitter_remove_listener(struct EventEmitter *event_emitter, int event_id, unsigned int callback_id)
+unsigned int eventemitter_on_range(struct EventEmitter *event_emitter, int min_event_id, int max_event_id, void (*callback)(int event_id, void *event_data, void *context), void *context)
 {
-  if (event_emitter == NULL || !callback_id)
+  if (max_event_id < min_event_id)
   {
-    return(-1);
+    return(0);
   }
 
-  struct EventEmitterEventListeners *listeners = _eventemitter_get_listeners_for_event_id(event_emitter, event_id);
-  if (listeners == NULL)
+  return(_eventemitter_add_pattern_listener(event_emitter, EVENTEMITTER_LISTENERS_RANGE, min_event_id, max_event_id, callback, context));
+}
+
+
+unsigned int eventemitter_on_mask(struct EventEmitter *event_emitter, int mask, int value, void (*callback)(int event_id, void *event_data, void *context), void *context)
+{
+  // a value with bits outside of the mask would never match
+  if (value & ~mask)
   {
     return(0);
   }
 
-  size_t count  = vector_size(listeners->listeners);
-  int    output = 0;
-  for (size_t index = 0; index < count; index++)
-  {
-    struct EventEmitterEventListener *listener = (struct EventEmitterEventListener *)vector_get(listeners->listeners, index);
+  return(_eventemitter_add_pattern_listener(event_emitter, EVENTEMITTER_LISTENERS_MASK, value, mask, callback, context));
+}
 
-    if (listener != NULL && listener->id == callback_id)
-    {
-      free(listener);
-      vector_remove(listeners->listeners, index);
-      output = 1;
-      break;
-    }
+
+int eventemitter_remove_listener(struct EventEmitter *event_emitter, int event_id, unsigned int callback_id)
+{
+  if (event_emitter == NULL || event_emitter->frozen != NULL || !callback_id)
+  {
+    return(-1);
   }
 
-  if (vector_is_empty(listeners->listeners))
+  struct EventEmitterListenerSlot *slot = _eventemitter_map_get(&event_emitter->listener_index, callback_id);
+  if (slot == NULL || slot->listeners == &event_emitter->unhandled_listeners || slot->listeners->type != EVENTEMITTER_LISTENERS_EVENT || slot->listeners->event_id != event_id)
   {
-    eventemitter_remove_all_event_listeners(event_emitter, event_id);
+    return(0);
   }
 
-  return(output);
+  return(_eventemitter_remove_listener_in_slot(event_emitter, slot));
 }
 
 
@@ -160,286 +309,2434 @@ int eventemitter_off(struct EventEmitter *event_emitter, int event_id, unsigned
 
 int eventemitter_remove_unhandled_listener(struct EventEmitter *event_emitter, unsigned int callback_id)
 {
-  if (event_emitter == NULL || !callback_id)
+  if (event_emitter == NULL || event_emitter->frozen != NULL || !callback_id)
   {
     return(-1);
   }
 
-  size_t count  = vector_size(event_emitter->unhandled_listeners);
-  int    output = 0;
-  for (size_t index = 0; index < count; index++)
+  struct EventEmitterListenerSlot *slot = _eventemitter_map_get(&event_emitter->listener_index, callback_id);
+  if (slot == NULL || slot->listeners != &event_emitter->unhandled_listeners)
   {
-    struct EventEmitterUnhandledListener *listener = (struct EventEmitterUnhandledListener *)vector_get(event_emitter->unhandled_listeners, index);
-
-    if (listener != NULL && listener->id == callback_id)
-    {
-      free(listener);
-      vector_remove(event_emitter->unhandled_listeners, index);
-      output = 1;
-      break;
-    }
+    return(0);
   }
 
-  return(output);
+  return(_eventemitter_remove_listener_in_slot(event_emitter, slot));
 }
 
 
-bool eventemitter_remove_all_event_listeners(struct EventEmitter *event_emitter, int event_id)
+int eventemitter_remove_listener_by_id(struct EventEmitter *event_emitter, unsigned int callback_id)
 {
-  if (event_emitter == NULL)
+  if (event_emitter == NULL || event_emitter->frozen != NULL || !callback_id)
   {
-    return(false);
+    return(-1);
   }
 
-  struct EventEmitterEventListeners *listeners = _eventemitter_get_listeners_for_event_id(event_emitter, event_id);
-  if (listeners == NULL)
+  struct EventEmitterListenerSlot *slot = _eventemitter_map_get(&event_emitter->listener_index, callback_id);
+  if (slot == NULL)
   {
-    return(true);
+    return(0);
   }
 
-  size_t count = vector_size(listeners->listeners);
-  for (size_t index = 0; index < count; index++)
-  {
-    struct EventEmitterEventListener *listener = (struct EventEmitterEventListener *)vector_get(listeners->listeners, index);
+  return(_eventemitter_remove_listener_in_slot(event_emitter, slot));
+}
 
-    if (listener != NULL)
-    {
-      free(listener);
-    }
-  }
 
-  count = vector_size(event_emitter->event_listeners);
-  for (size_t index = 0; index < count; index++)
-  {
-    listeners = (struct EventEmitterEventListeners *)vector_get(event_emitter->event_listeners, index);
+uint64_t eventemitter_on_with_handle(struct EventEmitter *event_emitter, int event_id, void (*callback)(void *event_data, void *context), void *context)
+{
+  unsigned int callback_id = _eventemitter_add_listener(event_emitter, event_id, callback, context, false, false, 0);
 
-    if (listeners != NULL && listeners->event_id == event_id)
-    {
-      vector_remove(event_emitter->event_listeners, index);
-      vector_release(listeners->listeners);
-      free(listeners);
-    }
-  }
+  return(callback_id ? eventemitter_get_listener_handle(event_emitter, callback_id) : 0);
+}
 
-  return(true);
-} /* eventemitter_remove_all_event_listeners */
 
+uint64_t eventemitter_once_with_handle(struct EventEmitter *event_emitter, int event_id, void (*callback)(void *event_data, void *context), void *context)
+{
+  unsigned int callback_id = _eventemitter_add_listener(event_emitter, event_id, callback, context, true, false, 0);
 
-bool eventemitter_remove_all_unhandled_listeners(struct EventEmitter *event_emitter)
+  return(callback_id ? eventemitter_get_listener_handle(event_emitter, callback_id) : 0);
+}
+
+
+int eventemitter_remove_listener_by_handle(struct EventEmitter *event_emitter, uint64_t handle)
 {
-  if (event_emitter == NULL)
+  if (event_emitter == NULL || event_emitter->frozen != NULL || !handle)
   {
-    return(false);
+    return(-1);
   }
 
-  size_t count = vector_size(event_emitter->unhandled_listeners);
-  for (size_t index = 0; index < count; index++)
+  struct EventEmitterListenerSlot *slot = _eventemitter_get_slot_for_handle(event_emitter, handle);
+  if (slot == NULL)
   {
-    struct EventEmitterUnhandledListener *listener = (struct EventEmitterUnhandledListener *)vector_get(event_emitter->unhandled_listeners, index);
-
-    if (listener != NULL)
-    {
-      free(listener);
-    }
+    return(0);
   }
-  vector_clear(event_emitter->unhandled_listeners);
 
-  return(true);
+  return(_eventemitter_remove_listener_in_slot(event_emitter, slot));
 }
 
 
-bool eventemitter_remove_all_listeners(struct EventEmitter *event_emitter)
+uint64_t eventemitter_get_listener_handle(struct EventEmitter *event_emitter, unsigned int callback_id)
 {
-  if (event_emitter == NULL)
+  if (event_emitter == NULL || !callback_id)
   {
-    return(false);
+    return(0);
   }
 
-  while (!vector_is_empty(event_emitter->event_listeners))
+  struct EventEmitterListenerSlot *slot = _eventemitter_map_get(&event_emitter->listener_index, callback_id);
+  if (slot == NULL)
   {
-    struct EventEmitterEventListeners *listeners = (struct EventEmitterEventListeners *)vector_get(event_emitter->event_listeners, 0);
-
-    if (listeners != NULL)
-    {
-      eventemitter_remove_all_event_listeners(event_emitter, listeners->event_id);
-    }
-    else
-    {
-      vector_remove(event_emitter->event_listeners, 0);
-    }
+    return(0);
   }
 
-  eventemitter_remove_all_unhandled_listeners(event_emitter);
-
-  return(true);
+  return(_eventemitter_slot_handle(slot));
 }
 
 
-int eventemitter_listeners_count(struct EventEmitter *event_emitter, int event_id)
+unsigned int eventemitter_get_listener_id(struct EventEmitter *event_emitter, uint64_t handle)
 {
-  if (event_emitter == NULL)
+  if (event_emitter == NULL || !handle)
   {
-    return(-1);
+    return(0);
   }
 
-  struct EventEmitterEventListeners *listeners = _eventemitter_get_listeners_for_event_id(event_emitter, event_id);
-  if (listeners == NULL)
+  struct EventEmitterListenerSlot *slot = _eventemitter_get_slot_for_handle(event_emitter, handle);
+  if (slot == NULL)
   {
     return(0);
   }
 
-  return((int)vector_size(listeners->listeners));
+  return(slot->listeners->listeners[slot->position].id);
 }
 
 
-int eventemitter_emit(struct EventEmitter *event_emitter, int event_id, void *event_data)
+bool eventemitter_add_listeners(struct EventEmitter *event_emitter, const struct EventEmitterListenerSpec *specs, size_t count, unsigned int *callback_ids)
 {
-  if (event_emitter == NULL)
+  if (event_emitter == NULL || event_emitter->frozen != NULL || (count && specs == NULL) || count > SIZE_MAX / (sizeof(struct EventEmitterEventListener) + sizeof(struct EventEmitterEventListeners *) + 2 * sizeof(bool)))
   {
-    return(-1);
+    return(false);
+  }
+  for (size_t index = 0; index < count; index++)
+  {
+    if (specs[index].callback == NULL)
+    {
+      return(false);
+    }
+  }
+  if (!count)
+  {
+    return(true);
   }
 
-  int                               callback_counter = 0;
-  struct EventEmitterEventListeners *listeners       = _eventemitter_get_listeners_for_event_id(event_emitter, event_id);
-  if (listeners != NULL)
+  // the new records are built before any listeners array is changed, the targets are kept after them
+  // with which of them this call created or took back from the retained listeners, for the roll back
+  struct EventEmitterEventListener *records = event_emitter->allocator.allocate(count * (sizeof(struct EventEmitterEventListener) + sizeof(struct EventEmitterEventListeners *) + 2 * sizeof(bool)), event_emitter->allocator.context);
+  if (records == NULL)
   {
-    size_t count = vector_size(listeners->listeners);
-    for (size_t index = 0; index < count; index++)
+    return(false);
+  }
+  struct EventEmitterEventListeners **targets = (struct EventEmitterEventListeners **)(void *)(records + count);
+  bool                              *created  = (bool *)(void *)(targets + count);
+  bool                              *reused   = created + count;
+
+  // resolve the listeners of each spec and count the new listeners of each event
+  size_t resolved = 0;
+  bool   done     = _eventemitter_map_reserve(&event_emitter->listener_index, event_emitter->listener_index.size + count);
+  for ( ; resolved < count && done; resolved++)
+  {
+    struct EventEmitterEventListeners *existing = _eventemitter_get_listeners_for_event_id(event_emitter, specs[resolved].event_id);
+    created[resolved] = existing == NULL;
+    reused[resolved]  = existing != NULL && existing->retained;
+
+    targets[resolved] = _eventemitter_get_or_create_listeners(event_emitter, specs[resolved].event_id);
+    done              = targets[resolved] != NULL;
+    if (done)
     {
-      struct EventEmitterEventListener *listener = (struct EventEmitterEventListener *)vector_get(listeners->listeners, index);
+      targets[resolved]->pending++;
+    }
+  }
 
-      if (listener != NULL)
-      {
-        listener->callback(event_data, listener->context);
-        callback_counter++;
-      }
+  // each listeners array is grown once, and sorted once if listeners are prepended to it
+  for (size_t index = 0; index < resolved; index++)
+  {
+    if (targets[index] != NULL && targets[index]->pending)
+    {
+      done                    = done && _eventemitter_listeners_reserve(event_emitter, targets[index], targets[index]->count + targets[index]->pending);
+      targets[index]->pending = 0;
+    }
+    if (done && specs[index].prepend && targets[index]->unsorted && !targets[index]->dispatching)
+    {
+      _eventemitter_listeners_sort(event_emitter, targets[index]);
     }
+  }
 
-    // remove 'once' listeners
-    for (size_t index = 0; index < count; index++)
+  size_t indexed = 0;
+  while (indexed < count && done)
+  {
+    records[indexed].callback.event = specs[indexed].callback;
+    records[indexed].context        = specs[indexed].context;
+    records[indexed].id             = _eventemitter_next_callback_id(event_emitter);
+    records[indexed].priority       = 0;
+    records[indexed].once           = specs[indexed].once;
+    records[indexed].prepend        = specs[indexed].prepend;
+
+    done = _eventemitter_index_record(event_emitter, &records[indexed]);
+    if (done)
     {
-      size_t                           end_index = count - 1 - index;
-      struct EventEmitterEventListener *listener = (struct EventEmitterEventListener *)vector_get(listeners->listeners, end_index);
+      event_emitter->next_callback_id++;
+      indexed++;
+    }
+  }
 
-      if (listener != NULL && listener->once)
+  if (!done)
+  {
+    // roll back, no listeners array was changed yet
+    for (size_t index = 0; index < indexed; index++)
+    {
+      _eventemitter_release_slot(event_emitter, &records[index]);
+    }
+    for (size_t index = 0; index < resolved; index++)
+    {
+      if (targets[index] != NULL && created[index])
+      {
+        _eventemitter_detach_listeners(event_emitter, targets[index]);
+      }
+      else if (targets[index] != NULL && reused[index])
       {
-        free(listener);
-        vector_remove(listeners->listeners, end_index);
+        targets[index]->retained = true;
+        event_emitter->retained_listeners++;
       }
     }
-    if (vector_is_empty(listeners->listeners))
+
+    event_emitter->allocator.deallocate(records, event_emitter->allocator.context);
+
+    return(false);
+  }
+
+  // the records of each event are staged at its end in spec order, then placed once per event
+  for (size_t index = 0; index < count; index++)
+  {
+    if (callback_ids != NULL)
     {
-      eventemitter_remove_all_event_listeners(event_emitter, event_id);
+      callback_ids[index] = records[index].id;
     }
+    targets[index]->listeners[targets[index]->count] = records[index];
+    targets[index]->count++;
+    targets[index]->pending++;
   }
-  else
+  for (size_t index = 0; index < count; index++)
   {
-    size_t count = vector_size(event_emitter->unhandled_listeners);
-    for (size_t index = 0; index < count; index++)
+    if (targets[index]->pending)
     {
-      struct EventEmitterUnhandledListener *listener = (struct EventEmitterUnhandledListener *)vector_get(event_emitter->unhandled_listeners, index);
-
-      if (listener != NULL)
-      {
-        listener->callback(event_id, event_data, listener->context);
-        callback_counter++;
-      }
+      _eventemitter_listeners_insert_staged(event_emitter, targets[index], records);
+      targets[index]->pending = 0;
+#ifdef EVENTEMITTER_STATS
+      _eventemitter_stats_added(event_emitter, targets[index]);
+#endif
     }
   }
 
-  return(callback_counter);
-} /* eventemitter_emit */
+  event_emitter->allocator.deallocate(records, event_emitter->allocator.context);
 
-static struct EventEmitterEventListeners *_eventemitter_get_listeners_for_event_id(struct EventEmitter *event_emitter, int event_id)
+  return(true);
+} /* eventemitter_add_listeners */
+
+
+int eventemitter_remove_listeners(struct EventEmitter *event_emitter, const unsigned int *callback_ids, size_t count)
 {
-  if (event_emitter == NULL)
+  if (event_emitter == NULL || event_emitter->frozen != NULL || (count && callback_ids == NULL))
   {
-    return(NULL);
+    return(-1);
   }
 
-  size_t count = vector_size(event_emitter->event_listeners);
+  // compaction is amortized over the removals, so the records are moved a constant amount of times per removal
+  size_t removed = 0;
   for (size_t index = 0; index < count; index++)
   {
-    struct EventEmitterEventListeners *listeners = (struct EventEmitterEventListeners *)vector_get(event_emitter->event_listeners, index);
-
-    if (listeners != NULL && listeners->event_id == event_id)
+    struct EventEmitterListenerSlot *slot = callback_ids[index] ? _eventemitter_map_get(&event_emitter->listener_index, callback_ids[index]) : NULL;
+    if (slot != NULL)
     {
-      return(listeners);
+      removed = removed + (size_t)_eventemitter_remove_listener_in_slot(event_emitter, slot);
     }
   }
 
-  return(NULL);
+  return(removed > INT_MAX ? INT_MAX : (int)removed);
 }
 
 
-static unsigned int _eventemitter_add_listener(struct EventEmitter *event_emitter, int event_id, void (*callback)(void *event_data, void *context), void *context, bool once, bool prepend)
+bool eventemitter_remove_all_event_listeners(struct EventEmitter *event_emitter, int event_id)
 {
-  if (event_emitter == NULL || callback == NULL)
+  if (event_emitter == NULL || event_emitter->frozen != NULL)
   {
-    return(0);
+    return(false);
   }
 
   struct EventEmitterEventListeners *listeners = _eventemitter_get_listeners_for_event_id(event_emitter, event_id);
   if (listeners == NULL)
   {
-    listeners            = malloc(sizeof(struct EventEmitterEventListeners));
-    listeners->event_id  = event_id;
-    listeners->listeners = vector_new();
-    vector_push(event_emitter->event_listeners, listeners);
+    return(true);
   }
 
-  // allocate next id for listener
-  unsigned int callback_id = event_emitter->next_callback_id;
-  event_emitter->next_callback_id++;
+  _eventemitter_set_listeners_for_event_id(event_emitter, event_id, NULL);
+  _eventemitter_release_listeners(event_emitter, listeners);
 
-  // create listener wrapper
-  struct EventEmitterEventListener *listener = malloc(sizeof(struct EventEmitterEventListener));
-  listener->id       = callback_id;
-  listener->callback = callback;
-  listener->context  = context;
-  listener->once     = once;
+  return(true);
+}
 
-  // keep in event listeners list
-  if (prepend)
+
+bool eventemitter_remove_all_unhandled_listeners(struct EventEmitter *event_emitter)
+{
+  if (event_emitter == NULL || event_emitter->frozen != NULL)
   {
-    vector_prepend(listeners->listeners, listener);
+    return(false);
   }
-  else
+
+  struct EventEmitterEventListeners *listeners = &event_emitter->unhandled_listeners;
+  _eventemitter_listeners_release_records(event_emitter, listeners);
+  if (!listeners->dispatching)
   {
-    vector_push(listeners->listeners, listener);
+    _eventemitter_listeners_clear(event_emitter, listeners);
   }
 
-  return(callback_id);
+  return(true);
 }
 
 
-static unsigned int _eventemitter_add_unhandled_listener(struct EventEmitter *event_emitter, void (*callback)(int, void *, void *), void *context, bool prepend)
+bool eventemitter_remove_all_listeners(struct EventEmitter *event_emitter)
 {
-  if (event_emitter == NULL || callback == NULL)
+  if (event_emitter == NULL || event_emitter->frozen != NULL)
   {
-    return(0);
+    return(false);
   }
 
-  // allocate next id for listener
-  unsigned int callback_id = event_emitter->next_callback_id;
-  event_emitter->next_callback_id++;
+  struct EventEmitterMap *map = &event_emitter->event_listeners;
+  for (size_t index = 0; index < map->capacity; index++)
+  {
+    if (map->entries[index].value != NULL)
+    {
+      _eventemitter_release_listeners(event_emitter, (struct EventEmitterEventListeners *)map->entries[index].value);
+    }
+  }
+  _eventemitter_map_clear(map);
+
+  for (size_t index = 0; index < event_emitter->range_size; index++)
+  {
+    if (event_emitter->range_listeners[index] != NULL)
+    {
+      _eventemitter_release_listeners(event_emitter, event_emitter->range_listeners[index]);
+      event_emitter->range_listeners[index] = NULL;
+    }
+  }
 
-  // create listener wrapper
-  struct EventEmitterUnhandledListener *listener = malloc(sizeof(struct EventEmitterUnhandledListener));
-  listener->id       = callback_id;
-  listener->callback = callback;
-  listener->context  = context;
+  for (size_t index = 0; index < event_emitter->interval_listeners.count; index++)
+  {
+    _eventemitter_release_listeners(event_emitter, (struct EventEmitterEventListeners *)event_emitter->interval_listeners.entries[index].value);
+  }
+  _eventemitter_intervals_clear(&event_emitter->interval_listeners);
 
-  // keep in event listeners list
-  if (prepend)
+  map = &event_emitter->mask_listeners;
+  for (size_t index = 0; index < map->capacity; index++)
   {
-    vector_prepend(event_emitter->unhandled_listeners, listener);
+    if (map->entries[index].value != NULL)
+    {
+      _eventemitter_release_listeners(event_emitter, (struct EventEmitterEventListeners *)map->entries[index].value);
+    }
   }
-  else
+  _eventemitter_map_clear(map);
+  for (size_t index = 0; index < event_emitter->masks_count; index++)
+  {
+    event_emitter->masks[index].listeners = 0;
+  }
+  if (!event_emitter->masks_dispatching)
+  {
+    _eventemitter_masks_compact(event_emitter);
+  }
+
+  eventemitter_remove_all_unhandled_listeners(event_emitter);
+
+  return(true);
+}
+
+
+bool eventemitter_set_retention(struct EventEmitter *event_emitter, size_t max_retained_events)
+{
+  if (event_emitter == NULL)
+  {
+    return(false);
+  }
+
+  event_emitter->max_retained_listeners = max_retained_events;
+  if (event_emitter->retained_listeners > max_retained_events)
   {
-    vector_push(event_emitter->unhandled_listeners, listener);
+    eventemitter_compact(event_emitter);
   }
 
-  return(callback_id);
+  return(true);
 }
 
+
+int eventemitter_compact(struct EventEmitter *event_emitter)
+{
+  if (event_emitter == NULL)
+  {
+    return(-1);
+  }
+
+  size_t released = 0;
+  for (size_t index = 0; index < event_emitter->range_size && event_emitter->retained_listeners; index++)
+  {
+    struct EventEmitterEventListeners *listeners = event_emitter->range_listeners[index];
+    if (listeners != NULL && listeners->retained)
+    {
+      event_emitter->range_listeners[index] = NULL;
+      _eventemitter_release_listeners(event_emitter, listeners);
+      released++;
+    }
+  }
+
+  // removal shifts the following entries back, so the same index is checked again after each removal
+  struct EventEmitterMap *map  = &event_emitter->event_listeners;
+  size_t                 index = 0;
+  while (index < map->capacity && event_emitter->retained_listeners)
+  {
+    struct EventEmitterEventListeners *listeners = map->entries[index].value;
+    if (listeners != NULL && listeners->retained)
+    {
+      _eventemitter_map_remove(map, map->entries[index].key);
+      _eventemitter_release_listeners(event_emitter, listeners);
+      released++;
+    }
+    else
+    {
+      index++;
+    }
+  }
+
+  // the slabs left without used chunks go back to the allocator
+  _eventemitter_pool_trim(&event_emitter->event_listeners_pool);
+  _eventemitter_pool_trim(&event_emitter->listener_records_pool);
+
+  return(released > INT_MAX ? INT_MAX : (int)released);
+} /* eventemitter_compact */
+
+
+int eventemitter_listeners_count(struct EventEmitter *event_emitter, int event_id)
+{
+  if (event_emitter == NULL)
+  {
+    return(-1);
+  }
+
+  struct EventEmitterEventListeners *listeners = _eventemitter_get_listeners_for_event_id(event_emitter, event_id);
+  if (listeners == NULL)
+  {
+    return(0);
+  }
+
+  return((int)(listeners->count - listeners->removed));
+}
+
+
+int eventemitter_emit(struct EventEmitter *event_emitter, int event_id, void *event_data)
+{
+  if (event_emitter == NULL)
+  {
+    return(-1);
+  }
+
+  if (event_emitter->frozen != NULL)
+  {
+    return(_eventemitter_frozen_dispatch(event_emitter, event_id, event_data));
+  }
+
+#ifdef EVENTEMITTER_TRACE
+  // the only cost of tracing while no hooks are set
+  if (event_emitter->tracing)
+  {
+    return(_eventemitter_trace_emit(event_emitter, event_id, event_data));
+  }
+#endif
+
+  int                               callback_counter = 0;
+  struct EventEmitterEventListeners *listeners       = _eventemitter_get_listeners_for_event_id(event_emitter, event_id);
+  if (listeners != NULL && listeners->count > listeners->removed)
+  {
+    // changes done by the callbacks to this event are deferred until the outermost emit is done
+    listeners->dispatching++;
+    callback_counter = _eventemitter_listeners_invoke(event_emitter, listeners, event_data);
+
+    // range and mask listeners are invoked after the listeners of the exact event ID, which stay pinned for the stats
+    if (_eventemitter_has_patterns(event_emitter))
+    {
+      callback_counter = callback_counter + _eventemitter_patterns_invoke(event_emitter, event_id, event_data);
+    }
+#ifdef EVENTEMITTER_STATS
+    _eventemitter_stats_emit(event_emitter, listeners, true, callback_counter);
+#endif
+    _eventemitter_listeners_unpin(event_emitter, listeners);
+  }
+  else
+  {
+    if (_eventemitter_has_patterns(event_emitter))
+    {
+      callback_counter = _eventemitter_patterns_invoke(event_emitter, event_id, event_data);
+      if (callback_counter)
+      {
+#ifdef EVENTEMITTER_STATS
+        _eventemitter_stats_emit(event_emitter, NULL, true, callback_counter);
+#endif
+        return(callback_counter);
+      }
+    }
+
+#ifdef EVENTEMITTER_STATS
+    _eventemitter_stats_emit(event_emitter, listeners, false, 0);
+#endif
+    listeners = &event_emitter->unhandled_listeners;
+
+    listeners->dispatching++;
+    callback_counter = _eventemitter_unhandled_listeners_invoke(listeners, event_id, event_data);
+    _eventemitter_listeners_unpin(event_emitter, listeners);
+  }
+
+  return(callback_counter);
+}
+
+
+int eventemitter_emit_batch(struct EventEmitter *event_emitter, const int *event_ids, void **event_data, size_t count)
+{
+  if (event_emitter == NULL || (count && event_ids == NULL))
+  {
+    return(-1);
+  }
+
+  if (event_emitter->frozen != NULL)
+  {
+    size_t frozen_counter = 0;
+    for (size_t index = 0; index < count; index++)
+    {
+      frozen_counter = frozen_counter + (size_t)_eventemitter_frozen_dispatch(event_emitter, event_ids[index], event_data != NULL ? event_data[index] : NULL);
+    }
+
+    return(frozen_counter > INT_MAX ? INT_MAX : (int)frozen_counter);
+  }
+
+  // recently resolved listeners by event ID, so repeated IDs skip the lookup.
+  // cached listeners stay pinned until evicted or the batch is done, so callbacks can not free them
+  // and their removed records (including invoked 'once' listeners) are cleaned up once.
+  // detached or empty cached listeners are looked up again, as callbacks may have added new listeners for the event.
+  struct EventEmitterEventListeners *cache[EVENTEMITTER_BATCH_CACHE_SIZE] = { NULL };
+  struct EventEmitterEventListeners *unhandled_listeners                  = &event_emitter->unhandled_listeners;
+  size_t                            callback_counter                      = 0;
+
+  unhandled_listeners->dispatching++;
+  for (size_t index = 0; index < count; index++)
+  {
+    int                               event_id   = event_ids[index];
+    void                              *data      = event_data != NULL ? event_data[index] : NULL;
+    size_t                            position   = (unsigned int)event_id % EVENTEMITTER_BATCH_CACHE_SIZE;
+    struct EventEmitterEventListeners *listeners = cache[position];
+
+    if (listeners == NULL || listeners->event_id != event_id || listeners->detached || listeners->count == listeners->removed)
+    {
+      listeners = _eventemitter_get_listeners_for_event_id(event_emitter, event_id);
+      if (listeners != NULL && listeners != cache[position])
+      {
+        listeners->dispatching++;
+        if (cache[position] != NULL)
+        {
+          _eventemitter_listeners_unpin(event_emitter, cache[position]);
+        }
+        cache[position] = listeners;
+      }
+    }
+
+#ifdef EVENTEMITTER_TRACE
+    if (event_emitter->tracing)
+    {
+      callback_counter = callback_counter + (size_t)_eventemitter_trace_dispatch(event_emitter, listeners, event_id, data);
+      continue;
+    }
+#endif
+
+    if (listeners != NULL && listeners->count > listeners->removed)
+    {
+      int invoked = _eventemitter_listeners_invoke(event_emitter, listeners, data);
+      if (_eventemitter_has_patterns(event_emitter))
+      {
+        invoked = invoked + _eventemitter_patterns_invoke(event_emitter, event_id, data);
+      }
+#ifdef EVENTEMITTER_STATS
+      _eventemitter_stats_emit(event_emitter, listeners, true, invoked);
+#endif
+      callback_counter = callback_counter + (size_t)invoked;
+    }
+    else
+    {
+      int invoked = _eventemitter_has_patterns(event_emitter) ? _eventemitter_patterns_invoke(event_emitter, event_id, data) : 0;
+      if (invoked)
+      {
+#ifdef EVENTEMITTER_STATS
+        _eventemitter_stats_emit(event_emitter, NULL, true, invoked);
+#endif
+        callback_counter = callback_counter + (size_t)invoked;
+        continue;
+      }
+
+#ifdef EVENTEMITTER_STATS
+      _eventemitter_stats_emit(event_emitter, listeners, false, 0);
+#endif
+      callback_counter = callback_counter + (size_t)_eventemitter_unhandled_listeners_invoke(unhandled_listeners, event_id, data);
+    }
+  }
+
+  for (size_t index = 0; index < EVENTEMITTER_BATCH_CACHE_SIZE; index++)
+  {
+    if (cache[index] != NULL)
+    {
+      _eventemitter_listeners_unpin(event_emitter, cache[index]);
+    }
+  }
+  _eventemitter_listeners_unpin(event_emitter, unhandled_listeners);
+
+  return(callback_counter > INT_MAX ? INT_MAX : (int)callback_counter);
+} /* eventemitter_emit_batch */
+
+
+bool eventemitter_freeze(struct EventEmitter *event_emitter)
+{
+  if (event_emitter == NULL)
+  {
+    return(false);
+  }
+  if (event_emitter->frozen != NULL)
+  {
+    return(true);
+  }
+  if (_eventemitter_has_patterns(event_emitter) || event_emitter->unhandled_listeners.dispatching)
+  {
+    return(false);
+  }
+
+  size_t                            capacity   = event_emitter->event_listeners.size + event_emitter->range_size;
+  struct EventEmitterEventListeners **listeners = event_emitter->allocator.allocate((capacity + 1) * sizeof(struct EventEmitterEventListeners *), event_emitter->allocator.context);
+  if (listeners == NULL)
+  {
+    return(false);
+  }
+
+  size_t count = 0;
+  bool   done  = true;
+  for (size_t index = 0; index < event_emitter->event_listeners.capacity && done; index++)
+  {
+    done = _eventemitter_freeze_collect(event_emitter, event_emitter->event_listeners.entries[index].value, listeners, &count);
+  }
+  for (size_t index = 0; index < event_emitter->range_size && done; index++)
+  {
+    done = _eventemitter_freeze_collect(event_emitter, event_emitter->range_listeners[index], listeners, &count);
+  }
+
+  if (done)
+  {
+    event_emitter->frozen = _eventemitter_frozen_new(&event_emitter->allocator, listeners, count, &event_emitter->unhandled_listeners);
+    done                  = event_emitter->frozen != NULL;
+  }
+  event_emitter->allocator.deallocate(listeners, event_emitter->allocator.context);
+
+  return(done);
+} /* eventemitter_freeze */
+
+
+bool eventemitter_is_frozen(struct EventEmitter *event_emitter)
+{
+  return(event_emitter != NULL && event_emitter->frozen != NULL);
+}
+
+#ifdef EVENTEMITTER_TRACE
+
+
+bool eventemitter_set_trace_hooks(struct EventEmitter *event_emitter, const struct EventEmitterTraceHooks *hooks)
+{
+  if (event_emitter == NULL)
+  {
+    return(false);
+  }
+
+  if (hooks == NULL)
+  {
+    memset(&event_emitter->trace_hooks, 0, sizeof(struct EventEmitterTraceHooks));
+    event_emitter->tracing = false;
+  }
+  else
+  {
+    event_emitter->trace_hooks = *hooks;
+    event_emitter->tracing     = true;
+  }
+
+  return(true);
+}
+
+#endif
+
+#ifdef EVENTEMITTER_THREADS
+
+
+bool eventemitter_start_workers(struct EventEmitter *event_emitter, size_t worker_count)
+{
+  if (event_emitter == NULL || !worker_count || event_emitter->workers != NULL)
+  {
+    return(false);
+  }
+
+  event_emitter->workers = _eventemitter_workers_new(&event_emitter->allocator, worker_count);
+
+  return(event_emitter->workers != NULL);
+}
+
+
+struct EventEmitterAsyncEmit *eventemitter_emit_async(struct EventEmitter *event_emitter, int event_id, void *event_data)
+{
+  return(_eventemitter_emit_async(event_emitter, event_id, event_data, NULL, NULL));
+}
+
+
+bool eventemitter_emit_async_with_callback(struct EventEmitter *event_emitter, int event_id, void *event_data, void (*callback)(int callback_counter, void *context), void *context)
+{
+  if (callback == NULL)
+  {
+    return(false);
+  }
+
+  return(_eventemitter_emit_async(event_emitter, event_id, event_data, callback, context) != NULL);
+}
+
+
+int eventemitter_wait_async_emit(struct EventEmitterAsyncEmit *async_emit)
+{
+  if (async_emit == NULL)
+  {
+    return(-1);
+  }
+
+  _eventemitter_workers_wait(async_emit->workers, &async_emit->done);
+
+  int callback_counter = async_emit->callback_counter;
+  async_emit->allocator.deallocate(async_emit, async_emit->allocator.context);
+
+  return(callback_counter);
+}
+
+#endif
+
+static struct EventEmitter *_eventemitter_new(const struct EventEmitterAllocator *allocator, int range_min, size_t range_size)
+{
+  struct EventEmitter *event_emitter = allocator->allocate(sizeof(struct EventEmitter), allocator->context);
+
+  if (event_emitter == NULL)
+  {
+    return(NULL);
+  }
+
+  event_emitter->allocator                 = *allocator;
+  event_emitter->next_callback_id          = 1;
+  event_emitter->callback_ids_wrapped      = false;
+  event_emitter->range_listeners           = NULL;
+  event_emitter->range_min                 = range_min;
+  event_emitter->range_size                = range_size;
+  event_emitter->listener_slot_pages       = NULL;
+  event_emitter->listener_slot_pages_count = 0;
+  event_emitter->listener_slots_count      = 0;
+  event_emitter->free_listener_slot        = SIZE_MAX;
+  event_emitter->retained_listeners        = 0;
+  event_emitter->max_retained_listeners    = 0;
+  event_emitter->queue                     = NULL;
+  event_emitter->coalescing                = NULL;
+  event_emitter->workers                   = NULL;
+  event_emitter->frozen                    = NULL;
+  event_emitter->masks                     = NULL;
+  event_emitter->masks_count               = 0;
+  event_emitter->masks_capacity            = 0;
+  event_emitter->masks_dispatching         = 0;
+  // the masks map is created with the first mask listener
+  memset(&event_emitter->mask_listeners, 0, sizeof(struct EventEmitterMap));
+  _eventemitter_intervals_init(&event_emitter->interval_listeners, &event_emitter->allocator);
+#ifdef EVENTEMITTER_TRACE
+  memset(&event_emitter->trace_hooks, 0, sizeof(struct EventEmitterTraceHooks));
+  event_emitter->tracing = false;
+#endif
+#ifdef EVENTEMITTER_STATS
+  memset(&event_emitter->stats, 0, sizeof(struct EventEmitterStats));
+  _eventemitter_pool_init(&event_emitter->event_stats_pool, &event_emitter->allocator, sizeof(struct EventEmitterStats), EVENTEMITTER_POOL_CHUNKS_PER_SLAB);
+  if (!_eventemitter_map_init(&event_emitter->event_stats, &event_emitter->allocator, 0))
+  {
+    allocator->deallocate(event_emitter, allocator->context);
+    return(NULL);
+  }
+#endif
+  if (range_size)
+  {
+    if (range_size > SIZE_MAX / sizeof(struct EventEmitterEventListeners *))
+    {
+#ifdef EVENTEMITTER_STATS
+      _eventemitter_map_release(&event_emitter->event_stats);
+#endif
+      allocator->deallocate(event_emitter, allocator->context);
+      return(NULL);
+    }
+
+    event_emitter->range_listeners = allocator->allocate(range_size * sizeof(struct EventEmitterEventListeners *), allocator->context);
+    if (event_emitter->range_listeners == NULL)
+    {
+#ifdef EVENTEMITTER_STATS
+      _eventemitter_map_release(&event_emitter->event_stats);
+#endif
+      allocator->deallocate(event_emitter, allocator->context);
+      return(NULL);
+    }
+    memset(event_emitter->range_listeners, 0, range_size * sizeof(struct EventEmitterEventListeners *));
+  }
+
+  _eventemitter_pool_init(&event_emitter->event_listeners_pool, &event_emitter->allocator, sizeof(struct EventEmitterEventListeners), EVENTEMITTER_POOL_CHUNKS_PER_SLAB);
+  _eventemitter_pool_init(&event_emitter->listener_records_pool, &event_emitter->allocator, EVENTEMITTER_LISTENERS_INITIAL_CAPACITY * sizeof(struct EventEmitterEventListener), EVENTEMITTER_POOL_CHUNKS_PER_SLAB);
+  _eventemitter_pool_init(&event_emitter->payload_pool, &event_emitter->allocator, EVENTEMITTER_PAYLOAD_CHUNK_SIZE, EVENTEMITTER_POOL_CHUNKS_PER_SLAB);
+#ifdef EVENTEMITTER_THREADS
+  atomic_flag_clear(&event_emitter->payload_pool_lock);
+#endif
+  _eventemitter_listeners_init(&event_emitter->unhandled_listeners, 0);
+  bool initialized = _eventemitter_map_init(&event_emitter->event_listeners, &event_emitter->allocator, 0);
+  initialized = _eventemitter_map_init(&event_emitter->listener_index, &event_emitter->allocator, 0) && initialized;
+  if (!initialized)
+  {
+    eventemitter_release(event_emitter);
+    return(NULL);
+  }
+
+  return(event_emitter);
+} /* _eventemitter_new */
+
+
+static uint64_t _eventemitter_event_key(int event_id)
+{
+  return((uint64_t)(unsigned int)event_id);
+}
+
+
+static struct EventEmitterEventListeners *_eventemitter_get_listeners_for_event_id(struct EventEmitter *event_emitter, int event_id)
+{
+  if (event_emitter == NULL)
+  {
+    return(NULL);
+  }
+
+  // event IDs below the range wrap around to large offsets so a single check covers both bounds
+  size_t offset = (size_t)((unsigned int)event_id - (unsigned int)event_emitter->range_min);
+  if (offset < event_emitter->range_size)
+  {
+    return(event_emitter->range_listeners[offset]);
+  }
+
+  return((struct EventEmitterEventListeners *)_eventemitter_map_get(&event_emitter->event_listeners, _eventemitter_event_key(event_id)));
+}
+
+
+static bool _eventemitter_set_listeners_for_event_id(struct EventEmitter *event_emitter, int event_id, struct EventEmitterEventListeners *listeners)
+{
+  size_t offset = (size_t)((unsigned int)event_id - (unsigned int)event_emitter->range_min);
+
+  if (offset < event_emitter->range_size)
+  {
+    event_emitter->range_listeners[offset] = listeners;
+    return(true);
+  }
+
+  if (listeners == NULL)
+  {
+    _eventemitter_map_remove(&event_emitter->event_listeners, _eventemitter_event_key(event_id));
+    return(true);
+  }
+
+  return(_eventemitter_map_put(&event_emitter->event_listeners, _eventemitter_event_key(event_id), listeners));
+}
+
+
+static struct EventEmitterEventListeners *_eventemitter_get_or_create_listeners(struct EventEmitter *event_emitter, int event_id)
+{
+  struct EventEmitterEventListeners *listeners = _eventemitter_get_listeners_for_event_id(event_emitter, event_id);
+
+  if (listeners != NULL && listeners->retained)
+  {
+    listeners->retained = false;
+    event_emitter->retained_listeners--;
+  }
+  else if (listeners == NULL)
+  {
+    listeners = _eventemitter_pool_alloc(&event_emitter->event_listeners_pool);
+    if (listeners == NULL)
+    {
+      return(NULL);
+    }
+    _eventemitter_listeners_init(listeners, event_id);
+#ifdef EVENTEMITTER_STATS
+    listeners->stats = _eventemitter_stats_for_event_id(event_emitter, event_id);
+    if (listeners->stats == NULL)
+    {
+      _eventemitter_pool_free(&event_emitter->event_listeners_pool, listeners);
+      return(NULL);
+    }
+#endif
+    if (!_eventemitter_set_listeners_for_event_id(event_emitter, event_id, listeners))
+    {
+      _eventemitter_pool_free(&event_emitter->event_listeners_pool, listeners);
+      return(NULL);
+    }
+  }
+
+  return(listeners);
+}
+
+
+static void _eventemitter_release_listeners(struct EventEmitter *event_emitter, struct EventEmitterEventListeners *listeners)
+{
+  if (listeners->retained)
+  {
+    listeners->retained = false;
+    event_emitter->retained_listeners--;
+  }
+  _eventemitter_listeners_release_records(event_emitter, listeners);
+
+  // listeners being dispatched are freed by the emit once done
+  if (listeners->dispatching)
+  {
+    listeners->detached = true;
+  }
+  else
+  {
+    _eventemitter_listeners_clear(event_emitter, listeners);
+    _eventemitter_pool_free(&event_emitter->event_listeners_pool, listeners);
+  }
+}
+
+
+static void _eventemitter_detach_listeners(struct EventEmitter *event_emitter, struct EventEmitterEventListeners *listeners)
+{
+  // the listeners may have been detached already, in which case they are only released
+  if (listeners->type == EVENTEMITTER_LISTENERS_RANGE)
+  {
+    if (_eventemitter_intervals_get(&event_emitter->interval_listeners, listeners->event_id, listeners->pattern.max_event_id) == listeners)
+    {
+      _eventemitter_intervals_remove(&event_emitter->interval_listeners, listeners->event_id, listeners->pattern.max_event_id);
+    }
+  }
+  else if (listeners->type == EVENTEMITTER_LISTENERS_MASK)
+  {
+    uint64_t key = _eventemitter_mask_key(listeners->pattern.mask, listeners->event_id);
+    if (_eventemitter_map_get(&event_emitter->mask_listeners, key) == listeners)
+    {
+      _eventemitter_map_remove(&event_emitter->mask_listeners, key);
+      _eventemitter_masks_release(event_emitter, listeners->pattern.mask);
+    }
+  }
+  else if (_eventemitter_get_listeners_for_event_id(event_emitter, listeners->event_id) == listeners)
+  {
+    _eventemitter_set_listeners_for_event_id(event_emitter, listeners->event_id, NULL);
+  }
+
+  _eventemitter_release_listeners(event_emitter, listeners);
+}
+
+
+static void _eventemitter_release_empty_listeners(struct EventEmitter *event_emitter, struct EventEmitterEventListeners *listeners)
+{
+  if (listeners == &event_emitter->unhandled_listeners)
+  {
+    _eventemitter_listeners_clear(event_emitter, listeners);
+  }
+  else if (!_eventemitter_retain_listeners(event_emitter, listeners))
+  {
+    _eventemitter_detach_listeners(event_emitter, listeners);
+  }
+}
+
+
+static bool _eventemitter_retain_listeners(struct EventEmitter *event_emitter, struct EventEmitterEventListeners *listeners)
+{
+  // only event listeners which are still attached are kept, so adding listeners to the event again does not allocate
+  if (  listeners->type != EVENTEMITTER_LISTENERS_EVENT
+     || event_emitter->retained_listeners >= event_emitter->max_retained_listeners
+     || _eventemitter_get_listeners_for_event_id(event_emitter, listeners->event_id) != listeners)
+  {
+    return(false);
+  }
+
+  // the records were all removed (and their slots released) so the array is only reset
+  listeners->count     = 0;
+  listeners->removed   = 0;
+  listeners->committed = 0;
+  listeners->unsorted  = false;
+  listeners->retained  = true;
+  event_emitter->retained_listeners++;
+
+  return(true);
+}
+
+
+static void _eventemitter_listeners_init(struct EventEmitterEventListeners *listeners, int event_id)
+{
+  listeners->event_id             = event_id;
+  listeners->pattern.max_event_id = event_id;
+  listeners->count                = 0;
+  listeners->removed              = 0;
+  listeners->capacity             = 0;
+  listeners->committed            = 0;
+  listeners->dispatching          = 0;
+  listeners->type                 = EVENTEMITTER_LISTENERS_EVENT;
+  listeners->unsorted             = false;
+  listeners->retained             = false;
+  listeners->detached             = false;
+  listeners->pending              = 0;
+  listeners->listeners            = NULL;
+#ifdef EVENTEMITTER_STATS
+  listeners->stats = NULL;
+#endif
+}
+
+
+static void _eventemitter_listeners_clear(struct EventEmitter *event_emitter, struct EventEmitterEventListeners *listeners)
+{
+  if (listeners->capacity == EVENTEMITTER_LISTENERS_INITIAL_CAPACITY)
+  {
+    _eventemitter_pool_free(&event_emitter->listener_records_pool, listeners->listeners);
+  }
+  else
+  {
+    _eventemitter_aligned_free(&event_emitter->allocator, listeners->listeners);
+  }
+  listeners->count     = 0;
+  listeners->removed   = 0;
+  listeners->capacity  = 0;
+  listeners->committed = 0;
+  listeners->listeners = NULL;
+}
+
+
+static void _eventemitter_listeners_release_records(struct EventEmitter *event_emitter, struct EventEmitterEventListeners *listeners)
+{
+  for (size_t index = 0; index < listeners->count; index++)
+  {
+    if (listeners->listeners[index].id)
+    {
+      _eventemitter_release_slot(event_emitter, &listeners->listeners[index]);
+      listeners->listeners[index].id = 0;
+    }
+  }
+  listeners->removed = listeners->count;
+}
+
+
+static bool _eventemitter_listeners_reserve(struct EventEmitter *event_emitter, struct EventEmitterEventListeners *listeners, size_t capacity)
+{
+  if (capacity <= listeners->capacity)
+  {
+    return(true);
+  }
+
+  size_t new_capacity = listeners->capacity ? listeners->capacity : EVENTEMITTER_LISTENERS_INITIAL_CAPACITY;
+  while (new_capacity < capacity)
+  {
+    new_capacity = new_capacity * 2;
+  }
+
+  // small arrays come from the pool, larger ones are grown in place when possible
+  if (listeners->capacity > EVENTEMITTER_LISTENERS_INITIAL_CAPACITY)
+  {
+    struct EventEmitterEventListener *records = _eventemitter_aligned_realloc(&event_emitter->allocator, listeners->listeners, listeners->capacity * sizeof(struct EventEmitterEventListener), new_capacity * sizeof(struct EventEmitterEventListener));
+    if (records == NULL)
+    {
+      return(false);
+    }
+
+    listeners->listeners = records;
+    listeners->capacity  = new_capacity;
+    return(true);
+  }
+
+  struct EventEmitterEventListener *records = NULL;
+  if (new_capacity == EVENTEMITTER_LISTENERS_INITIAL_CAPACITY)
+  {
+    records = _eventemitter_pool_alloc(&event_emitter->listener_records_pool);
+  }
+  else
+  {
+    records = _eventemitter_aligned_alloc(&event_emitter->allocator, new_capacity * sizeof(struct EventEmitterEventListener));
+  }
+  if (records == NULL)
+  {
+    return(false);
+  }
+
+  size_t count     = listeners->count;
+  size_t removed   = listeners->removed;
+  size_t committed = listeners->committed;
+  if (count)
+  {
+    memcpy(records, listeners->listeners, count * sizeof(struct EventEmitterEventListener));
+  }
+  _eventemitter_listeners_clear(event_emitter, listeners);
+  listeners->listeners = records;
+  listeners->capacity  = new_capacity;
+  listeners->count     = count;
+  listeners->removed   = removed;
+  listeners->committed = committed;
+
+  return(true);
+} /* _eventemitter_listeners_reserve */
+
+
+static bool _eventemitter_listeners_insert(struct EventEmitter *event_emitter, struct EventEmitterEventListeners *listeners, struct EventEmitterEventListener listener, bool prepend)
+{
+  if (!_eventemitter_listeners_reserve(event_emitter, listeners, listeners->count + 1))
+  {
+    return(false);
+  }
+
+  if (listeners->dispatching)
+  {
+    // staged at the end until the dispatch is done, prepended records are moved to the start only then
+    listener.prepend                       = prepend;
+    listeners->listeners[listeners->count] = listener;
+    listeners->count++;
+    _eventemitter_listeners_update_slots(event_emitter, listeners, listeners->count - 1);
+  }
+  else if (prepend)
+  {
+    // prepended records are placed before the other records of the same priority
+    if (listeners->unsorted)
+    {
+      _eventemitter_listeners_sort(event_emitter, listeners);
+    }
+    size_t position = _eventemitter_listeners_search(listeners->listeners, listeners->count, listener.priority, true);
+    memmove(&listeners->listeners[position + 1], &listeners->listeners[position], (listeners->count - position) * sizeof(struct EventEmitterEventListener));
+    listeners->listeners[position] = listener;
+    listeners->count++;
+    listeners->committed = listeners->count;
+    _eventemitter_listeners_update_slots(event_emitter, listeners, position);
+  }
+  else
+  {
+    // records with a higher priority than the last one are appended as well and sorted once before the next dispatch
+    if (listeners->count && listeners->listeners[listeners->count - 1].priority < listener.priority)
+    {
+      listeners->unsorted = true;
+    }
+    listeners->listeners[listeners->count] = listener;
+    listeners->count++;
+    listeners->committed = listeners->count;
+    _eventemitter_listeners_update_slots(event_emitter, listeners, listeners->count - 1);
+  }
+
+  return(true);
+}
+
+
+static void _eventemitter_listeners_insert_staged(struct EventEmitter *event_emitter, struct EventEmitterEventListeners *listeners, struct EventEmitterEventListener *buffer)
+{
+  // the pending records (of priority 0) staged at the end in add order are placed as if inserted
+  // one by one, all prepended records with a single move and the appended records after them
+  size_t first = listeners->count - listeners->pending;
+
+  if (listeners->dispatching)
+  {
+    // kept staged until the dispatch is done
+    _eventemitter_listeners_update_slots(event_emitter, listeners, first);
+    return;
+  }
+
+  size_t prepended = 0;
+  for (size_t index = first; index < listeners->count; index++)
+  {
+    if (listeners->listeners[index].prepend)
+    {
+      prepended++;
+    }
+  }
+
+  size_t position = first;
+  if (prepended)
+  {
+    // each prepended record is placed before the ones prepended earlier, so they are written in reverse
+    memcpy(buffer, &listeners->listeners[first], listeners->pending * sizeof(struct EventEmitterEventListener));
+    position = _eventemitter_listeners_search(listeners->listeners, first, 0, true);
+    memmove(&listeners->listeners[position + prepended], &listeners->listeners[position], (first - position) * sizeof(struct EventEmitterEventListener));
+
+    size_t prepend_index = position + prepended;
+    size_t append_index  = first + prepended;
+    for (size_t index = 0; index < listeners->pending; index++)
+    {
+      if (buffer[index].prepend)
+      {
+        prepend_index--;
+        buffer[index].prepend               = false;
+        listeners->listeners[prepend_index] = buffer[index];
+      }
+      else
+      {
+        listeners->listeners[append_index] = buffer[index];
+        append_index++;
+      }
+    }
+  }
+
+  // appended records with a higher priority than the record before them are sorted before the next dispatch
+  size_t appended = listeners->pending - prepended;
+  if (appended && first + prepended && listeners->listeners[first + prepended - 1].priority < 0)
+  {
+    listeners->unsorted = true;
+  }
+
+  listeners->committed = listeners->count;
+  _eventemitter_listeners_update_slots(event_emitter, listeners, position);
+} /* _eventemitter_listeners_insert_staged */
+
+
+static void _eventemitter_listeners_update_slots(struct EventEmitter *event_emitter, struct EventEmitterEventListeners *listeners, size_t start_index)
+{
+  for (size_t index = start_index; index < listeners->count; index++)
+  {
+    if (listeners->listeners[index].id)
+    {
+      struct EventEmitterListenerSlot *slot = _eventemitter_get_slot(event_emitter, listeners->listeners[index].slot);
+      slot->listeners = listeners;
+      slot->position  = index;
+    }
+  }
+}
+
+
+static size_t _eventemitter_listeners_search(const struct EventEmitterEventListener *records, size_t count, int priority, bool first)
+{
+  // the position of a new record in records ordered by descending priority,
+  // before (first) or after the records of the same priority
+  size_t start = 0;
+  size_t end   = count;
+
+  while (start < end)
+  {
+    size_t middle = start + (end - start) / 2;
+    if (records[middle].priority > priority || (!first && records[middle].priority == priority))
+    {
+      start = middle + 1;
+    }
+    else
+    {
+      end = middle;
+    }
+  }
+
+  return(start);
+}
+
+
+static void _eventemitter_listeners_merge(struct EventEmitterEventListener *output, const struct EventEmitterEventListener *first, size_t first_count, const struct EventEmitterEventListener *second, size_t second_count)
+{
+  // stable, on equal priorities the records of the first run are taken first
+  size_t first_index  = 0;
+  size_t second_index = 0;
+  size_t output_index = 0;
+
+  while (first_index < first_count && second_index < second_count)
+  {
+    if (second[second_index].priority > first[first_index].priority)
+    {
+      output[output_index++] = second[second_index++];
+    }
+    else
+    {
+      output[output_index++] = first[first_index++];
+    }
+  }
+  if (first_index < first_count)
+  {
+    memcpy(&output[output_index], &first[first_index], (first_count - first_index) * sizeof(struct EventEmitterEventListener));
+  }
+  if (second_index < second_count)
+  {
+    memcpy(&output[output_index], &second[second_index], (second_count - second_index) * sizeof(struct EventEmitterEventListener));
+  }
+}
+
+
+static void _eventemitter_listeners_sort(struct EventEmitter *event_emitter, struct EventEmitterEventListeners *listeners)
+{
+  // stable sort of the committed records by descending priority, called while no dispatch iterates them.
+  // only the records appended after the sorted head are sorted, so sorting k appended records
+  // costs O(n + k log k) and is amortized over the k additions.
+  struct EventEmitterEventListener *records = listeners->listeners;
+  size_t                           count    = listeners->committed;
+  size_t                           sorted   = 1;
+
+  listeners->unsorted = false;
+  while (sorted < count && records[sorted].priority <= records[sorted - 1].priority)
+  {
+    sorted++;
+  }
+  if (sorted >= count)
+  {
+    return;
+  }
+
+  // a few records are inserted in place, as well as when there is no memory for merging
+  struct EventEmitterEventListener *buffer = NULL;
+  if (count - sorted > EVENTEMITTER_LISTENERS_INSERTION_SORT_MAX)
+  {
+    buffer = event_emitter->allocator.allocate(count * sizeof(struct EventEmitterEventListener), event_emitter->allocator.context);
+  }
+  if (buffer == NULL)
+  {
+    for (size_t index = sorted; index < count; index++)
+    {
+      struct EventEmitterEventListener listener = records[index];
+      size_t                           position = _eventemitter_listeners_search(records, index, listener.priority, false);
+      memmove(&records[position + 1], &records[position], (index - position) * sizeof(struct EventEmitterEventListener));
+      records[position] = listener;
+    }
+  }
+  else
+  {
+    // bottom up merge sort of the tail, ping ponging between the array and the buffer
+    size_t                           tail_count = count - sorted;
+    struct EventEmitterEventListener *source    = &records[sorted];
+    struct EventEmitterEventListener *target    = &buffer[sorted];
+    for (size_t width = 1; width < tail_count; width = width * 2)
+    {
+      for (size_t start = 0; start < tail_count; start = start + 2 * width)
+      {
+        size_t middle = start + width < tail_count ? start + width : tail_count;
+        size_t end    = start + 2 * width < tail_count ? start + 2 * width : tail_count;
+        _eventemitter_listeners_merge(&target[start], &source[start], middle - start, &source[middle], end - middle);
+      }
+
+      struct EventEmitterEventListener *swap = source;
+      source = target;
+      target = swap;
+    }
+    if (source != &buffer[sorted])
+    {
+      memcpy(&buffer[sorted], source, tail_count * sizeof(struct EventEmitterEventListener));
+    }
+
+    // a single merge of the sorted head with the sorted tail
+    memcpy(buffer, records, sorted * sizeof(struct EventEmitterEventListener));
+    _eventemitter_listeners_merge(records, buffer, sorted, &buffer[sorted], tail_count);
+    event_emitter->allocator.deallocate(buffer, event_emitter->allocator.context);
+  }
+
+  _eventemitter_listeners_update_slots(event_emitter, listeners, 0);
+} /* _eventemitter_listeners_sort */
+
+
+static void _eventemitter_listeners_compact(struct EventEmitter *event_emitter, struct EventEmitterEventListeners *listeners)
+{
+  // removes the removed records while keeping the order and the committed/staged split
+  size_t output_index = 0;
+  size_t committed    = 0;
+
+  for (size_t index = 0; index < listeners->count; index++)
+  {
+    struct EventEmitterEventListener *listener = &listeners->listeners[index];
+
+    if (listener->id)
+    {
+      if (output_index != index)
+      {
+        listeners->listeners[output_index] = *listener;
+        _eventemitter_get_slot(event_emitter, listener->slot)->position = output_index;
+      }
+      output_index++;
+      if (index < listeners->committed)
+      {
+        committed = output_index;
+      }
+    }
+  }
+
+  listeners->count     = output_index;
+  listeners->removed   = 0;
+  listeners->committed = committed;
+}
+
+
+static void _eventemitter_listeners_commit(struct EventEmitter *event_emitter, struct EventEmitterEventListeners *listeners)
+{
+  // applies the changes done while the listeners were dispatched
+  if (listeners->count == listeners->removed)
+  {
+    _eventemitter_release_empty_listeners(event_emitter, listeners);
+
+    return;
+  }
+
+  if (listeners->removed)
+  {
+    _eventemitter_listeners_compact(event_emitter, listeners);
+  }
+
+  if (listeners->unsorted)
+  {
+    _eventemitter_listeners_sort(event_emitter, listeners);
+  }
+
+  // each staged record is moved to its priority position, prepended records before
+  // the records of the same priority (including the ones prepended earlier)
+  size_t moved = listeners->count;
+  for (size_t index = listeners->committed; index < listeners->count; index++)
+  {
+    struct EventEmitterEventListener listener = listeners->listeners[index];
+    size_t                           position = _eventemitter_listeners_search(listeners->listeners, index, listener.priority, listener.prepend);
+    listener.prepend = false;
+    if (position != index)
+    {
+      memmove(&listeners->listeners[position + 1], &listeners->listeners[position], (index - position) * sizeof(struct EventEmitterEventListener));
+      if (position < moved)
+      {
+        moved = position;
+      }
+    }
+    listeners->listeners[position] = listener;
+  }
+  if (moved < listeners->count)
+  {
+    _eventemitter_listeners_update_slots(event_emitter, listeners, moved);
+  }
+
+  listeners->committed = listeners->count;
+} /* _eventemitter_listeners_commit */
+
+
+static void _eventemitter_listeners_remove_record(struct EventEmitter *event_emitter, struct EventEmitterEventListeners *listeners, struct EventEmitterEventListener *listener)
+{
+  _eventemitter_release_slot(event_emitter, listener);
+  listener->id = 0;
+  listeners->removed++;
+}
+
+
+static int _eventemitter_listeners_invoke(struct EventEmitter *event_emitter, struct EventEmitterEventListeners *listeners, void *event_data)
+{
+  // called while the listeners are pinned, so only the records committed before the dispatch are invoked
+  if (listeners->unsorted)
+  {
+    _eventemitter_listeners_sort(event_emitter, listeners);
+  }
+
+  int    callback_counter = 0;
+  size_t count            = listeners->committed;
+
+  for (size_t index = 0; index < count; index++)
+  {
+    // callbacks may add listeners and move the array so it is accessed via the listeners struct
+    struct EventEmitterEventListener *listener = &listeners->listeners[index];
+
+    if (listener->id)
+    {
+      void (*callback)(void *, void *) = listener->callback.event;
+      void *context                     = listener->context;
+
+      // 'once' listeners are removed before invoked so nested emits will not invoke them again
+      if (listener->once)
+      {
+        _eventemitter_listeners_remove_record(event_emitter, listeners, listener);
+#ifdef EVENTEMITTER_STATS
+        _eventemitter_stats_once_removed(event_emitter, listeners);
+#endif
+      }
+
+      callback(event_data, context);
+      callback_counter++;
+    }
+  }
+
+  return(callback_counter);
+}
+
+
+static int _eventemitter_unhandled_listeners_invoke(struct EventEmitterEventListeners *listeners, int event_id, void *event_data)
+{
+  int    callback_counter = 0;
+  size_t count            = listeners->committed;
+
+  for (size_t index = 0; index < count; index++)
+  {
+    struct EventEmitterEventListener *listener = &listeners->listeners[index];
+
+    if (listener->id)
+    {
+      listener->callback.unhandled(event_id, event_data, listener->context);
+      callback_counter++;
+    }
+  }
+
+  return(callback_counter);
+}
+
+
+static void _eventemitter_listeners_unpin(struct EventEmitter *event_emitter, struct EventEmitterEventListeners *listeners)
+{
+  listeners->dispatching--;
+  if (!listeners->dispatching && (listeners->detached || listeners->removed || listeners->committed != listeners->count))
+  {
+    _eventemitter_listeners_commit(event_emitter, listeners);
+  }
+}
+
+
+static int _eventemitter_remove_listener_in_slot(struct EventEmitter *event_emitter, struct EventEmitterListenerSlot *slot)
+{
+  struct EventEmitterEventListeners *listeners = slot->listeners;
+
+  // the record is only marked as removed, compacting is amortized over many removals
+  // and deferred while the listeners are dispatched
+  _eventemitter_listeners_remove_record(event_emitter, listeners, &listeners->listeners[slot->position]);
+
+  if (listeners->dispatching)
+  {
+    return(1);
+  }
+
+  if (listeners->count == listeners->removed)
+  {
+    _eventemitter_release_empty_listeners(event_emitter, listeners);
+  }
+  else if (listeners->removed * 2 > listeners->count)
+  {
+    _eventemitter_listeners_compact(event_emitter, listeners);
+  }
+
+  return(1);
+}
+
+
+static struct EventEmitterListenerSlot *_eventemitter_get_slot(struct EventEmitter *event_emitter, size_t index)
+{
+  return(&event_emitter->listener_slot_pages[index >> EVENTEMITTER_SLOT_PAGE_BITS][index & (EVENTEMITTER_SLOT_PAGE_SIZE - 1)]);
+}
+
+
+static bool _eventemitter_alloc_slot(struct EventEmitter *event_emitter, size_t *index)
+{
+  if (event_emitter->free_listener_slot != SIZE_MAX)
+  {
+    *index                            = event_emitter->free_listener_slot;
+    event_emitter->free_listener_slot = _eventemitter_get_slot(event_emitter, *index)->position;
+    return(true);
+  }
+
+  if (event_emitter->listener_slots_count >= UINT32_MAX)
+  {
+    return(false);
+  }
+
+  // slots are allocated in pages so existing slots never move
+  size_t page = event_emitter->listener_slots_count >> EVENTEMITTER_SLOT_PAGE_BITS;
+  if (page == event_emitter->listener_slot_pages_count)
+  {
+    struct EventEmitterListenerSlot **pages = event_emitter->allocator.reallocate(event_emitter->listener_slot_pages, (page + 1) * sizeof(struct EventEmitterListenerSlot *), event_emitter->allocator.context);
+    if (pages == NULL)
+    {
+      return(false);
+    }
+    event_emitter->listener_slot_pages = pages;
+
+    pages[page] = event_emitter->allocator.allocate(EVENTEMITTER_SLOT_PAGE_SIZE * sizeof(struct EventEmitterListenerSlot), event_emitter->allocator.context);
+    if (pages[page] == NULL)
+    {
+      return(false);
+    }
+    event_emitter->listener_slot_pages_count++;
+  }
+
+  *index = event_emitter->listener_slots_count;
+  event_emitter->listener_slots_count++;
+  _eventemitter_get_slot(event_emitter, *index)->generation = 1;
+
+  return(true);
+}
+
+
+static void _eventemitter_release_slot(struct EventEmitter *event_emitter, struct EventEmitterEventListener *listener)
+{
+  struct EventEmitterListenerSlot *slot = _eventemitter_get_slot(event_emitter, listener->slot);
+
+  _eventemitter_map_remove(&event_emitter->listener_index, listener->id);
+
+  slot->listeners                   = NULL;
+  slot->position                    = event_emitter->free_listener_slot;
+  event_emitter->free_listener_slot = listener->slot;
+
+  // generation 0 is skipped so handles are never 0
+  slot->generation++;
+  if (!slot->generation)
+  {
+    slot->generation = 1;
+  }
+}
+
+
+static uint64_t _eventemitter_slot_handle(const struct EventEmitterListenerSlot *slot)
+{
+  return(((uint64_t)slot->generation << 32) | (uint64_t)slot->listeners->listeners[slot->position].slot);
+}
+
+
+static struct EventEmitterListenerSlot *_eventemitter_get_slot_for_handle(struct EventEmitter *event_emitter, uint64_t handle)
+{
+  size_t index = (size_t)(handle & UINT32_MAX);
+
+  if (index >= event_emitter->listener_slots_count)
+  {
+    return(NULL);
+  }
+
+  // free slots have no listeners and reused slots have a newer generation
+  struct EventEmitterListenerSlot *slot = _eventemitter_get_slot(event_emitter, index);
+  if (slot->listeners == NULL || slot->generation != (unsigned int)(handle >> 32))
+  {
+    return(NULL);
+  }
+
+  return(slot);
+}
+
+
+static unsigned int _eventemitter_next_callback_id(struct EventEmitter *event_emitter)
+{
+  // once the counter wrapped around, IDs of listeners which are still registered are skipped so IDs stay unique
+  while (!event_emitter->next_callback_id || (event_emitter->callback_ids_wrapped && _eventemitter_map_get(&event_emitter->listener_index, event_emitter->next_callback_id) != NULL))
+  {
+    if (!event_emitter->next_callback_id)
+    {
+      event_emitter->callback_ids_wrapped = true;
+    }
+    event_emitter->next_callback_id++;
+  }
+
+  return(event_emitter->next_callback_id);
+}
+
+
+static bool _eventemitter_index_record(struct EventEmitter *event_emitter, struct EventEmitterEventListener *listener)
+{
+  size_t slot_index = 0;
+
+  if (!_eventemitter_alloc_slot(event_emitter, &slot_index))
+  {
+    return(false);
+  }
+  listener->slot = (unsigned int)slot_index;
+
+  struct EventEmitterListenerSlot *slot = _eventemitter_get_slot(event_emitter, slot_index);
+  if (!_eventemitter_map_put(&event_emitter->listener_index, listener->id, slot))
+  {
+    slot->position                    = event_emitter->free_listener_slot;
+    event_emitter->free_listener_slot = slot_index;
+    return(false);
+  }
+
+  return(true);
+}
+
+
+static bool _eventemitter_add_record(struct EventEmitter *event_emitter, struct EventEmitterEventListeners *listeners, struct EventEmitterEventListener listener, bool prepend)
+{
+  if (!_eventemitter_index_record(event_emitter, &listener))
+  {
+    return(false);
+  }
+
+  if (!_eventemitter_listeners_insert(event_emitter, listeners, listener, prepend))
+  {
+    _eventemitter_release_slot(event_emitter, &listener);
+    return(false);
+  }
+#ifdef EVENTEMITTER_STATS
+  _eventemitter_stats_added(event_emitter, listeners);
+#endif
+
+  return(true);
+}
+
+
+static unsigned int _eventemitter_add_listener(struct EventEmitter *event_emitter, int event_id, void (*callback)(void *event_data, void *context), void *context, bool once, bool prepend, int priority)
+{
+  if (event_emitter == NULL || event_emitter->frozen != NULL || callback == NULL)
+  {
+    return(0);
+  }
+
+  struct EventEmitterEventListeners *listeners = _eventemitter_get_or_create_listeners(event_emitter, event_id);
+  if (listeners == NULL)
+  {
+    return(0);
+  }
+
+  // create listener record
+  struct EventEmitterEventListener listener;
+  listener.callback.event = callback;
+  listener.context        = context;
+  listener.id             = _eventemitter_next_callback_id(event_emitter);
+  listener.priority       = priority;
+  listener.once           = once;
+  listener.prepend        = false;
+
+  // keep in event listeners list
+  if (!_eventemitter_add_record(event_emitter, listeners, listener, prepend))
+  {
+    if (listeners->count == listeners->removed)
+    {
+      eventemitter_remove_all_event_listeners(event_emitter, event_id);
+    }
+    return(0);
+  }
+
+  // allocate next id for listener
+  event_emitter->next_callback_id++;
+
+  return(listener.id);
+} /* _eventemitter_add_listener */
+
+
+static unsigned int _eventemitter_add_unhandled_listener(struct EventEmitter *event_emitter, void (*callback)(int, void *, void *), void *context, bool prepend)
+{
+  if (event_emitter == NULL || event_emitter->frozen != NULL || callback == NULL)
+  {
+    return(0);
+  }
+
+  // create listener record
+  struct EventEmitterEventListener listener;
+  listener.callback.unhandled = callback;
+  listener.context            = context;
+  listener.id                 = _eventemitter_next_callback_id(event_emitter);
+  listener.priority           = 0;
+  listener.once               = false;
+  listener.prepend            = false;
+
+  // keep in event listeners list
+  if (!_eventemitter_add_record(event_emitter, &event_emitter->unhandled_listeners, listener, prepend))
+  {
+    return(0);
+  }
+
+  // allocate next id for listener
+  event_emitter->next_callback_id++;
+
+  return(listener.id);
+}
+
+
+
+static uint64_t _eventemitter_mask_key(int mask, int value)
+{
+  return(((uint64_t)(unsigned int)mask << 32) | (uint64_t)(unsigned int)value);
+}
+
+
+static bool _eventemitter_masks_acquire(struct EventEmitter *event_emitter, int mask)
+{
+  for (size_t index = 0; index < event_emitter->masks_count; index++)
+  {
+    if (event_emitter->masks[index].mask == mask)
+    {
+      event_emitter->masks[index].listeners++;
+      return(true);
+    }
+  }
+
+  if (event_emitter->masks_count == event_emitter->masks_capacity)
+  {
+    size_t                  capacity = event_emitter->masks_capacity ? event_emitter->masks_capacity * 2 : EVENTEMITTER_MASKS_INITIAL_CAPACITY;
+    struct EventEmitterMask *masks   = event_emitter->allocator.reallocate(event_emitter->masks, capacity * sizeof(struct EventEmitterMask), event_emitter->allocator.context);
+    if (masks == NULL)
+    {
+      return(false);
+    }
+    event_emitter->masks          = masks;
+    event_emitter->masks_capacity = capacity;
+  }
+
+  event_emitter->masks[event_emitter->masks_count].mask      = mask;
+  event_emitter->masks[event_emitter->masks_count].listeners = 1;
+  event_emitter->masks_count++;
+
+  return(true);
+}
+
+
+static void _eventemitter_masks_release(struct EventEmitter *event_emitter, int mask)
+{
+  for (size_t index = 0; index < event_emitter->masks_count; index++)
+  {
+    if (event_emitter->masks[index].mask == mask)
+    {
+      event_emitter->masks[index].listeners--;
+      break;
+    }
+  }
+
+  // unused masks are removed once no emit iterates them
+  if (!event_emitter->masks_dispatching)
+  {
+    _eventemitter_masks_compact(event_emitter);
+  }
+}
+
+
+static void _eventemitter_masks_compact(struct EventEmitter *event_emitter)
+{
+  size_t count = 0;
+
+  for (size_t index = 0; index < event_emitter->masks_count; index++)
+  {
+    if (event_emitter->masks[index].listeners)
+    {
+      event_emitter->masks[count] = event_emitter->masks[index];
+      count++;
+    }
+  }
+  event_emitter->masks_count = count;
+}
+
+
+static struct EventEmitterEventListeners *_eventemitter_get_or_create_pattern_listeners(struct EventEmitter *event_emitter, int type, int event_id, int parameter)
+{
+  struct EventEmitterEventListeners *listeners = NULL;
+
+  if (type == EVENTEMITTER_LISTENERS_RANGE)
+  {
+    listeners = _eventemitter_intervals_get(&event_emitter->interval_listeners, event_id, parameter);
+  }
+  else if (event_emitter->mask_listeners.entries != NULL)
+  {
+    listeners = _eventemitter_map_get(&event_emitter->mask_listeners, _eventemitter_mask_key(parameter, event_id));
+  }
+  if (listeners != NULL)
+  {
+    return(listeners);
+  }
+
+  listeners = _eventemitter_pool_alloc(&event_emitter->event_listeners_pool);
+  if (listeners == NULL)
+  {
+    return(NULL);
+  }
+  _eventemitter_listeners_init(listeners, event_id);
+  listeners->type = (unsigned char)type;
+
+  bool stored = false;
+  if (type == EVENTEMITTER_LISTENERS_RANGE)
+  {
+    listeners->pattern.max_event_id = parameter;
+    stored                          = _eventemitter_intervals_put(&event_emitter->interval_listeners, event_id, parameter, listeners);
+  }
+  else if ((event_emitter->mask_listeners.entries != NULL || _eventemitter_map_init(&event_emitter->mask_listeners, &event_emitter->allocator, 0))
+           && _eventemitter_masks_acquire(event_emitter, parameter))
+  {
+    listeners->pattern.mask = parameter;
+    stored                  = _eventemitter_map_put(&event_emitter->mask_listeners, _eventemitter_mask_key(parameter, event_id), listeners);
+    if (!stored)
+    {
+      _eventemitter_masks_release(event_emitter, parameter);
+    }
+  }
+
+  if (!stored)
+  {
+    _eventemitter_pool_free(&event_emitter->event_listeners_pool, listeners);
+    return(NULL);
+  }
+
+  return(listeners);
+} /* _eventemitter_get_or_create_pattern_listeners */
+
+
+static unsigned int _eventemitter_add_pattern_listener(struct EventEmitter *event_emitter, int type, int event_id, int parameter, void (*callback)(int, void *, void *), void *context)
+{
+  if (event_emitter == NULL || event_emitter->frozen != NULL || callback == NULL)
+  {
+    return(0);
+  }
+
+  struct EventEmitterEventListeners *listeners = _eventemitter_get_or_create_pattern_listeners(event_emitter, type, event_id, parameter);
+  if (listeners == NULL)
+  {
+    return(0);
+  }
+
+  // create listener record, invoked the same as unhandled listeners since the event ID varies
+  struct EventEmitterEventListener listener;
+  listener.callback.unhandled = callback;
+  listener.context            = context;
+  listener.id                 = _eventemitter_next_callback_id(event_emitter);
+  listener.priority           = 0;
+  listener.once               = false;
+  listener.prepend            = false;
+
+  // keep in event listeners list
+  if (!_eventemitter_add_record(event_emitter, listeners, listener, false))
+  {
+    if (listeners->count == listeners->removed)
+    {
+      _eventemitter_detach_listeners(event_emitter, listeners);
+    }
+    return(0);
+  }
+
+  // allocate next id for listener
+  event_emitter->next_callback_id++;
+
+  return(listener.id);
+}
+
+
+static bool _eventemitter_freeze_collect(struct EventEmitter *event_emitter, struct EventEmitterEventListeners *listeners, struct EventEmitterEventListeners **collected, size_t *count)
+{
+  // 'once' listeners are not supported by the frozen table and dispatched listeners are still changing
+  if (listeners == NULL || listeners->count == listeners->removed)
+  {
+    return(true);
+  }
+  if (listeners->dispatching)
+  {
+    return(false);
+  }
+  for (size_t index = 0; index < listeners->count; index++)
+  {
+    if (listeners->listeners[index].id && listeners->listeners[index].once)
+    {
+      return(false);
+    }
+  }
+
+  if (listeners->unsorted)
+  {
+    _eventemitter_listeners_sort(event_emitter, listeners);
+  }
+  collected[*count] = listeners;
+  (*count)++;
+
+  return(true);
+}
+
+
+static int _eventemitter_frozen_dispatch(struct EventEmitter *event_emitter, int event_id, void *event_data)
+{
+#ifdef EVENTEMITTER_TRACE
+  // the hooks are set before the frozen emitter is shared, so reading them does not need a lock
+  if (event_emitter->tracing)
+  {
+    return(_eventemitter_frozen_trace_emit(event_emitter->frozen, event_id, event_data, &event_emitter->trace_hooks));
+  }
+#endif
+
+  return(_eventemitter_frozen_emit(event_emitter->frozen, event_id, event_data));
+}
+
+
+static bool _eventemitter_has_patterns(struct EventEmitter *event_emitter)
+{
+  return(event_emitter->interval_listeners.count || event_emitter->masks_count);
+}
+
+
+static int _eventemitter_patterns_invoke(struct EventEmitter *event_emitter, int event_id, void *event_data)
+{
+  // matching ranges are fetched in windows ordered by range, so callbacks may add and remove ranges in between
+  struct EventEmitterIntervalsCursor cursor = { false, 0, 0 };
+  void                               *matches[EVENTEMITTER_RANGE_MATCHES_WINDOW];
+  int                                callback_counter = 0;
+  size_t                             found            = EVENTEMITTER_RANGE_MATCHES_WINDOW;
+
+  while (found == EVENTEMITTER_RANGE_MATCHES_WINDOW && event_emitter->interval_listeners.count)
+  {
+    found = _eventemitter_intervals_find(&event_emitter->interval_listeners, event_id, &cursor, matches, EVENTEMITTER_RANGE_MATCHES_WINDOW);
+
+    // the whole window is pinned so callbacks can not free the listeners before they are invoked
+    for (size_t index = 0; index < found; index++)
+    {
+      ((struct EventEmitterEventListeners *)matches[index])->dispatching++;
+    }
+    for (size_t index = 0; index < found; index++)
+    {
+      callback_counter = callback_counter + _eventemitter_pattern_listeners_invoke(event_emitter, matches[index], event_id, event_data);
+      _eventemitter_listeners_unpin(event_emitter, matches[index]);
+    }
+  }
+
+  // mask listeners follow, in the order their masks were first used
+  event_emitter->masks_dispatching++;
+  for (size_t index = 0; index < event_emitter->masks_count; index++)
+  {
+    int                               mask       = event_emitter->masks[index].mask;
+    struct EventEmitterEventListeners *listeners = _eventemitter_map_get(&event_emitter->mask_listeners, _eventemitter_mask_key(mask, event_id & mask));
+
+    if (listeners != NULL)
+    {
+      listeners->dispatching++;
+      callback_counter = callback_counter + _eventemitter_pattern_listeners_invoke(event_emitter, listeners, event_id, event_data);
+      _eventemitter_listeners_unpin(event_emitter, listeners);
+    }
+  }
+  event_emitter->masks_dispatching--;
+  if (!event_emitter->masks_dispatching)
+  {
+    _eventemitter_masks_compact(event_emitter);
+  }
+
+  return(callback_counter);
+} /* _eventemitter_patterns_invoke */
+
+
+static int _eventemitter_pattern_listeners_invoke(struct EventEmitter *event_emitter, struct EventEmitterEventListeners *listeners, int event_id, void *event_data)
+{
+#ifdef EVENTEMITTER_TRACE
+  if (event_emitter->tracing)
+  {
+    return(_eventemitter_trace_listeners_invoke(event_emitter, listeners, event_id, event_data));
+  }
+#else
+  (void)event_emitter;
+#endif
+
+  return(_eventemitter_unhandled_listeners_invoke(listeners, event_id, event_data));
+}
+
+#ifdef EVENTEMITTER_STATS
+
+
+static void _eventemitter_stats_emit(struct EventEmitter *event_emitter, struct EventEmitterEventListeners *listeners, bool handled, int callback_counter)
+{
+  // listeners may be NULL (event without listeners or only handled by range and mask listeners)
+  // or empty, in which case the event was unhandled
+  struct EventEmitterStats *event_stats = listeners != NULL ? listeners->stats : NULL;
+
+  event_emitter->stats.emits++;
+  if (event_stats != NULL)
+  {
+    event_stats->emits++;
+  }
+
+  if (handled)
+  {
+    event_emitter->stats.invocations = event_emitter->stats.invocations + (uint64_t)callback_counter;
+    if (event_stats != NULL)
+    {
+      event_stats->invocations = event_stats->invocations + (uint64_t)callback_counter;
+    }
+  }
+  else
+  {
+    event_emitter->stats.unhandled++;
+    if (event_stats != NULL)
+    {
+      event_stats->unhandled++;
+    }
+  }
+}
+
+
+static void _eventemitter_stats_once_removed(struct EventEmitter *event_emitter, struct EventEmitterEventListeners *listeners)
+{
+  event_emitter->stats.once_removals++;
+  listeners->stats->once_removals++;
+}
+
+
+static void _eventemitter_stats_added(struct EventEmitter *event_emitter, struct EventEmitterEventListeners *listeners)
+{
+  // all listeners (including unhandled) are in the listener index
+  if (event_emitter->listener_index.size > event_emitter->stats.peak_listeners)
+  {
+    event_emitter->stats.peak_listeners = event_emitter->listener_index.size;
+  }
+
+  size_t count = listeners->count - listeners->removed;
+  if (listeners->stats != NULL && count > listeners->stats->peak_listeners)
+  {
+    listeners->stats->peak_listeners = count;
+  }
+}
+
+#endif
+#ifdef EVENTEMITTER_TRACE
+
+
+uint64_t _eventemitter_trace_now(void)
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+
+  return((uint64_t)now.tv_sec * 1000000000u + (uint64_t)now.tv_nsec);
+}
+
+
+static int _eventemitter_trace_emit(struct EventEmitter *event_emitter, int event_id, void *event_data)
+{
+  struct EventEmitterEventListeners *listeners           = _eventemitter_get_listeners_for_event_id(event_emitter, event_id);
+  struct EventEmitterEventListeners *unhandled_listeners = &event_emitter->unhandled_listeners;
+
+  // pinned the same way as in a batch so callbacks can not free the listeners
+  if (listeners != NULL)
+  {
+    listeners->dispatching++;
+  }
+  unhandled_listeners->dispatching++;
+
+  int callback_counter = _eventemitter_trace_dispatch(event_emitter, listeners, event_id, event_data);
+
+  _eventemitter_listeners_unpin(event_emitter, unhandled_listeners);
+  if (listeners != NULL)
+  {
+    _eventemitter_listeners_unpin(event_emitter, listeners);
+  }
+
+  return(callback_counter);
+}
+
+
+static int _eventemitter_trace_dispatch(struct EventEmitter *event_emitter, struct EventEmitterEventListeners *listeners, int event_id, void *event_data)
+{
+  // the hooks are read on every use since callbacks may change them
+  struct EventEmitterTraceHooks *hooks = &event_emitter->trace_hooks;
+  int                           callback_counter;
+
+  if (hooks->pre_emit != NULL)
+  {
+    hooks->pre_emit(event_id, _eventemitter_trace_now(), hooks->context);
+  }
+
+  if (listeners != NULL && listeners->count > listeners->removed)
+  {
+    callback_counter = _eventemitter_trace_listeners_invoke(event_emitter, listeners, event_id, event_data);
+    if (_eventemitter_has_patterns(event_emitter))
+    {
+      callback_counter = callback_counter + _eventemitter_patterns_invoke(event_emitter, event_id, event_data);
+    }
+#ifdef EVENTEMITTER_STATS
+    _eventemitter_stats_emit(event_emitter, listeners, true, callback_counter);
+#endif
+  }
+  else
+  {
+    callback_counter = _eventemitter_has_patterns(event_emitter) ? _eventemitter_patterns_invoke(event_emitter, event_id, event_data) : 0;
+    if (callback_counter)
+    {
+#ifdef EVENTEMITTER_STATS
+      _eventemitter_stats_emit(event_emitter, NULL, true, callback_counter);
+#endif
+    }
+    else
+    {
+#ifdef EVENTEMITTER_STATS
+      _eventemitter_stats_emit(event_emitter, listeners, false, 0);
+#endif
+      callback_counter = _eventemitter_trace_listeners_invoke(event_emitter, &event_emitter->unhandled_listeners, event_id, event_data);
+    }
+  }
+
+  if (hooks->post_emit != NULL)
+  {
+    hooks->post_emit(event_id, callback_counter, _eventemitter_trace_now(), hooks->context);
+  }
+
+  return(callback_counter);
+}
+
+
+static int _eventemitter_trace_listeners_invoke(struct EventEmitter *event_emitter, struct EventEmitterEventListeners *listeners, int event_id, void *event_data)
+{
+  // same as the untraced invoke functions, for both event and unhandled listeners
+  struct EventEmitterTraceHooks *hooks           = &event_emitter->trace_hooks;
+  bool                          unhandled        = listeners == &event_emitter->unhandled_listeners || listeners->type != EVENTEMITTER_LISTENERS_EVENT;
+  int                           callback_counter = 0;
+
+  if (listeners->unsorted)
+  {
+    _eventemitter_listeners_sort(event_emitter, listeners);
+  }
+
+  size_t count = listeners->committed;
+
+  for (size_t index = 0; index < count; index++)
+  {
+    struct EventEmitterEventListener *listener = &listeners->listeners[index];
+
+    if (listener->id)
+    {
+      struct EventEmitterEventListener invoked = *listener;
+
+      if (listener->once)
+      {
+        _eventemitter_listeners_remove_record(event_emitter, listeners, listener);
+#ifdef EVENTEMITTER_STATS
+        _eventemitter_stats_once_removed(event_emitter, listeners);
+#endif
+      }
+
+      if (hooks->pre_listener != NULL)
+      {
+        hooks->pre_listener(event_id, invoked.id, _eventemitter_trace_now(), hooks->context);
+      }
+      if (unhandled)
+      {
+        invoked.callback.unhandled(event_id, event_data, invoked.context);
+      }
+      else
+      {
+        invoked.callback.event(event_data, invoked.context);
+      }
+      if (hooks->post_listener != NULL)
+      {
+        hooks->post_listener(event_id, invoked.id, _eventemitter_trace_now(), hooks->context);
+      }
+      callback_counter++;
+    }
+  }
+
+  return(callback_counter);
+} /* _eventemitter_trace_listeners_invoke */
+
+#endif
+#ifdef EVENTEMITTER_THREADS
+
+
+static struct EventEmitterAsyncEmit *_eventemitter_emit_async(struct EventEmitter *event_emitter, int event_id, void *event_data, void (*callback)(int, void *), void *context)
+{
+  if (event_emitter == NULL || event_emitter->workers == NULL)
+  {
+    return(NULL);
+  }
+
+  // same as emit, the range and mask listeners follow the listeners of the exact event ID
+  // and the unhandled listeners are only invoked if none of them matched
+  struct EventEmitterEventListeners *listeners = _eventemitter_get_listeners_for_event_id(event_emitter, event_id);
+  if (listeners != NULL && listeners->count == listeners->removed)
+  {
+    listeners = NULL;
+  }
+  size_t event_count    = listeners != NULL ? _eventemitter_async_count_records(event_emitter, listeners) : 0;
+  size_t patterns_count = _eventemitter_has_patterns(event_emitter) ? _eventemitter_async_collect_patterns(event_emitter, event_id, NULL) : 0;
+  bool   unhandled      = listeners == NULL && !patterns_count;
+#ifdef EVENTEMITTER_STATS
+  struct EventEmitterEventListeners *event_listeners = _eventemitter_get_listeners_for_event_id(event_emitter, event_id);
+#endif
+  if (unhandled)
+  {
+    listeners   = &event_emitter->unhandled_listeners;
+    event_count = _eventemitter_async_count_records(event_emitter, listeners);
+  }
+
+  size_t                       count       = event_count + patterns_count;
+  struct EventEmitterAsyncEmit *async_emit = event_emitter->allocator.allocate(sizeof(struct EventEmitterAsyncEmit) + count * sizeof(struct EventEmitterAsyncEmitTask), event_emitter->allocator.context);
+  if (async_emit == NULL)
+  {
+    return(NULL);
+  }
+
+  async_emit->allocator        = event_emitter->allocator;
+  async_emit->workers          = event_emitter->workers;
+  async_emit->event_id         = event_id;
+  async_emit->event_data       = event_data;
+  async_emit->callback         = callback;
+  async_emit->context          = context;
+  async_emit->callback_counter = (int)count;
+  atomic_init(&async_emit->remaining, count);
+  atomic_init(&async_emit->done, false);
+#ifdef EVENTEMITTER_TRACE
+  async_emit->trace_hooks = event_emitter->trace_hooks;
+  if (async_emit->trace_hooks.pre_emit != NULL)
+  {
+    async_emit->trace_hooks.pre_emit(event_id, _eventemitter_trace_now(), async_emit->trace_hooks.context);
+  }
+#endif
+#ifdef EVENTEMITTER_STATS
+  if (unhandled)
+  {
+    _eventemitter_stats_emit(event_emitter, event_listeners, false, 0);
+  }
+  else
+  {
+    _eventemitter_stats_emit(event_emitter, listeners, true, (int)count);
+  }
+#endif
+
+  // the listener records are copied so the listeners can change while the tasks are running
+  if (listeners != NULL)
+  {
+    _eventemitter_async_collect_records(event_emitter, listeners, async_emit->tasks, unhandled);
+  }
+  if (patterns_count)
+  {
+    _eventemitter_async_collect_patterns(event_emitter, event_id, &async_emit->tasks[event_count]);
+  }
+  for (size_t index = 0; index < count; index++)
+  {
+    struct EventEmitterAsyncEmitTask *task = &async_emit->tasks[index];
+    task->task.run   = _eventemitter_async_emit_run;
+    task->task.next  = index + 1 < count ? &async_emit->tasks[index + 1].task : NULL;
+    task->async_emit = async_emit;
+  }
+
+  if (!count)
+  {
+    _eventemitter_async_emit_complete(async_emit);
+  }
+  else
+  {
+    _eventemitter_workers_submit(async_emit->workers, &async_emit->tasks[0].task);
+  }
+
+  return(async_emit);
+} /* _eventemitter_emit_async */
+
+
+static size_t _eventemitter_async_count_records(struct EventEmitter *event_emitter, struct EventEmitterEventListeners *listeners)
+{
+  if (listeners->unsorted)
+  {
+    _eventemitter_listeners_sort(event_emitter, listeners);
+  }
+
+  size_t count = listeners->committed;
+
+  for (size_t index = 0; index < listeners->committed; index++)
+  {
+    if (!listeners->listeners[index].id)
+    {
+      count--;
+    }
+  }
+
+  return(count);
+}
+
+
+static size_t _eventemitter_async_collect_records(struct EventEmitter *event_emitter, struct EventEmitterEventListeners *listeners, struct EventEmitterAsyncEmitTask *tasks, bool unhandled)
+{
+  size_t count = 0;
+  for (size_t index = 0; index < listeners->committed; index++)
+  {
+    struct EventEmitterEventListener *listener = &listeners->listeners[index];
+    if (!listener->id)
+    {
+      continue;
+    }
+
+    tasks[count].listener  = *listener;
+    tasks[count].unhandled = unhandled;
+    count++;
+
+    if (listener->once)
+    {
+      _eventemitter_listeners_remove_record(event_emitter, listeners, listener);
+#ifdef EVENTEMITTER_STATS
+      _eventemitter_stats_once_removed(event_emitter, listeners);
+#endif
+    }
+  }
+  if (!listeners->dispatching && listeners->removed)
+  {
+    _eventemitter_listeners_commit(event_emitter, listeners);
+  }
+
+  return(count);
+}
+
+
+static size_t _eventemitter_async_collect_patterns(struct EventEmitter *event_emitter, int event_id, struct EventEmitterAsyncEmitTask *tasks)
+{
+  // counts the matching records when no tasks are provided, range and mask listeners have no 'once' records
+  // so collecting them does not remove records and the count stays valid
+  struct EventEmitterIntervalsCursor cursor = { false, 0, 0 };
+  void                               *matches[EVENTEMITTER_RANGE_MATCHES_WINDOW];
+  size_t                             count = 0;
+  size_t                             found = EVENTEMITTER_RANGE_MATCHES_WINDOW;
+
+  while (found == EVENTEMITTER_RANGE_MATCHES_WINDOW && event_emitter->interval_listeners.count)
+  {
+    found = _eventemitter_intervals_find(&event_emitter->interval_listeners, event_id, &cursor, matches, EVENTEMITTER_RANGE_MATCHES_WINDOW);
+    for (size_t index = 0; index < found; index++)
+    {
+      count = count + (tasks != NULL ? _eventemitter_async_collect_records(event_emitter, matches[index], &tasks[count], true) : _eventemitter_async_count_records(event_emitter, matches[index]));
+    }
+  }
+
+  for (size_t index = 0; index < event_emitter->masks_count; index++)
+  {
+    int                               mask       = event_emitter->masks[index].mask;
+    struct EventEmitterEventListeners *listeners = _eventemitter_map_get(&event_emitter->mask_listeners, _eventemitter_mask_key(mask, event_id & mask));
+
+    if (listeners != NULL)
+    {
+      count = count + (tasks != NULL ? _eventemitter_async_collect_records(event_emitter, listeners, &tasks[count], true) : _eventemitter_async_count_records(event_emitter, listeners));
+    }
+  }
+
+  return(count);
+} /* _eventemitter_async_collect_patterns */
+
+
+static void _eventemitter_async_emit_run(struct EventEmitterWorkerTask *task)
+{
+  struct EventEmitterAsyncEmitTask *async_task = (struct EventEmitterAsyncEmitTask *)(void *)task;
+  struct EventEmitterAsyncEmit     *async_emit = async_task->async_emit;
+
+#ifdef EVENTEMITTER_TRACE
+  struct EventEmitterTraceHooks *hooks = &async_emit->trace_hooks;
+  if (hooks->pre_listener != NULL)
+  {
+    hooks->pre_listener(async_emit->event_id, async_task->listener.id, _eventemitter_trace_now(), hooks->context);
+  }
+#endif
+  if (async_task->unhandled)
+  {
+    async_task->listener.callback.unhandled(async_emit->event_id, async_emit->event_data, async_task->listener.context);
+  }
+  else
+  {
+    async_task->listener.callback.event(async_emit->event_data, async_task->listener.context);
+  }
+#ifdef EVENTEMITTER_TRACE
+  if (hooks->post_listener != NULL)
+  {
+    hooks->post_listener(async_emit->event_id, async_task->listener.id, _eventemitter_trace_now(), hooks->context);
+  }
+#endif
+
+  // the last listener to finish completes the emit
+  if (atomic_fetch_sub(&async_emit->remaining, 1) == 1)
+  {
+    _eventemitter_async_emit_complete(async_emit);
+  }
+}
+
+
+static void _eventemitter_async_emit_complete(struct EventEmitterAsyncEmit *async_emit)
+{
+#ifdef EVENTEMITTER_TRACE
+  if (async_emit->trace_hooks.post_emit != NULL)
+  {
+    async_emit->trace_hooks.post_emit(async_emit->event_id, async_emit->callback_counter, _eventemitter_trace_now(), async_emit->trace_hooks.context);
+  }
+#endif
+  if (async_emit->callback != NULL)
+  {
+    async_emit->callback(async_emit->callback_counter, async_emit->context);
+    async_emit->allocator.deallocate(async_emit, async_emit->allocator.context);
+  }
+  else
+  {
+    // the handle may be freed by the waiting thread right after it is notified
+    _eventemitter_workers_notify(async_emit->workers, &async_emit->done);
+  }
+}
+
+#endif
+
@@ -0,0 +1,267 @@
+#include "eventemitter_alloc.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// private functions
+static char *_eventemitter_aligned_address(char *);
+static int _eventemitter_pool_compare_slabs(const void *, const void *);
+static size_t *_eventemitter_pool_slab_free_count(char **, size_t, void *);
+static void *_eventemitter_default_allocate(size_t, void *);
+static void *_eventemitter_default_reallocate(void *, size_t, void *);
+static void _eventemitter_default_deallocate(void *, void *);
+
+const struct EventEmitterAllocator _eventemitter_default_allocator =
+{
+  _eventemitter_default_allocate,
+  _eventemitter_default_reallocate,
+  _eventemitter_default_deallocate,
+  NULL
+};
+
+void *_eventemitter_aligned_alloc(const struct EventEmitterAllocator *allocator, size_t size)
+{
+  char *allocation = allocator->allocate(size + EVENTEMITTER_CACHE_LINE_SIZE + sizeof(void *), allocator->context);
+
+  if (allocation == NULL)
+  {
+    return(NULL);
+  }
+
+  // keep the original pointer right before the aligned block so it can be freed later
+  char *aligned = _eventemitter_aligned_address(allocation);
+  ((void **)aligned)[-1] = allocation;
+
+  return(aligned);
+}
+
+
+void *_eventemitter_aligned_realloc(const struct EventEmitterAllocator *allocator, void *block, size_t old_size, size_t size)
+{
+  char   *old_allocation = ((void **)block)[-1];
+  size_t old_offset      = (size_t)((char *)block - old_allocation);
+
+  char   *allocation = allocator->reallocate(old_allocation, size + EVENTEMITTER_CACHE_LINE_SIZE + sizeof(void *), allocator->context);
+  if (allocation == NULL)
+  {
+    return(NULL);
+  }
+
+  // the new allocation may have a different alignment, in which case the content is moved to the new aligned position
+  char *aligned = _eventemitter_aligned_address(allocation);
+  if (aligned != allocation + old_offset)
+  {
+    memmove(aligned, allocation + old_offset, old_size < size ? old_size : size);
+  }
+  ((void **)aligned)[-1] = allocation;
+
+  return(aligned);
+}
+
+
+void _eventemitter_aligned_free(const struct EventEmitterAllocator *allocator, void *block)
+{
+  if (block != NULL)
+  {
+    allocator->deallocate(((void **)block)[-1], allocator->context);
+  }
+}
+
+
+void _eventemitter_pool_init(struct EventEmitterPool *pool, const struct EventEmitterAllocator *allocator, size_t chunk_size, size_t chunks_per_slab)
+{
+  pool->allocator       = allocator;
+  pool->chunk_size      = (chunk_size + EVENTEMITTER_CACHE_LINE_SIZE - 1) & ~(size_t)(EVENTEMITTER_CACHE_LINE_SIZE - 1);
+  pool->chunks_per_slab = chunks_per_slab ? chunks_per_slab : 1;
+  pool->free_chunks     = NULL;
+  pool->slabs           = NULL;
+}
+
+
+void _eventemitter_pool_release(struct EventEmitterPool *pool)
+{
+  while (pool->slabs != NULL)
+  {
+    void *slab = pool->slabs;
+    pool->slabs = *(void **)slab;
+    _eventemitter_aligned_free(pool->allocator, slab);
+  }
+
+  pool->free_chunks = NULL;
+}
+
+
+size_t _eventemitter_pool_trim(struct EventEmitterPool *pool)
+{
+  size_t slabs_count = 0;
+
+  for (void *slab = pool->slabs; slab != NULL; slab = *(void **)slab)
+  {
+    slabs_count++;
+  }
+  if (!slabs_count || pool->free_chunks == NULL)
+  {
+    return(0);
+  }
+
+  // the slabs are sorted by address so the slab of each free chunk is found with a binary search
+  char **slabs = pool->allocator->allocate(slabs_count * sizeof(char *), pool->allocator->context);
+  if (slabs == NULL)
+  {
+    return(0);
+  }
+  size_t index = 0;
+  for (char *slab = pool->slabs; slab != NULL; slab = *(void **)slab)
+  {
+    slabs[index] = slab;
+    index++;
+    // the free chunks of each slab are counted in its first cache line, after the link
+    *(size_t *)(void *)(slab + sizeof(void *)) = 0;
+  }
+  qsort(slabs, slabs_count, sizeof(char *), _eventemitter_pool_compare_slabs);
+
+  for (void *chunk = pool->free_chunks; chunk != NULL; chunk = *(void **)chunk)
+  {
+    (*_eventemitter_pool_slab_free_count(slabs, slabs_count, chunk))++;
+  }
+
+  // the chunks of the slabs being freed are unlinked from the free list, keeping the order of the others
+  void **free_link = &pool->free_chunks;
+  while (*free_link != NULL)
+  {
+    if (*_eventemitter_pool_slab_free_count(slabs, slabs_count, *free_link) == pool->chunks_per_slab)
+    {
+      *free_link = *(void **)*free_link;
+    }
+    else
+    {
+      free_link = (void **)*free_link;
+    }
+  }
+
+  size_t freed      = 0;
+  void   **slab_link = &pool->slabs;
+  while (*slab_link != NULL)
+  {
+    char *slab = *slab_link;
+    if (*(size_t *)(void *)(slab + sizeof(void *)) == pool->chunks_per_slab)
+    {
+      *slab_link = *(void **)slab;
+      _eventemitter_aligned_free(pool->allocator, slab);
+      freed++;
+    }
+    else
+    {
+      slab_link = (void **)slab;
+    }
+  }
+
+  pool->allocator->deallocate(slabs, pool->allocator->context);
+
+  return(freed);
+} /* _eventemitter_pool_trim */
+
+
+void *_eventemitter_pool_alloc(struct EventEmitterPool *pool)
+{
+  if (pool->free_chunks == NULL)
+  {
+    // the first cache line of the slab links it to the other slabs, the rest is split to chunks
+    char *slab = _eventemitter_aligned_alloc(pool->allocator, EVENTEMITTER_CACHE_LINE_SIZE + pool->chunk_size * pool->chunks_per_slab);
+    if (slab == NULL)
+    {
+      return(NULL);
+    }
+
+    *(void **)slab = pool->slabs;
+    pool->slabs    = slab;
+
+    for (size_t index = pool->chunks_per_slab; index > 0; index--)
+    {
+      _eventemitter_pool_free(pool, slab + EVENTEMITTER_CACHE_LINE_SIZE + (index - 1) * pool->chunk_size);
+    }
+  }
+
+  void *chunk = pool->free_chunks;
+  pool->free_chunks = *(void **)chunk;
+
+  return(chunk);
+}
+
+
+void _eventemitter_pool_free(struct EventEmitterPool *pool, void *chunk)
+{
+  if (chunk != NULL)
+  {
+    *(void **)chunk   = pool->free_chunks;
+    pool->free_chunks = chunk;
+  }
+}
+
+
+static char *_eventemitter_aligned_address(char *allocation)
+{
+  // leave room for the original pointer before the aligned block
+  uintptr_t address = (uintptr_t)(allocation + sizeof(void *));
+
+  address = (address + EVENTEMITTER_CACHE_LINE_SIZE - 1) & ~(uintptr_t)(EVENTEMITTER_CACHE_LINE_SIZE - 1);
+
+  return(allocation + (address - (uintptr_t)allocation));
+}
+
+
+static int _eventemitter_pool_compare_slabs(const void *first, const void *second)
+{
+  uintptr_t first_address  = (uintptr_t)*(char *const *)first;
+  uintptr_t second_address = (uintptr_t)*(char *const *)second;
+
+  return((first_address > second_address) - (first_address < second_address));
+}
+
+
+static size_t *_eventemitter_pool_slab_free_count(char **slabs, size_t slabs_count, void *chunk)
+{
+  // the last slab starting before the chunk is the one containing it
+  size_t start = 0;
+  size_t end   = slabs_count;
+
+  while (end - start > 1)
+  {
+    size_t middle = start + (end - start) / 2;
+    if ((uintptr_t)slabs[middle] <= (uintptr_t)chunk)
+    {
+      start = middle;
+    }
+    else
+    {
+      end = middle;
+    }
+  }
+
+  return((size_t *)(void *)(slabs[start] + sizeof(void *)));
+}
+
+
+static void *_eventemitter_default_allocate(size_t size, void *context)
+{
+  (void)context;
+
+  return(malloc(size));
+}
+
+
+static void *_eventemitter_default_reallocate(void *pointer, size_t size, void *context)
+{
+  (void)context;
+
+  return(realloc(pointer, size));
+}
+
+
+static void _eventemitter_default_deallocate(void *pointer, void *context)
+{
+  (void)context;
+
+  free(pointer);
+}
+
@@ -0,0 +1,102 @@
+#ifndef EVENTEMITTER_ALLOC_H
+#define EVENTEMITTER_ALLOC_H
+
+#include "eventemitter.h"
+#include <stddef.h>
+
+#define EVENTEMITTER_CACHE_LINE_SIZE    64
+
+/**
+ * The allocator used by emitters created without a custom allocator (malloc/realloc/free).
+ */
+extern const struct EventEmitterAllocator _eventemitter_default_allocator;
+
+/**
+ * Internal fixed size slab pool.
+ * Chunks are carved out of cache line aligned slabs and freed chunks are kept in
+ * an intrusive free list for reuse, so slabs are only returned to the allocator
+ * when the pool is trimmed or released.
+ */
+struct EventEmitterPool
+{
+  const struct EventEmitterAllocator *allocator;
+  size_t                             chunk_size;
+  size_t                             chunks_per_slab;
+  void                               *free_chunks;
+  void                               *slabs;
+};
+
+/**
+ * Allocates a block aligned to the cache line size using the provided allocator.
+ *
+ * @param allocator - The allocator
+ * @param size - The block size
+ * @returns the aligned block or NULL in case of allocation failure
+ */
+void *_eventemitter_aligned_alloc(const struct EventEmitterAllocator *, size_t /* size */);
+
+/**
+ * Resizes a block allocated via _eventemitter_aligned_alloc using the allocator realloc hook.
+ * The content (up to the smaller of the two sizes) is preserved and the block stays aligned.
+ *
+ * @param allocator - The allocator used to allocate the block
+ * @param block - The aligned block
+ * @param old size - The current block size
+ * @param size - The new block size
+ * @returns the resized aligned block or NULL in case of allocation failure (the original block is left intact)
+ */
+void *_eventemitter_aligned_realloc(const struct EventEmitterAllocator *, void * /* block */, size_t /* old size */, size_t /* size */);
+
+/**
+ * Frees a block allocated via _eventemitter_aligned_alloc.
+ *
+ * @param allocator - The allocator used to allocate the block
+ * @param block - The aligned block (may be NULL)
+ */
+void _eventemitter_aligned_free(const struct EventEmitterAllocator *, void * /* block */);
+
+/**
+ * Initializes the pool. No memory is allocated until the first chunk is requested.
+ * Chunk sizes are rounded up to the cache line size.
+ *
+ * @param pool - The pool to initialize
+ * @param allocator - The allocator used for the slabs (must outlive the pool)
+ * @param chunk size - The size of each chunk
+ * @param chunks per slab - The amount of chunks allocated at once
+ */
+void _eventemitter_pool_init(struct EventEmitterPool *, const struct EventEmitterAllocator *, size_t /* chunk size */, size_t /* chunks per slab */);
+
+/**
+ * Frees all slabs of the pool, including chunks that were not returned.
+ *
+ * @param pool - The pool to release
+ */
+void _eventemitter_pool_release(struct EventEmitterPool *);
+
+/**
+ * Frees the slabs of which all chunks are in the free list.
+ * Nothing is freed if the temporary slabs index can not be allocated.
+ *
+ * @param pool - The pool to trim
+ * @returns the amount of freed slabs
+ */
+size_t _eventemitter_pool_trim(struct EventEmitterPool *);
+
+/**
+ * Returns a cache line aligned chunk from the pool.
+ *
+ * @param pool - The pool
+ * @returns the chunk or NULL in case of allocation failure
+ */
+void *_eventemitter_pool_alloc(struct EventEmitterPool *);
+
+/**
+ * Returns the chunk to the pool free list.
+ *
+ * @param pool - The pool the chunk was allocated from
+ * @param chunk - The chunk (may be NULL)
+ */
+void _eventemitter_pool_free(struct EventEmitterPool *, void * /* chunk */);
+
+#endif
+
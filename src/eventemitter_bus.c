@@ -0,0 +1,438 @@
+#define _GNU_SOURCE
+
+#include "eventemitter_bus.h"
+#include "eventemitter_internal.h"
+
+#if defined(EVENTEMITTER_THREADS) && defined(__linux__)
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <linux/futex.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#define EVENTEMITTER_BUS_MAGIC    0x45454255u
+
+// the payload bytes follow the cell header, cells are padded to whole cache lines
+struct EventEmitterBusCell
+{
+  atomic_size_t sequence;
+  int           event_id;
+  uint32_t      size;
+};
+
+// the shared memory header, followed by the cells (same algorithm as the events queue)
+struct EventEmitterBusRing
+{
+  size_t        magic;
+  size_t        mask;
+  size_t        cell_size;
+  size_t        max_payload_size;
+  char          settings_padding[EVENTEMITTER_CACHE_LINE_SIZE - 4 * sizeof(size_t)];
+  atomic_size_t dequeue_position;
+  // set by a sleeping consumer, cleared by the producer which wakes it
+  atomic_uint   sleeping;
+  char          consumer_padding[EVENTEMITTER_CACHE_LINE_SIZE - sizeof(atomic_size_t) - sizeof(atomic_uint)];
+  atomic_size_t enqueue_position;
+  char          producer_padding[EVENTEMITTER_CACHE_LINE_SIZE - sizeof(atomic_size_t)];
+};
+
+// the process local view of the bus, the settings are copied once validated since other processes can write the shared header
+struct EventEmitterBus
+{
+  struct EventEmitterBusRing *ring;
+  char                       *cells;
+  size_t                     mapped_size;
+  size_t                     mask;
+  size_t                     cell_size;
+  size_t                     max_payload_size;
+  int                        fd;
+  bool                       dispatching;
+};
+
+// private functions
+static struct EventEmitterBus *_eventemitter_bus_map(int, size_t);
+static struct EventEmitterBusCell *_eventemitter_bus_get_cell(struct EventEmitterBus *, size_t);
+static bool _eventemitter_bus_has_events(struct EventEmitterBus *);
+
+struct EventEmitterBus *eventemitter_bus_create(size_t capacity, size_t max_payload_size)
+{
+  if (!capacity || max_payload_size > UINT32_MAX || capacity > SIZE_MAX / 2 / EVENTEMITTER_CACHE_LINE_SIZE)
+  {
+    return(NULL);
+  }
+
+  size_t cell_count = 2;
+  while (cell_count < capacity)
+  {
+    cell_count = cell_count * 2;
+  }
+  size_t cell_size = (sizeof(struct EventEmitterBusCell) + max_payload_size + EVENTEMITTER_CACHE_LINE_SIZE - 1) & ~(size_t)(EVENTEMITTER_CACHE_LINE_SIZE - 1);
+  if (cell_count > (SIZE_MAX - sizeof(struct EventEmitterBusRing)) / cell_size)
+  {
+    return(NULL);
+  }
+  size_t mapped_size = sizeof(struct EventEmitterBusRing) + cell_count * cell_size;
+  if (mapped_size > (size_t)INT64_MAX)
+  {
+    return(NULL);
+  }
+
+  int fd = memfd_create("eventemitter_bus", MFD_CLOEXEC);
+  if (fd < 0)
+  {
+    return(NULL);
+  }
+  if (ftruncate(fd, (off_t)mapped_size))
+  {
+    close(fd);
+    return(NULL);
+  }
+
+  struct EventEmitterBus *bus = _eventemitter_bus_map(fd, mapped_size);
+  if (bus == NULL)
+  {
+    close(fd);
+    return(NULL);
+  }
+
+  // the new file is zero filled, so only the settings and cell sequences are set
+  struct EventEmitterBusRing *ring = bus->ring;
+  ring->mask             = cell_count - 1;
+  ring->cell_size        = cell_size;
+  ring->max_payload_size = max_payload_size;
+  atomic_init(&ring->dequeue_position, 0);
+  atomic_init(&ring->sleeping, 0);
+  atomic_init(&ring->enqueue_position, 0);
+  bus->cells            = (char *)ring + sizeof(struct EventEmitterBusRing);
+  bus->mask             = cell_count - 1;
+  bus->cell_size        = cell_size;
+  bus->max_payload_size = max_payload_size;
+  for (size_t index = 0; index < cell_count; index++)
+  {
+    atomic_init(&_eventemitter_bus_get_cell(bus, index)->sequence, index);
+  }
+
+  // published last so processes opening the bus never see a partially initialized ring
+  atomic_thread_fence(memory_order_release);
+  ring->magic = EVENTEMITTER_BUS_MAGIC;
+
+  return(bus);
+} /* eventemitter_bus_create */
+
+
+struct EventEmitterBus *eventemitter_bus_open(int fd)
+{
+  struct stat file_stat;
+
+  if (fd < 0 || fstat(fd, &file_stat) || file_stat.st_size < (off_t)sizeof(struct EventEmitterBusRing))
+  {
+    return(NULL);
+  }
+
+  int bus_fd = fcntl(fd, F_DUPFD_CLOEXEC, 0);
+  if (bus_fd < 0)
+  {
+    return(NULL);
+  }
+
+  struct EventEmitterBus *bus = _eventemitter_bus_map(bus_fd, (size_t)file_stat.st_size);
+  if (bus == NULL)
+  {
+    close(bus_fd);
+    return(NULL);
+  }
+
+  // the settings are read once and must describe exactly the mapped memory, only the validated copies are used afterwards.
+  // the cell count must not wrap to 0 and cells must stay cache line aligned, same as created, so their atomics are aligned
+  struct EventEmitterBusRing *ring = bus->ring;
+  bool                       valid = ring->magic == EVENTEMITTER_BUS_MAGIC;
+  atomic_thread_fence(memory_order_acquire);
+  size_t mask             = ring->mask;
+  size_t cell_size        = ring->cell_size;
+  size_t max_payload_size = ring->max_payload_size;
+  size_t cell_count       = mask + 1;
+  if (  !valid
+     || !mask
+     || !cell_count
+     || (cell_count & mask)
+     || max_payload_size > UINT32_MAX
+     || cell_size % EVENTEMITTER_CACHE_LINE_SIZE
+     || cell_size < sizeof(struct EventEmitterBusCell) + max_payload_size
+     || cell_count > (bus->mapped_size - sizeof(struct EventEmitterBusRing)) / cell_size
+     || sizeof(struct EventEmitterBusRing) + cell_count * cell_size != bus->mapped_size)
+  {
+    eventemitter_bus_release(bus);
+    return(NULL);
+  }
+  bus->cells            = (char *)ring + sizeof(struct EventEmitterBusRing);
+  bus->mask             = mask;
+  bus->cell_size        = cell_size;
+  bus->max_payload_size = max_payload_size;
+
+  return(bus);
+} /* eventemitter_bus_open */
+
+
+void eventemitter_bus_release(struct EventEmitterBus *bus)
+{
+  if (bus == NULL)
+  {
+    return;
+  }
+
+  munmap(bus->ring, bus->mapped_size);
+  close(bus->fd);
+  _eventemitter_default_allocator.deallocate(bus, _eventemitter_default_allocator.context);
+}
+
+
+int eventemitter_bus_get_fd(struct EventEmitterBus *bus)
+{
+  if (bus == NULL)
+  {
+    return(-1);
+  }
+
+  return(bus->fd);
+}
+
+
+size_t eventemitter_bus_max_payload_size(struct EventEmitterBus *bus)
+{
+  if (bus == NULL)
+  {
+    return(0);
+  }
+
+  return(bus->max_payload_size);
+}
+
+
+bool eventemitter_bus_emit(struct EventEmitterBus *bus, int event_id, const void *payload, size_t size)
+{
+  if (bus == NULL || (payload == NULL && size) || size > bus->max_payload_size)
+  {
+    return(false);
+  }
+
+  struct EventEmitterBusRing *ring     = bus->ring;
+  struct EventEmitterBusCell *cell     = NULL;
+  size_t                     position = atomic_load_explicit(&ring->enqueue_position, memory_order_relaxed);
+  for ( ; ; )
+  {
+    cell = _eventemitter_bus_get_cell(bus, position);
+
+    // the cell is free when its sequence equals the position, and still used by the previous lap when it is behind
+    size_t   sequence   = atomic_load_explicit(&cell->sequence, memory_order_acquire);
+    intptr_t difference = (intptr_t)(sequence - position);
+    if (!difference)
+    {
+      if (atomic_compare_exchange_weak_explicit(&ring->enqueue_position, &position, position + 1, memory_order_relaxed, memory_order_relaxed))
+      {
+        break;
+      }
+    }
+    else if (difference < 0)
+    {
+      return(false);
+    }
+    else
+    {
+      position = atomic_load_explicit(&ring->enqueue_position, memory_order_relaxed);
+    }
+  }
+
+  cell->event_id = event_id;
+  cell->size     = (uint32_t)size;
+  if (size)
+  {
+    memcpy((char *)cell + sizeof(struct EventEmitterBusCell), payload, size);
+  }
+  atomic_store_explicit(&cell->sequence, position + 1, memory_order_release);
+
+  // pairs with the fence of a consumer going to sleep, so either it sees the event or the event sees it sleeping
+  atomic_thread_fence(memory_order_seq_cst);
+  if (atomic_load_explicit(&ring->sleeping, memory_order_relaxed) && atomic_exchange_explicit(&ring->sleeping, 0, memory_order_relaxed))
+  {
+    syscall(SYS_futex, &ring->sleeping, FUTEX_WAKE, 1, NULL, NULL, 0);
+  }
+
+  return(true);
+} /* eventemitter_bus_emit */
+
+
+int eventemitter_bus_dispatch(struct EventEmitterBus *bus, struct EventEmitter *event_emitter, size_t max_events)
+{
+  if (bus == NULL || event_emitter == NULL)
+  {
+    return(-1);
+  }
+  if (bus->dispatching)
+  {
+    return(0);
+  }
+
+  struct EventEmitterBusRing *ring     = bus->ring;
+  size_t                     position = atomic_load_explicit(&ring->dequeue_position, memory_order_relaxed);
+
+  // without a limit, only the events queued before the call are dispatched so producers can not keep it running
+  if (!max_events)
+  {
+    max_events = atomic_load_explicit(&ring->enqueue_position, memory_order_relaxed) - position;
+  }
+  if (max_events > INT_MAX)
+  {
+    max_events = INT_MAX;
+  }
+
+  bus->dispatching = true;
+  size_t count = 0;
+  while (count < max_events)
+  {
+    struct EventEmitterBusCell *cell = _eventemitter_bus_get_cell(bus, position);
+    if (atomic_load_explicit(&cell->sequence, memory_order_acquire) != position + 1)
+    {
+      break;
+    }
+
+    // the payload is passed in place, so the cell is handed back to the producers only once the listeners are done
+    struct EventEmitterBusPayload payload;
+    payload.data = (char *)cell + sizeof(struct EventEmitterBusCell);
+    payload.size = cell->size;
+    if (payload.size > bus->max_payload_size)
+    {
+      payload.size = bus->max_payload_size;
+    }
+    eventemitter_emit(event_emitter, cell->event_id, &payload);
+
+    atomic_store_explicit(&cell->sequence, position + bus->mask + 1, memory_order_release);
+    position++;
+    atomic_store_explicit(&ring->dequeue_position, position, memory_order_relaxed);
+    count++;
+  }
+  bus->dispatching = false;
+
+  return((int)count);
+} /* eventemitter_bus_dispatch */
+
+
+int eventemitter_bus_wait(struct EventEmitterBus *bus, int timeout)
+{
+  if (bus == NULL)
+  {
+    return(-1);
+  }
+
+  struct timespec deadline = { 0, 0 };
+  if (timeout >= 0)
+  {
+    if (clock_gettime(CLOCK_MONOTONIC, &deadline))
+    {
+      return(-1);
+    }
+    deadline.tv_sec  = deadline.tv_sec + timeout / 1000;
+    deadline.tv_nsec = deadline.tv_nsec + (timeout % 1000) * 1000000L;
+    if (deadline.tv_nsec >= 1000000000L)
+    {
+      deadline.tv_sec++;
+      deadline.tv_nsec = deadline.tv_nsec - 1000000000L;
+    }
+  }
+
+  struct EventEmitterBusRing *ring = bus->ring;
+  while (!_eventemitter_bus_has_events(bus))
+  {
+    atomic_store_explicit(&ring->sleeping, 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    if (_eventemitter_bus_has_events(bus))
+    {
+      atomic_store_explicit(&ring->sleeping, 0, memory_order_relaxed);
+      break;
+    }
+
+    // the futex wait timeout is relative
+    struct timespec remaining;
+    struct timespec *remaining_ptr = NULL;
+    if (timeout >= 0)
+    {
+      struct timespec now;
+      clock_gettime(CLOCK_MONOTONIC, &now);
+      remaining.tv_sec  = deadline.tv_sec - now.tv_sec;
+      remaining.tv_nsec = deadline.tv_nsec - now.tv_nsec;
+      if (remaining.tv_nsec < 0)
+      {
+        remaining.tv_sec--;
+        remaining.tv_nsec = remaining.tv_nsec + 1000000000L;
+      }
+      if (remaining.tv_sec < 0)
+      {
+        atomic_store_explicit(&ring->sleeping, 0, memory_order_relaxed);
+        return(_eventemitter_bus_has_events(bus) ? 1 : 0);
+      }
+      remaining_ptr = &remaining;
+    }
+
+    // a producer clearing the flag first makes the wait return right away
+    if (syscall(SYS_futex, &ring->sleeping, FUTEX_WAIT, 1, remaining_ptr, NULL, 0) && errno != EAGAIN && errno != EINTR && errno != ETIMEDOUT)
+    {
+      atomic_store_explicit(&ring->sleeping, 0, memory_order_relaxed);
+      return(-1);
+    }
+  }
+
+  return(1);
+} /* eventemitter_bus_wait */
+
+
+static struct EventEmitterBus *_eventemitter_bus_map(int fd, size_t mapped_size)
+{
+  struct EventEmitterBus *bus = _eventemitter_default_allocator.allocate(sizeof(struct EventEmitterBus), _eventemitter_default_allocator.context);
+
+  if (bus == NULL)
+  {
+    return(NULL);
+  }
+
+  void *memory = mmap(NULL, mapped_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (memory == MAP_FAILED)
+  {
+    _eventemitter_default_allocator.deallocate(bus, _eventemitter_default_allocator.context);
+    return(NULL);
+  }
+
+  bus->ring             = (struct EventEmitterBusRing *)memory;
+  bus->cells            = NULL;
+  bus->mapped_size      = mapped_size;
+  bus->mask             = 0;
+  bus->cell_size        = 0;
+  bus->max_payload_size = 0;
+  bus->fd               = fd;
+  bus->dispatching      = false;
+
+  return(bus);
+}
+
+
+static struct EventEmitterBusCell *_eventemitter_bus_get_cell(struct EventEmitterBus *bus, size_t position)
+{
+  return((struct EventEmitterBusCell *)(void *)(bus->cells + (position & bus->mask) * bus->cell_size));
+}
+
+
+static bool _eventemitter_bus_has_events(struct EventEmitterBus *bus)
+{
+  size_t position = atomic_load_explicit(&bus->ring->dequeue_position, memory_order_relaxed);
+
+  return(atomic_load_explicit(&_eventemitter_bus_get_cell(bus, position)->sequence, memory_order_acquire) == position + 1);
+}
+
+#endif
+
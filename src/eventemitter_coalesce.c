@@ -0,0 +1,181 @@
+#include "eventemitter_internal.h"
+#include <limits.h>
+#include <stdint.h>
+
+#define EVENTEMITTER_COALESCED_INITIAL_CAPACITY    16
+
+struct EventEmitterCoalescedEvent
+{
+  int  event_id;
+  void *event_data;
+};
+
+// pending events in order of their first occurrence, with an index from (event ID, key) to their position
+struct EventEmitterCoalescing
+{
+  enum EventEmitterCoalescePolicy   policy;
+  void                              *(*merge)(int event_id, void *queued_data, void *event_data, void *context);
+  void                              *context;
+  // (event ID, key) to the pending event position + 1, so the stored value is never NULL
+  struct EventEmitterMap            positions;
+  struct EventEmitterCoalescedEvent *events;
+  size_t                            count;
+  size_t                            capacity;
+  // the events of the running dispatch, swapped with the pending events so callbacks coalesce into the next dispatch
+  struct EventEmitterCoalescedEvent *dispatched;
+  size_t                            dispatched_capacity;
+  bool                              dispatching;
+};
+
+// private functions
+static uint64_t _eventemitter_coalescing_key(int, unsigned int);
+
+bool eventemitter_init_coalescing(struct EventEmitter *event_emitter, enum EventEmitterCoalescePolicy policy, void *(*merge)(int event_id, void *queued_data, void *event_data, void *context), void *context)
+{
+  if (  event_emitter == NULL
+     || event_emitter->coalescing != NULL
+     || (policy != EVENTEMITTER_COALESCE_KEEP_LAST && policy != EVENTEMITTER_COALESCE_KEEP_FIRST && policy != EVENTEMITTER_COALESCE_MERGE)
+     || (policy == EVENTEMITTER_COALESCE_MERGE && merge == NULL))
+  {
+    return(false);
+  }
+
+  struct EventEmitterCoalescing *coalescing = event_emitter->allocator.allocate(sizeof(struct EventEmitterCoalescing), event_emitter->allocator.context);
+  if (coalescing == NULL)
+  {
+    return(false);
+  }
+
+  if (!_eventemitter_map_init(&coalescing->positions, &event_emitter->allocator, EVENTEMITTER_COALESCED_INITIAL_CAPACITY))
+  {
+    event_emitter->allocator.deallocate(coalescing, event_emitter->allocator.context);
+    return(false);
+  }
+
+  coalescing->policy              = policy;
+  coalescing->merge               = merge;
+  coalescing->context             = context;
+  coalescing->events              = NULL;
+  coalescing->count               = 0;
+  coalescing->capacity            = 0;
+  coalescing->dispatched          = NULL;
+  coalescing->dispatched_capacity = 0;
+  coalescing->dispatching         = false;
+
+  event_emitter->coalescing = coalescing;
+
+  return(true);
+} /* eventemitter_init_coalescing */
+
+
+bool eventemitter_coalesce(struct EventEmitter *event_emitter, int event_id, unsigned int key, void *event_data)
+{
+  if (event_emitter == NULL || event_emitter->coalescing == NULL)
+  {
+    return(false);
+  }
+
+  struct EventEmitterCoalescing *coalescing = event_emitter->coalescing;
+  uint64_t                      map_key     = _eventemitter_coalescing_key(event_id, key);
+  size_t                        position    = (size_t)(uintptr_t)_eventemitter_map_get(&coalescing->positions, map_key);
+  if (position)
+  {
+    struct EventEmitterCoalescedEvent *event = &coalescing->events[position - 1];
+    if (coalescing->policy == EVENTEMITTER_COALESCE_KEEP_LAST)
+    {
+      event->event_data = event_data;
+    }
+    else if (coalescing->policy == EVENTEMITTER_COALESCE_MERGE)
+    {
+      event->event_data = coalescing->merge(event_id, event->event_data, event_data, coalescing->context);
+    }
+
+    return(true);
+  }
+
+  if (coalescing->count == coalescing->capacity)
+  {
+    size_t                            capacity = coalescing->capacity ? coalescing->capacity * 2 : EVENTEMITTER_COALESCED_INITIAL_CAPACITY;
+    struct EventEmitterCoalescedEvent *events  = event_emitter->allocator.reallocate(coalescing->events, capacity * sizeof(struct EventEmitterCoalescedEvent), event_emitter->allocator.context);
+    if (events == NULL)
+    {
+      return(false);
+    }
+    coalescing->events   = events;
+    coalescing->capacity = capacity;
+  }
+
+  if (!_eventemitter_map_put(&coalescing->positions, map_key, (void *)(uintptr_t)(coalescing->count + 1)))
+  {
+    return(false);
+  }
+
+  coalescing->events[coalescing->count].event_id   = event_id;
+  coalescing->events[coalescing->count].event_data = event_data;
+  coalescing->count++;
+
+  return(true);
+} /* eventemitter_coalesce */
+
+
+int eventemitter_dispatch_coalesced(struct EventEmitter *event_emitter)
+{
+  if (event_emitter == NULL)
+  {
+    return(-1);
+  }
+
+  // nested dispatches leave the events coalesced during the running dispatch to the next one
+  struct EventEmitterCoalescing *coalescing = event_emitter->coalescing;
+  if (coalescing == NULL || coalescing->dispatching || !coalescing->count)
+  {
+    return(0);
+  }
+
+  struct EventEmitterCoalescedEvent *events  = coalescing->events;
+  size_t                            count    = coalescing->count;
+  size_t                            capacity = coalescing->capacity;
+  coalescing->events              = coalescing->dispatched;
+  coalescing->capacity            = coalescing->dispatched_capacity;
+  coalescing->count               = 0;
+  coalescing->dispatched          = events;
+  coalescing->dispatched_capacity = capacity;
+  _eventemitter_map_clear(&coalescing->positions);
+
+  coalescing->dispatching = true;
+  for (size_t index = 0; index < count; index++)
+  {
+    eventemitter_emit(event_emitter, events[index].event_id, events[index].event_data);
+  }
+  coalescing->dispatching = false;
+
+  return(count > INT_MAX ? INT_MAX : (int)count);
+}
+
+
+void _eventemitter_coalescing_release(struct EventEmitter *event_emitter)
+{
+  struct EventEmitterCoalescing *coalescing = event_emitter->coalescing;
+
+  if (coalescing == NULL)
+  {
+    return;
+  }
+
+  _eventemitter_map_release(&coalescing->positions);
+  if (coalescing->events != NULL)
+  {
+    event_emitter->allocator.deallocate(coalescing->events, event_emitter->allocator.context);
+  }
+  if (coalescing->dispatched != NULL)
+  {
+    event_emitter->allocator.deallocate(coalescing->dispatched, event_emitter->allocator.context);
+  }
+  event_emitter->allocator.deallocate(coalescing, event_emitter->allocator.context);
+  event_emitter->coalescing = NULL;
+}
+
+static uint64_t _eventemitter_coalescing_key(int event_id, unsigned int key)
+{
+  return(((uint64_t)(unsigned int)event_id << 32) | (uint64_t)key);
+}
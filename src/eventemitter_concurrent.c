@@ -0,0 +1,800 @@
+#include "eventemitter_concurrent.h"
+#include "eventemitter_internal.h"
+
+#ifdef EVENTEMITTER_THREADS
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <string.h>
+
+#define EVENTEMITTER_CONCURRENT_READER_SLOTS    64
+#define EVENTEMITTER_CONCURRENT_MIN_BUCKETS     8
+#define EVENTEMITTER_CONCURRENT_STATS_PER_SLAB  64
+
+#ifdef EVENTEMITTER_STATS
+// the counters of an event, shared by all table versions and kept until the emitter is released
+struct EventEmitterConcurrentEventStats
+{
+  _Atomic uint64_t emits;
+  _Atomic uint64_t invocations;
+  // only updated under the writer lock
+  size_t           peak_listeners;
+};
+#endif
+
+struct EventEmitterConcurrentBucket
+{
+  int                                     event_id;
+  // empty buckets have no records
+  unsigned int                            count;
+  size_t                                  offset;
+#ifdef EVENTEMITTER_STATS
+  struct EventEmitterConcurrentEventStats *stats;
+#endif
+};
+
+struct EventEmitterConcurrentRecord
+{
+  union
+  {
+    void (*event)(void *event_data, void *context);
+    void (*unhandled)(int event_id, void *event_data, void *context);
+  }    callback;
+  void *context;
+};
+
+// immutable once published, the records of each event are stored contiguously
+struct EventEmitterConcurrentTable
+{
+  struct EventEmitterConcurrentBucket *buckets;
+  size_t                              bucket_mask;
+  unsigned int                        shift;
+  struct EventEmitterConcurrentRecord *records;
+  size_t                              unhandled_offset;
+  size_t                              unhandled_count;
+  // replaced tables are freed once the epoch advanced twice since they were replaced
+  size_t                              retired_epoch;
+  struct EventEmitterConcurrentTable  *next_retired;
+};
+
+// readers increment the counter of the epoch parity they started in, each slot is on its own cache line
+// emits also count into the slot of their thread, so the emitter counters are not shared by all threads
+struct EventEmitterConcurrentReaderSlot
+{
+  atomic_size_t    readers[2];
+#ifdef EVENTEMITTER_STATS
+  _Atomic uint64_t emits;
+  _Atomic uint64_t invocations;
+  _Atomic uint64_t unhandled;
+  char             padding[EVENTEMITTER_CACHE_LINE_SIZE - 2 * sizeof(atomic_size_t) - 3 * sizeof(uint64_t)];
+#else
+  char             padding[EVENTEMITTER_CACHE_LINE_SIZE - 2 * sizeof(atomic_size_t)];
+#endif
+};
+
+struct EventEmitterConcurrent
+{
+  struct EventEmitterAllocator                  allocator;
+  // the listeners source of truth, only accessed under the writer lock
+  struct EventEmitter                           *event_emitter;
+  pthread_mutex_t                               writer_lock;
+  _Atomic(struct EventEmitterConcurrentTable *) table;
+  atomic_size_t                                 epoch;
+  struct EventEmitterConcurrentTable            *retired_tables;
+  struct EventEmitterConcurrentReaderSlot       *reader_slots;
+#ifdef EVENTEMITTER_STATS
+  // the following are only accessed under the writer lock
+  size_t                                        peak_listeners;
+  struct EventEmitterMap                        event_stats;
+  struct EventEmitterPool                       event_stats_pool;
+#endif
+};
+
+static struct EventEmitterConcurrentBucket _eventemitter_concurrent_empty_buckets[EVENTEMITTER_CONCURRENT_MIN_BUCKETS];
+static struct EventEmitterConcurrentTable  _eventemitter_concurrent_empty_table =
+{
+  _eventemitter_concurrent_empty_buckets,
+  EVENTEMITTER_CONCURRENT_MIN_BUCKETS - 1,
+  61,
+  NULL,
+  0,
+  0,
+  0,
+  NULL
+};
+static atomic_size_t                       _eventemitter_concurrent_next_thread_slot = 0;
+static _Thread_local size_t                _eventemitter_concurrent_thread_slot      = SIZE_MAX;
+
+// private functions
+static struct EventEmitterConcurrent *_eventemitter_concurrent_new(const struct EventEmitterAllocator *);
+static unsigned int _eventemitter_concurrent_add_listener(struct EventEmitterConcurrent *, int, void (*callback)(void *, void *), void *, bool);
+static unsigned int _eventemitter_concurrent_commit_added(struct EventEmitterConcurrent *, unsigned int);
+static struct EventEmitterConcurrentTable *_eventemitter_concurrent_read_begin(struct EventEmitterConcurrent *, struct EventEmitterConcurrentReaderSlot **, size_t *);
+static void _eventemitter_concurrent_read_end(struct EventEmitterConcurrentReaderSlot *, size_t);
+static const struct EventEmitterConcurrentBucket *_eventemitter_concurrent_find(const struct EventEmitterConcurrentTable *, int);
+static size_t _eventemitter_concurrent_count_records(const struct EventEmitterEventListeners *, unsigned int);
+static size_t _eventemitter_concurrent_copy_records(struct EventEmitterConcurrentRecord *, const struct EventEmitterEventListeners *, unsigned int);
+static struct EventEmitterConcurrentTable *_eventemitter_concurrent_compile(struct EventEmitterConcurrent *, const int *, unsigned int);
+static void _eventemitter_concurrent_publish(struct EventEmitterConcurrent *, struct EventEmitterConcurrentTable *);
+static bool _eventemitter_concurrent_advance_epoch(struct EventEmitterConcurrent *);
+static void _eventemitter_concurrent_reclaim(struct EventEmitterConcurrent *);
+#ifdef EVENTEMITTER_STATS
+static struct EventEmitterConcurrentEventStats *_eventemitter_concurrent_stats_for_event_id(struct EventEmitterConcurrent *, int);
+static void _eventemitter_concurrent_copy_event_stats(struct EventEmitterStats *, const struct EventEmitterConcurrentEventStats *);
+#endif
+
+struct EventEmitterConcurrent *eventemitter_concurrent_new(void)
+{
+  return(_eventemitter_concurrent_new(&_eventemitter_default_allocator));
+}
+
+
+struct EventEmitterConcurrent *eventemitter_concurrent_new_with_allocator(const struct EventEmitterAllocator *allocator)
+{
+  if (allocator == NULL || allocator->allocate == NULL || allocator->reallocate == NULL || allocator->deallocate == NULL)
+  {
+    return(NULL);
+  }
+
+  return(_eventemitter_concurrent_new(allocator));
+}
+
+
+void eventemitter_concurrent_release(struct EventEmitterConcurrent *event_emitter)
+{
+  if (event_emitter == NULL)
+  {
+    return;
+  }
+
+  struct EventEmitterConcurrentTable *table = atomic_load_explicit(&event_emitter->table, memory_order_relaxed);
+  if (table != &_eventemitter_concurrent_empty_table)
+  {
+    _eventemitter_aligned_free(&event_emitter->allocator, table);
+  }
+  while (event_emitter->retired_tables != NULL)
+  {
+    table                         = event_emitter->retired_tables;
+    event_emitter->retired_tables = table->next_retired;
+    _eventemitter_aligned_free(&event_emitter->allocator, table);
+  }
+
+  pthread_mutex_destroy(&event_emitter->writer_lock);
+  eventemitter_release(event_emitter->event_emitter);
+#ifdef EVENTEMITTER_STATS
+  _eventemitter_map_release(&event_emitter->event_stats);
+  _eventemitter_pool_release(&event_emitter->event_stats_pool);
+#endif
+  _eventemitter_aligned_free(&event_emitter->allocator, event_emitter->reader_slots);
+
+  // the emitter is freed with its own allocator so a copy is needed
+  struct EventEmitterAllocator allocator = event_emitter->allocator;
+  allocator.deallocate(event_emitter, allocator.context);
+}
+
+
+unsigned int eventemitter_concurrent_add_listener(struct EventEmitterConcurrent *event_emitter, int event_id, void (*callback)(void *event_data, void *context), void *context)
+{
+  return(_eventemitter_concurrent_add_listener(event_emitter, event_id, callback, context, false));
+}
+
+
+unsigned int eventemitter_concurrent_prepend_listener(struct EventEmitterConcurrent *event_emitter, int event_id, void (*callback)(void *event_data, void *context), void *context)
+{
+  return(_eventemitter_concurrent_add_listener(event_emitter, event_id, callback, context, true));
+}
+
+
+unsigned int eventemitter_concurrent_add_unhandled_listener(struct EventEmitterConcurrent *event_emitter, void (*callback)(int event_id, void *event_data, void *context), void *context)
+{
+  if (event_emitter == NULL || callback == NULL)
+  {
+    return(0);
+  }
+
+  pthread_mutex_lock(&event_emitter->writer_lock);
+  unsigned int id = eventemitter_add_unhandled_listener(event_emitter->event_emitter, callback, context);
+  id = _eventemitter_concurrent_commit_added(event_emitter, id);
+  pthread_mutex_unlock(&event_emitter->writer_lock);
+
+  return(id);
+}
+
+
+int eventemitter_concurrent_remove_listener(struct EventEmitterConcurrent *event_emitter, unsigned int callback_id)
+{
+  if (event_emitter == NULL || !callback_id)
+  {
+    return(-1);
+  }
+
+  pthread_mutex_lock(&event_emitter->writer_lock);
+
+  // the new table is compiled before removing so a failure leaves everything unchanged
+  int result = 0;
+  if (_eventemitter_map_get(&event_emitter->event_emitter->listener_index, callback_id) != NULL)
+  {
+    struct EventEmitterConcurrentTable *table = _eventemitter_concurrent_compile(event_emitter, NULL, callback_id);
+    if (table == NULL)
+    {
+      result = -1;
+    }
+    else
+    {
+      eventemitter_remove_listener_by_id(event_emitter->event_emitter, callback_id);
+      _eventemitter_concurrent_publish(event_emitter, table);
+      result = 1;
+    }
+  }
+
+  pthread_mutex_unlock(&event_emitter->writer_lock);
+
+  return(result);
+}
+
+
+bool eventemitter_concurrent_remove_all_event_listeners(struct EventEmitterConcurrent *event_emitter, int event_id)
+{
+  if (event_emitter == NULL)
+  {
+    return(false);
+  }
+
+  pthread_mutex_lock(&event_emitter->writer_lock);
+
+  bool done = true;
+  if (eventemitter_listeners_count(event_emitter->event_emitter, event_id) > 0)
+  {
+    struct EventEmitterConcurrentTable *table = _eventemitter_concurrent_compile(event_emitter, &event_id, 0);
+    if (table == NULL)
+    {
+      done = false;
+    }
+    else
+    {
+      eventemitter_remove_all_event_listeners(event_emitter->event_emitter, event_id);
+      _eventemitter_concurrent_publish(event_emitter, table);
+    }
+  }
+
+  pthread_mutex_unlock(&event_emitter->writer_lock);
+
+  return(done);
+}
+
+
+bool eventemitter_concurrent_remove_all_listeners(struct EventEmitterConcurrent *event_emitter)
+{
+  if (event_emitter == NULL)
+  {
+    return(false);
+  }
+
+  pthread_mutex_lock(&event_emitter->writer_lock);
+  eventemitter_remove_all_listeners(event_emitter->event_emitter);
+  _eventemitter_concurrent_publish(event_emitter, &_eventemitter_concurrent_empty_table);
+  pthread_mutex_unlock(&event_emitter->writer_lock);
+
+  return(true);
+}
+
+
+int eventemitter_concurrent_listeners_count(struct EventEmitterConcurrent *event_emitter, int event_id)
+{
+  if (event_emitter == NULL)
+  {
+    return(-1);
+  }
+
+  struct EventEmitterConcurrentReaderSlot   *slot   = NULL;
+  size_t                                    parity  = 0;
+  const struct EventEmitterConcurrentTable  *table  = _eventemitter_concurrent_read_begin(event_emitter, &slot, &parity);
+  const struct EventEmitterConcurrentBucket *bucket = _eventemitter_concurrent_find(table, event_id);
+  int                                       count   = bucket == NULL ? 0 : (int)bucket->count;
+  _eventemitter_concurrent_read_end(slot, parity);
+
+  return(count);
+}
+
+
+int eventemitter_concurrent_emit(struct EventEmitterConcurrent *event_emitter, int event_id, void *event_data)
+{
+  if (event_emitter == NULL)
+  {
+    return(-1);
+  }
+
+  struct EventEmitterConcurrentReaderSlot   *slot            = NULL;
+  size_t                                    parity           = 0;
+  int                                       callback_counter = 0;
+  const struct EventEmitterConcurrentTable  *table           = _eventemitter_concurrent_read_begin(event_emitter, &slot, &parity);
+  const struct EventEmitterConcurrentBucket *bucket          = _eventemitter_concurrent_find(table, event_id);
+  if (bucket != NULL)
+  {
+    const struct EventEmitterConcurrentRecord *records = &table->records[bucket->offset];
+    for (size_t index = 0; index < bucket->count; index++)
+    {
+      records[index].callback.event(event_data, records[index].context);
+      callback_counter++;
+    }
+#ifdef EVENTEMITTER_STATS
+    atomic_fetch_add_explicit(&slot->invocations, (uint64_t)callback_counter, memory_order_relaxed);
+    atomic_fetch_add_explicit(&bucket->stats->emits, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&bucket->stats->invocations, (uint64_t)callback_counter, memory_order_relaxed);
+#endif
+  }
+  else
+  {
+    for (size_t index = table->unhandled_offset; index < table->unhandled_offset + table->unhandled_count; index++)
+    {
+      table->records[index].callback.unhandled(event_id, event_data, table->records[index].context);
+      callback_counter++;
+    }
+#ifdef EVENTEMITTER_STATS
+    atomic_fetch_add_explicit(&slot->unhandled, 1, memory_order_relaxed);
+#endif
+  }
+#ifdef EVENTEMITTER_STATS
+  atomic_fetch_add_explicit(&slot->emits, 1, memory_order_relaxed);
+#endif
+  _eventemitter_concurrent_read_end(slot, parity);
+
+  return(callback_counter);
+}
+
+#ifdef EVENTEMITTER_STATS
+
+
+bool eventemitter_concurrent_get_stats(struct EventEmitterConcurrent *event_emitter, struct EventEmitterStats *stats)
+{
+  if (event_emitter == NULL || stats == NULL)
+  {
+    return(false);
+  }
+
+  memset(stats, 0, sizeof(struct EventEmitterStats));
+  for (size_t index = 0; index < EVENTEMITTER_CONCURRENT_READER_SLOTS; index++)
+  {
+    struct EventEmitterConcurrentReaderSlot *slot = &event_emitter->reader_slots[index];
+    stats->emits       = stats->emits + atomic_load_explicit(&slot->emits, memory_order_relaxed);
+    stats->invocations = stats->invocations + atomic_load_explicit(&slot->invocations, memory_order_relaxed);
+    stats->unhandled   = stats->unhandled + atomic_load_explicit(&slot->unhandled, memory_order_relaxed);
+  }
+
+  pthread_mutex_lock(&event_emitter->writer_lock);
+  stats->peak_listeners = event_emitter->peak_listeners;
+  pthread_mutex_unlock(&event_emitter->writer_lock);
+
+  return(true);
+}
+
+
+bool eventemitter_concurrent_get_event_stats(struct EventEmitterConcurrent *event_emitter, int event_id, struct EventEmitterStats *stats)
+{
+  if (event_emitter == NULL || stats == NULL)
+  {
+    return(false);
+  }
+
+  pthread_mutex_lock(&event_emitter->writer_lock);
+  const struct EventEmitterConcurrentEventStats *event_stats = _eventemitter_map_get(&event_emitter->event_stats, (uint64_t)(unsigned int)event_id);
+  if (event_stats != NULL)
+  {
+    _eventemitter_concurrent_copy_event_stats(stats, event_stats);
+  }
+  pthread_mutex_unlock(&event_emitter->writer_lock);
+
+  return(event_stats != NULL);
+}
+
+
+bool eventemitter_concurrent_iterate_event_stats(struct EventEmitterConcurrent *event_emitter, void (*callback)(int event_id, const struct EventEmitterStats *stats, void *context), void *context)
+{
+  if (event_emitter == NULL || callback == NULL)
+  {
+    return(false);
+  }
+
+  pthread_mutex_lock(&event_emitter->writer_lock);
+  const struct EventEmitterMap *map = &event_emitter->event_stats;
+  for (size_t index = 0; index < map->capacity; index++)
+  {
+    if (map->entries[index].value != NULL)
+    {
+      struct EventEmitterStats stats;
+      _eventemitter_concurrent_copy_event_stats(&stats, map->entries[index].value);
+      callback((int)(unsigned int)map->entries[index].key, &stats, context);
+    }
+  }
+  pthread_mutex_unlock(&event_emitter->writer_lock);
+
+  return(true);
+}
+
+#endif
+
+static struct EventEmitterConcurrent *_eventemitter_concurrent_new(const struct EventEmitterAllocator *allocator)
+{
+  struct EventEmitterConcurrent *event_emitter = allocator->allocate(sizeof(struct EventEmitterConcurrent), allocator->context);
+
+  if (event_emitter == NULL)
+  {
+    return(NULL);
+  }
+
+  event_emitter->allocator      = *allocator;
+  event_emitter->retired_tables = NULL;
+  atomic_init(&event_emitter->table, &_eventemitter_concurrent_empty_table);
+  atomic_init(&event_emitter->epoch, 0);
+#ifdef EVENTEMITTER_STATS
+  event_emitter->peak_listeners = 0;
+  _eventemitter_pool_init(&event_emitter->event_stats_pool, &event_emitter->allocator, sizeof(struct EventEmitterConcurrentEventStats), EVENTEMITTER_CONCURRENT_STATS_PER_SLAB);
+  if (!_eventemitter_map_init(&event_emitter->event_stats, &event_emitter->allocator, 0))
+  {
+    allocator->deallocate(event_emitter, allocator->context);
+    return(NULL);
+  }
+#endif
+
+  event_emitter->event_emitter = eventemitter_new_with_allocator(&event_emitter->allocator);
+  event_emitter->reader_slots  = _eventemitter_aligned_alloc(&event_emitter->allocator, EVENTEMITTER_CONCURRENT_READER_SLOTS * sizeof(struct EventEmitterConcurrentReaderSlot));
+  if (event_emitter->event_emitter == NULL || event_emitter->reader_slots == NULL || pthread_mutex_init(&event_emitter->writer_lock, NULL))
+  {
+    eventemitter_release(event_emitter->event_emitter);
+    _eventemitter_aligned_free(&event_emitter->allocator, event_emitter->reader_slots);
+#ifdef EVENTEMITTER_STATS
+    _eventemitter_map_release(&event_emitter->event_stats);
+#endif
+    allocator->deallocate(event_emitter, allocator->context);
+    return(NULL);
+  }
+
+  for (size_t index = 0; index < EVENTEMITTER_CONCURRENT_READER_SLOTS; index++)
+  {
+    atomic_init(&event_emitter->reader_slots[index].readers[0], 0);
+    atomic_init(&event_emitter->reader_slots[index].readers[1], 0);
+#ifdef EVENTEMITTER_STATS
+    atomic_init(&event_emitter->reader_slots[index].emits, 0);
+    atomic_init(&event_emitter->reader_slots[index].invocations, 0);
+    atomic_init(&event_emitter->reader_slots[index].unhandled, 0);
+#endif
+  }
+
+  return(event_emitter);
+}
+
+
+static unsigned int _eventemitter_concurrent_add_listener(struct EventEmitterConcurrent *event_emitter, int event_id, void (*callback)(void *event_data, void *context), void *context, bool prepend)
+{
+  if (event_emitter == NULL || callback == NULL)
+  {
+    return(0);
+  }
+
+  pthread_mutex_lock(&event_emitter->writer_lock);
+  unsigned int id = 0;
+  if (prepend)
+  {
+    id = eventemitter_prepend_listener(event_emitter->event_emitter, event_id, callback, context);
+  }
+  else
+  {
+    id = eventemitter_add_listener(event_emitter->event_emitter, event_id, callback, context);
+  }
+  id = _eventemitter_concurrent_commit_added(event_emitter, id);
+  pthread_mutex_unlock(&event_emitter->writer_lock);
+
+  return(id);
+}
+
+
+static unsigned int _eventemitter_concurrent_commit_added(struct EventEmitterConcurrent *event_emitter, unsigned int callback_id)
+{
+  if (!callback_id)
+  {
+    return(0);
+  }
+
+  // in case the new table can not be created, the listener is removed so nothing is changed
+  struct EventEmitterConcurrentTable *table = _eventemitter_concurrent_compile(event_emitter, NULL, 0);
+  if (table == NULL)
+  {
+    eventemitter_remove_listener_by_id(event_emitter->event_emitter, callback_id);
+    return(0);
+  }
+
+  _eventemitter_concurrent_publish(event_emitter, table);
+
+  return(callback_id);
+}
+
+
+static struct EventEmitterConcurrentTable *_eventemitter_concurrent_read_begin(struct EventEmitterConcurrent *event_emitter, struct EventEmitterConcurrentReaderSlot **slot, size_t *parity)
+{
+  if (_eventemitter_concurrent_thread_slot == SIZE_MAX)
+  {
+    // threads are spread over the slots so readers on different cores rarely share a cache line
+    _eventemitter_concurrent_thread_slot = atomic_fetch_add_explicit(&_eventemitter_concurrent_next_thread_slot, 1, memory_order_relaxed) % EVENTEMITTER_CONCURRENT_READER_SLOTS;
+  }
+
+  // the reader is registered before loading the table, so a writer that replaced the table
+  // either sees the reader or the reader loads the new table
+  *slot   = &event_emitter->reader_slots[_eventemitter_concurrent_thread_slot];
+  *parity = atomic_load(&event_emitter->epoch) & 1;
+  atomic_fetch_add(&(*slot)->readers[*parity], 1);
+
+  return(atomic_load(&event_emitter->table));
+}
+
+
+static void _eventemitter_concurrent_read_end(struct EventEmitterConcurrentReaderSlot *slot, size_t parity)
+{
+  atomic_fetch_sub_explicit(&slot->readers[parity], 1, memory_order_release);
+}
+
+
+static const struct EventEmitterConcurrentBucket *_eventemitter_concurrent_find(const struct EventEmitterConcurrentTable *table, int event_id)
+{
+  size_t index = (size_t)(((uint64_t)(unsigned int)event_id * 0x9E3779B97F4A7C15ULL) >> table->shift);
+
+  while (table->buckets[index].count)
+  {
+    if (table->buckets[index].event_id == event_id)
+    {
+      return(&table->buckets[index]);
+    }
+
+    index = (index + 1) & table->bucket_mask;
+  }
+
+  return(NULL);
+}
+
+
+static size_t _eventemitter_concurrent_count_records(const struct EventEmitterEventListeners *listeners, unsigned int excluded_callback_id)
+{
+  size_t count = 0;
+
+  for (size_t index = 0; index < listeners->count; index++)
+  {
+    if (listeners->listeners[index].id && listeners->listeners[index].id != excluded_callback_id)
+    {
+      count++;
+    }
+  }
+
+  return(count);
+}
+
+
+static size_t _eventemitter_concurrent_copy_records(struct EventEmitterConcurrentRecord *records, const struct EventEmitterEventListeners *listeners, unsigned int excluded_callback_id)
+{
+  size_t count = 0;
+
+  for (size_t index = 0; index < listeners->count; index++)
+  {
+    const struct EventEmitterEventListener *listener = &listeners->listeners[index];
+
+    if (listener->id && listener->id != excluded_callback_id)
+    {
+      records[count].callback.event = listener->callback.event;
+      records[count].context        = listener->context;
+      count++;
+    }
+  }
+
+  return(count);
+}
+
+
+static struct EventEmitterConcurrentTable *_eventemitter_concurrent_compile(struct EventEmitterConcurrent *event_emitter, const int *excluded_event_id, unsigned int excluded_callback_id)
+{
+  // creates a table from the current listeners, without the excluded event/listener
+  const struct EventEmitterMap *map         = &event_emitter->event_emitter->event_listeners;
+  size_t                       bucket_count = 0;
+  size_t                       record_count = _eventemitter_concurrent_count_records(&event_emitter->event_emitter->unhandled_listeners, excluded_callback_id);
+
+  for (size_t index = 0; index < map->capacity; index++)
+  {
+    const struct EventEmitterEventListeners *listeners = map->entries[index].value;
+    if (listeners != NULL && (excluded_event_id == NULL || listeners->event_id != *excluded_event_id))
+    {
+      size_t count = _eventemitter_concurrent_count_records(listeners, excluded_callback_id);
+      if (count)
+      {
+        bucket_count++;
+        record_count = record_count + count;
+      }
+    }
+  }
+
+  // keep the load factor under 50%
+  size_t       capacity = EVENTEMITTER_CONCURRENT_MIN_BUCKETS;
+  unsigned int shift    = 61;
+  while (capacity < bucket_count * 2)
+  {
+    capacity = capacity * 2;
+    shift--;
+  }
+
+  size_t                             header_size = (sizeof(struct EventEmitterConcurrentTable) + EVENTEMITTER_CACHE_LINE_SIZE - 1) & ~(size_t)(EVENTEMITTER_CACHE_LINE_SIZE - 1);
+  size_t                             bucket_size = capacity * sizeof(struct EventEmitterConcurrentBucket);
+  struct EventEmitterConcurrentTable *table      = _eventemitter_aligned_alloc(&event_emitter->allocator, header_size + bucket_size + record_count * sizeof(struct EventEmitterConcurrentRecord));
+  if (table == NULL)
+  {
+    return(NULL);
+  }
+
+  table->buckets      = (struct EventEmitterConcurrentBucket *)(void *)((char *)table + header_size);
+  table->bucket_mask  = capacity - 1;
+  table->shift        = shift;
+  table->records      = (struct EventEmitterConcurrentRecord *)(void *)((char *)table + header_size + bucket_size);
+  table->next_retired = NULL;
+  memset(table->buckets, 0, bucket_size);
+
+  size_t offset = 0;
+  for (size_t index = 0; index < map->capacity; index++)
+  {
+    const struct EventEmitterEventListeners *listeners = map->entries[index].value;
+    if (listeners == NULL || (excluded_event_id != NULL && listeners->event_id == *excluded_event_id))
+    {
+      continue;
+    }
+
+    size_t count = _eventemitter_concurrent_copy_records(&table->records[offset], listeners, excluded_callback_id);
+    if (count)
+    {
+      size_t bucket_index = (size_t)(((uint64_t)(unsigned int)listeners->event_id * 0x9E3779B97F4A7C15ULL) >> shift);
+      while (table->buckets[bucket_index].count)
+      {
+        bucket_index = (bucket_index + 1) & table->bucket_mask;
+      }
+
+      table->buckets[bucket_index].event_id = listeners->event_id;
+      table->buckets[bucket_index].count    = (unsigned int)count;
+      table->buckets[bucket_index].offset   = offset;
+      offset                                = offset + count;
+#ifdef EVENTEMITTER_STATS
+      table->buckets[bucket_index].stats = _eventemitter_concurrent_stats_for_event_id(event_emitter, listeners->event_id);
+      if (table->buckets[bucket_index].stats == NULL)
+      {
+        _eventemitter_aligned_free(&event_emitter->allocator, table);
+        return(NULL);
+      }
+#endif
+    }
+  }
+
+  table->unhandled_offset = offset;
+  table->unhandled_count  = _eventemitter_concurrent_copy_records(&table->records[offset], &event_emitter->event_emitter->unhandled_listeners, excluded_callback_id);
+
+#ifdef EVENTEMITTER_STATS
+  // the peaks are only updated once the table is created, so a failure does not change them
+  for (size_t index = 0; index < capacity; index++)
+  {
+    struct EventEmitterConcurrentBucket *bucket = &table->buckets[index];
+    if (bucket->count && bucket->count > bucket->stats->peak_listeners)
+    {
+      bucket->stats->peak_listeners = bucket->count;
+    }
+  }
+  if (record_count > event_emitter->peak_listeners)
+  {
+    event_emitter->peak_listeners = record_count;
+  }
+#endif
+
+  return(table);
+} /* _eventemitter_concurrent_compile */
+
+
+static void _eventemitter_concurrent_publish(struct EventEmitterConcurrent *event_emitter, struct EventEmitterConcurrentTable *table)
+{
+  struct EventEmitterConcurrentTable *old_table = atomic_load_explicit(&event_emitter->table, memory_order_relaxed);
+
+  atomic_store(&event_emitter->table, table);
+
+  // emits may still be reading the old table, so it is only freed later
+  if (old_table != &_eventemitter_concurrent_empty_table)
+  {
+    old_table->retired_epoch      = atomic_load_explicit(&event_emitter->epoch, memory_order_relaxed);
+    old_table->next_retired       = event_emitter->retired_tables;
+    event_emitter->retired_tables = old_table;
+  }
+
+  _eventemitter_concurrent_reclaim(event_emitter);
+}
+
+
+static bool _eventemitter_concurrent_advance_epoch(struct EventEmitterConcurrent *event_emitter)
+{
+  // the epoch can only advance once all readers that started two epochs ago are done
+  size_t epoch  = atomic_load_explicit(&event_emitter->epoch, memory_order_relaxed);
+  size_t parity = (epoch + 1) & 1;
+
+  for (size_t index = 0; index < EVENTEMITTER_CONCURRENT_READER_SLOTS; index++)
+  {
+    if (atomic_load(&event_emitter->reader_slots[index].readers[parity]))
+    {
+      return(false);
+    }
+  }
+
+  atomic_store(&event_emitter->epoch, epoch + 1);
+
+  return(true);
+}
+
+
+static void _eventemitter_concurrent_reclaim(struct EventEmitterConcurrent *event_emitter)
+{
+  // never waits for readers (so callbacks may change listeners), tables not yet safe to free are kept for the next writes
+  for (size_t index = 0; index < 2 && event_emitter->retired_tables != NULL; index++)
+  {
+    if (!_eventemitter_concurrent_advance_epoch(event_emitter))
+    {
+      break;
+    }
+  }
+
+  // tables are retired in order, so once a table can be freed all older tables can be freed as well
+  size_t                             epoch  = atomic_load_explicit(&event_emitter->epoch, memory_order_relaxed);
+  struct EventEmitterConcurrentTable **next = &event_emitter->retired_tables;
+  while (*next != NULL && (*next)->retired_epoch + 2 > epoch)
+  {
+    next = &(*next)->next_retired;
+  }
+  while (*next != NULL)
+  {
+    struct EventEmitterConcurrentTable *table = *next;
+    *next = table->next_retired;
+    _eventemitter_aligned_free(&event_emitter->allocator, table);
+  }
+}
+
+#ifdef EVENTEMITTER_STATS
+
+
+static struct EventEmitterConcurrentEventStats *_eventemitter_concurrent_stats_for_event_id(struct EventEmitterConcurrent *event_emitter, int event_id)
+{
+  uint64_t                                key    = (uint64_t)(unsigned int)event_id;
+  struct EventEmitterConcurrentEventStats *stats = _eventemitter_map_get(&event_emitter->event_stats, key);
+
+  if (stats != NULL)
+  {
+    return(stats);
+  }
+
+  stats = _eventemitter_pool_alloc(&event_emitter->event_stats_pool);
+  if (stats == NULL)
+  {
+    return(NULL);
+  }
+  atomic_init(&stats->emits, 0);
+  atomic_init(&stats->invocations, 0);
+  stats->peak_listeners = 0;
+
+  if (!_eventemitter_map_put(&event_emitter->event_stats, key, stats))
+  {
+    _eventemitter_pool_free(&event_emitter->event_stats_pool, stats);
+    return(NULL);
+  }
+
+  return(stats);
+}
+
+
+static void _eventemitter_concurrent_copy_event_stats(struct EventEmitterStats *stats, const struct EventEmitterConcurrentEventStats *event_stats)
+{
+  // emits of an event with listeners are never unhandled and 'once' listeners are not supported
+  stats->emits          = atomic_load_explicit(&event_stats->emits, memory_order_relaxed);
+  stats->invocations    = atomic_load_explicit(&event_stats->invocations, memory_order_relaxed);
+  stats->unhandled      = 0;
+  stats->once_removals  = 0;
+  stats->peak_listeners = event_stats->peak_listeners;
+}
+
+#endif
+#endif
+
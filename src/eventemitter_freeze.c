@@ -0,0 +1,430 @@
+#include "eventemitter_internal.h"
+#include <stdint.h>
+#include <string.h>
+
+#define EVENTEMITTER_FROZEN_KEYS_PER_BUCKET    2
+#define EVENTEMITTER_FROZEN_SALTS              4
+
+struct EventEmitterFrozenSlot
+{
+  int          event_id;
+  // empty slots (only left when the table could not be made minimal) have no records
+  unsigned int count;
+  size_t       offset;
+};
+
+struct EventEmitterFrozenRecord
+{
+  union
+  {
+    void (*event)(void *event_data, void *context);
+    void (*unhandled)(int event_id, void *event_data, void *context);
+  }    callback;
+  void *context;
+};
+
+// immutable once created, the hash of an event ID selects a bucket whose seed maps
+// all the event IDs of the bucket to slots which are not used by any other event ID
+struct EventEmitterFrozen
+{
+  uint64_t                        salt;
+  size_t                          bucket_count;
+  uint32_t                        *seeds;
+  size_t                          slot_count;
+  struct EventEmitterFrozenSlot   *slots;
+  // the records of each event are stored contiguously, followed by the unhandled events listeners
+  struct EventEmitterFrozenRecord *records;
+  // the callback IDs of the records, only read by traced emits
+  unsigned int                    *ids;
+  size_t                          unhandled_offset;
+  size_t                          unhandled_count;
+};
+
+struct EventEmitterFrozenKey
+{
+  int                                     event_id;
+  size_t                                  slot;
+  const struct EventEmitterEventListeners *listeners;
+};
+
+// temporary state while searching for the bucket seeds
+struct EventEmitterFrozenBuild
+{
+  const struct EventEmitterAllocator *allocator;
+  struct EventEmitterFrozenKey       *keys;
+  // keys grouped by bucket, the keys of bucket i start at starts[i]
+  struct EventEmitterFrozenKey       *sorted;
+  size_t                             *starts;
+  uint32_t                           *seeds;
+  bool                               *occupied;
+  size_t                             key_count;
+  size_t                             bucket_count;
+  size_t                             slot_count;
+  uint64_t                           salt;
+};
+
+// private functions
+static uint64_t _eventemitter_frozen_hash(int, uint64_t);
+static size_t _eventemitter_frozen_reduce(uint64_t, size_t);
+static size_t _eventemitter_frozen_bucket(int, uint64_t, size_t);
+static size_t _eventemitter_frozen_slot(int, uint64_t, uint32_t, size_t);
+static const struct EventEmitterFrozenSlot *_eventemitter_frozen_find(const struct EventEmitterFrozen *, int);
+static size_t _eventemitter_frozen_copy_records(struct EventEmitterFrozenRecord *, unsigned int *, const struct EventEmitterEventListeners *);
+static bool _eventemitter_frozen_place(struct EventEmitterFrozenBuild *);
+static bool _eventemitter_frozen_place_bucket(struct EventEmitterFrozenBuild *, size_t);
+static void _eventemitter_frozen_build_release(struct EventEmitterFrozenBuild *);
+
+struct EventEmitterFrozen *_eventemitter_frozen_new(const struct EventEmitterAllocator *allocator, struct EventEmitterEventListeners **listeners, size_t count, const struct EventEmitterEventListeners *unhandled_listeners)
+{
+  if (count > UINT32_MAX)
+  {
+    return(NULL);
+  }
+
+  struct EventEmitterFrozenBuild build;
+  memset(&build, 0, sizeof(build));
+  build.allocator    = allocator;
+  build.key_count    = count;
+  build.bucket_count = count / EVENTEMITTER_FROZEN_KEYS_PER_BUCKET + 1;
+  build.slot_count   = count;
+  build.keys         = allocator->allocate((count + 1) * sizeof(struct EventEmitterFrozenKey), allocator->context);
+  build.sorted       = allocator->allocate((count + 1) * sizeof(struct EventEmitterFrozenKey), allocator->context);
+  build.starts       = allocator->allocate((build.bucket_count + 1) * sizeof(size_t), allocator->context);
+  build.seeds        = allocator->allocate(build.bucket_count * sizeof(uint32_t), allocator->context);
+  build.occupied     = allocator->allocate(count + 1, allocator->context);
+  if (build.keys == NULL || build.sorted == NULL || build.starts == NULL || build.seeds == NULL || build.occupied == NULL)
+  {
+    _eventemitter_frozen_build_release(&build);
+    return(NULL);
+  }
+
+  size_t record_count = unhandled_listeners->count - unhandled_listeners->removed;
+  for (size_t index = 0; index < count; index++)
+  {
+    build.keys[index].event_id  = listeners[index]->event_id;
+    build.keys[index].slot      = 0;
+    build.keys[index].listeners = listeners[index];
+    record_count                = record_count + listeners[index]->count - listeners[index]->removed;
+  }
+
+  // a few salts are tried for a minimal table, after which the table grows to make the search easier
+  for (size_t attempt = 1; !_eventemitter_frozen_place(&build); attempt++)
+  {
+    build.salt = (uint64_t)attempt * 0x9E3779B97F4A7C15ULL;
+    if (!(attempt % EVENTEMITTER_FROZEN_SALTS))
+    {
+      build.slot_count = build.slot_count + build.slot_count / 8 + 1;
+      allocator->deallocate(build.occupied, allocator->context);
+      build.occupied = build.slot_count <= UINT32_MAX ? allocator->allocate(build.slot_count, allocator->context) : NULL;
+      if (build.occupied == NULL)
+      {
+        _eventemitter_frozen_build_release(&build);
+        return(NULL);
+      }
+    }
+  }
+
+  size_t                    header_size  = (sizeof(struct EventEmitterFrozen) + EVENTEMITTER_CACHE_LINE_SIZE - 1) & ~(size_t)(EVENTEMITTER_CACHE_LINE_SIZE - 1);
+  size_t                    records_size = record_count * sizeof(struct EventEmitterFrozenRecord);
+  size_t                    slots_size   = build.slot_count * sizeof(struct EventEmitterFrozenSlot);
+  size_t                    seeds_size   = build.bucket_count * sizeof(uint32_t);
+  struct EventEmitterFrozen *frozen      = _eventemitter_aligned_alloc(allocator, header_size + records_size + slots_size + seeds_size + record_count * sizeof(unsigned int));
+  if (frozen == NULL)
+  {
+    _eventemitter_frozen_build_release(&build);
+    return(NULL);
+  }
+
+  frozen->salt         = build.salt;
+  frozen->bucket_count = build.bucket_count;
+  frozen->slot_count   = build.slot_count;
+  frozen->records      = (struct EventEmitterFrozenRecord *)(void *)((char *)frozen + header_size);
+  frozen->slots        = (struct EventEmitterFrozenSlot *)(void *)((char *)frozen + header_size + records_size);
+  frozen->seeds        = (uint32_t *)(void *)((char *)frozen + header_size + records_size + slots_size);
+  frozen->ids          = (unsigned int *)(void *)((char *)frozen + header_size + records_size + slots_size + seeds_size);
+  memset(frozen->slots, 0, slots_size);
+  memcpy(frozen->seeds, build.seeds, seeds_size);
+
+  // the records are stored by slot order, so the slots temporarily hold the index of their key
+  for (size_t index = 0; index < count; index++)
+  {
+    frozen->slots[build.sorted[index].slot].offset = index;
+    frozen->slots[build.sorted[index].slot].count  = 1;
+  }
+  size_t offset = 0;
+  for (size_t index = 0; index < frozen->slot_count; index++)
+  {
+    struct EventEmitterFrozenSlot *slot = &frozen->slots[index];
+    if (slot->count)
+    {
+      struct EventEmitterFrozenKey *key = &build.sorted[slot->offset];
+      slot->event_id = key->event_id;
+      slot->offset   = offset;
+      slot->count    = (unsigned int)_eventemitter_frozen_copy_records(&frozen->records[offset], &frozen->ids[offset], key->listeners);
+      offset         = offset + slot->count;
+    }
+  }
+  frozen->unhandled_offset = offset;
+  frozen->unhandled_count  = _eventemitter_frozen_copy_records(&frozen->records[offset], &frozen->ids[offset], unhandled_listeners);
+
+  _eventemitter_frozen_build_release(&build);
+
+  return(frozen);
+} /* _eventemitter_frozen_new */
+
+
+void _eventemitter_frozen_release(const struct EventEmitterAllocator *allocator, struct EventEmitterFrozen *frozen)
+{
+  _eventemitter_aligned_free(allocator, frozen);
+}
+
+
+int _eventemitter_frozen_emit(const struct EventEmitterFrozen *frozen, int event_id, void *event_data)
+{
+  const struct EventEmitterFrozenSlot *slot = _eventemitter_frozen_find(frozen, event_id);
+
+  if (slot != NULL)
+  {
+    const struct EventEmitterFrozenRecord *records = &frozen->records[slot->offset];
+    for (size_t index = 0; index < slot->count; index++)
+    {
+      records[index].callback.event(event_data, records[index].context);
+    }
+
+    return((int)slot->count);
+  }
+
+  const struct EventEmitterFrozenRecord *records = &frozen->records[frozen->unhandled_offset];
+  for (size_t index = 0; index < frozen->unhandled_count; index++)
+  {
+    records[index].callback.unhandled(event_id, event_data, records[index].context);
+  }
+
+  return((int)frozen->unhandled_count);
+}
+
+#ifdef EVENTEMITTER_TRACE
+
+
+int _eventemitter_frozen_trace_emit(const struct EventEmitterFrozen *frozen, int event_id, void *event_data, const struct EventEmitterTraceHooks *hooks)
+{
+  // same as the untraced emit, the hooks are read on every use since callbacks may change them
+  const struct EventEmitterFrozenSlot *slot  = _eventemitter_frozen_find(frozen, event_id);
+  size_t                              offset = slot != NULL ? slot->offset : frozen->unhandled_offset;
+  size_t                              count  = slot != NULL ? slot->count : frozen->unhandled_count;
+
+  if (hooks->pre_emit != NULL)
+  {
+    hooks->pre_emit(event_id, _eventemitter_trace_now(), hooks->context);
+  }
+
+  for (size_t index = offset; index < offset + count; index++)
+  {
+    const struct EventEmitterFrozenRecord *record = &frozen->records[index];
+
+    if (hooks->pre_listener != NULL)
+    {
+      hooks->pre_listener(event_id, frozen->ids[index], _eventemitter_trace_now(), hooks->context);
+    }
+    if (slot != NULL)
+    {
+      record->callback.event(event_data, record->context);
+    }
+    else
+    {
+      record->callback.unhandled(event_id, event_data, record->context);
+    }
+    if (hooks->post_listener != NULL)
+    {
+      hooks->post_listener(event_id, frozen->ids[index], _eventemitter_trace_now(), hooks->context);
+    }
+  }
+
+  if (hooks->post_emit != NULL)
+  {
+    hooks->post_emit(event_id, (int)count, _eventemitter_trace_now(), hooks->context);
+  }
+
+  return((int)count);
+} /* _eventemitter_frozen_trace_emit */
+
+#endif
+
+
+static const struct EventEmitterFrozenSlot *_eventemitter_frozen_find(const struct EventEmitterFrozen *frozen, int event_id)
+{
+  if (!frozen->slot_count)
+  {
+    return(NULL);
+  }
+
+  uint32_t                            seed  = frozen->seeds[_eventemitter_frozen_bucket(event_id, frozen->salt, frozen->bucket_count)];
+  const struct EventEmitterFrozenSlot *slot = &frozen->slots[_eventemitter_frozen_slot(event_id, frozen->salt, seed, frozen->slot_count)];
+
+  // event IDs without listeners are mapped to a slot of another event ID
+  return(slot->event_id == event_id && slot->count ? slot : NULL);
+}
+
+
+static uint64_t _eventemitter_frozen_hash(int event_id, uint64_t seed)
+{
+  uint64_t hash = ((uint64_t)(unsigned int)event_id + seed) * 0x9E3779B97F4A7C15ULL;
+
+  hash = (hash ^ (hash >> 31)) * 0xBF58476D1CE4E5B9ULL;
+
+  return(hash ^ (hash >> 29));
+}
+
+
+static size_t _eventemitter_frozen_reduce(uint64_t hash, size_t range)
+{
+  // maps the high bits of the hash to [0, range) without a division
+  return((size_t)(((hash >> 32) * (uint64_t)range) >> 32));
+}
+
+
+static size_t _eventemitter_frozen_bucket(int event_id, uint64_t salt, size_t bucket_count)
+{
+  return(_eventemitter_frozen_reduce(_eventemitter_frozen_hash(event_id, salt), bucket_count));
+}
+
+
+static size_t _eventemitter_frozen_slot(int event_id, uint64_t salt, uint32_t seed, size_t slot_count)
+{
+  return(_eventemitter_frozen_reduce(_eventemitter_frozen_hash(event_id, salt + ((uint64_t)seed + 1) * 0xD6E8FEB86659FD93ULL), slot_count));
+}
+
+
+static size_t _eventemitter_frozen_copy_records(struct EventEmitterFrozenRecord *records, unsigned int *ids, const struct EventEmitterEventListeners *listeners)
+{
+  size_t count = 0;
+
+  for (size_t index = 0; index < listeners->count; index++)
+  {
+    const struct EventEmitterEventListener *listener = &listeners->listeners[index];
+
+    if (listener->id)
+    {
+      records[count].callback.event = listener->callback.event;
+      records[count].context        = listener->context;
+      ids[count]                    = listener->id;
+      count++;
+    }
+  }
+
+  return(count);
+}
+
+
+static bool _eventemitter_frozen_place(struct EventEmitterFrozenBuild *build)
+{
+  // groups the keys by bucket (counting sort)
+  memset(build->starts, 0, (build->bucket_count + 1) * sizeof(size_t));
+  for (size_t index = 0; index < build->key_count; index++)
+  {
+    build->starts[_eventemitter_frozen_bucket(build->keys[index].event_id, build->salt, build->bucket_count) + 1]++;
+  }
+
+  size_t max_size = 0;
+  for (size_t index = 0; index < build->bucket_count; index++)
+  {
+    if (build->starts[index + 1] > max_size)
+    {
+      max_size = build->starts[index + 1];
+    }
+    build->starts[index + 1] = build->starts[index + 1] + build->starts[index];
+  }
+
+  // the seeds are used as the write positions until they are found
+  for (size_t index = 0; index < build->bucket_count; index++)
+  {
+    build->seeds[index] = (uint32_t)build->starts[index];
+  }
+  for (size_t index = 0; index < build->key_count; index++)
+  {
+    size_t bucket = _eventemitter_frozen_bucket(build->keys[index].event_id, build->salt, build->bucket_count);
+    build->sorted[build->seeds[bucket]] = build->keys[index];
+    build->seeds[bucket]++;
+  }
+
+  // larger buckets are placed first, while most slots are still free
+  memset(build->occupied, 0, build->slot_count);
+  for (size_t size = max_size; size > 0; size--)
+  {
+    for (size_t bucket = 0; bucket < build->bucket_count; bucket++)
+    {
+      if (build->starts[bucket + 1] - build->starts[bucket] == size && !_eventemitter_frozen_place_bucket(build, bucket))
+      {
+        return(false);
+      }
+    }
+  }
+  for (size_t bucket = 0; bucket < build->bucket_count; bucket++)
+  {
+    if (build->starts[bucket + 1] == build->starts[bucket])
+    {
+      build->seeds[bucket] = 0;
+    }
+  }
+
+  return(true);
+} /* _eventemitter_frozen_place */
+
+
+static bool _eventemitter_frozen_place_bucket(struct EventEmitterFrozenBuild *build, size_t bucket)
+{
+  // the amount of tries needed to find the last free slots grows with the table size
+  size_t                       start    = build->starts[bucket];
+  size_t                       size     = build->starts[bucket + 1] - start;
+  struct EventEmitterFrozenKey *keys    = &build->sorted[start];
+  uint64_t                     max_seed = (uint64_t)build->slot_count * 8 + 256;
+
+  if (max_seed > UINT32_MAX)
+  {
+    max_seed = UINT32_MAX;
+  }
+
+  for (uint64_t seed = 0; seed < max_seed; seed++)
+  {
+    size_t placed = 0;
+    while (placed < size)
+    {
+      keys[placed].slot = _eventemitter_frozen_slot(keys[placed].event_id, build->salt, (uint32_t)seed, build->slot_count);
+      if (build->occupied[keys[placed].slot])
+      {
+        break;
+      }
+      build->occupied[keys[placed].slot] = true;
+      placed++;
+    }
+
+    if (placed == size)
+    {
+      build->seeds[bucket] = (uint32_t)seed;
+      return(true);
+    }
+
+    while (placed)
+    {
+      placed--;
+      build->occupied[keys[placed].slot] = false;
+    }
+  }
+
+  return(false);
+} /* _eventemitter_frozen_place_bucket */
+
+
+static void _eventemitter_frozen_build_release(struct EventEmitterFrozenBuild *build)
+{
+  void *blocks[] = { build->keys, build->sorted, build->starts, build->seeds, build->occupied };
+
+  for (size_t index = 0; index < sizeof(blocks) / sizeof(blocks[0]); index++)
+  {
+    if (blocks[index] != NULL)
+    {
+      build->allocator->deallocate(blocks[index], build->allocator->context);
+    }
+  }
+}
+
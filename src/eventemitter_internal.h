@@ -0,0 +1,241 @@
+#ifndef EVENTEMITTER_INTERNAL_H
+#define EVENTEMITTER_INTERNAL_H
+
+#include "eventemitter.h"
+#include "eventemitter_alloc.h"
+#include "eventemitter_intervals.h"
+#include "eventemitter_map.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef EVENTEMITTER_THREADS
+#include <stdatomic.h>
+#endif
+
+#define EVENTEMITTER_LISTENERS_EVENT    0
+#define EVENTEMITTER_LISTENERS_RANGE    1
+#define EVENTEMITTER_LISTENERS_MASK     2
+
+// owned payloads which fit a chunk (with their header) are allocated from the emitter payload arena
+#define EVENTEMITTER_PAYLOAD_CHUNK_SIZE    128
+
+struct EventEmitterCoalescing;
+struct EventEmitterQueue;
+struct EventEmitterFrozen;
+struct EventEmitterWorkers;
+
+/**
+ * The emitter internal structures, shared by the emitter modules.
+ */
+struct EventEmitterEventListener
+{
+  union
+  {
+    void (*event)(void *event_data, void *context);
+    void (*unhandled)(int event_id, void *event_data, void *context);
+  }            callback;
+  void         *context;
+  // removed listeners are kept with ID 0 until the array is compacted
+  unsigned int id;
+  unsigned int slot;
+  // higher priorities are invoked first, records are ordered by priority and by registration
+  int          priority;
+  bool         once;
+  // added during dispatch with prepend, moved to the start once the dispatch is done
+  bool         prepend;
+};
+
+// listener records are stored inline in a cache line aligned array so emit walks memory sequentially
+struct EventEmitterEventListeners
+{
+  int                              event_id;
+  // range listeners match event_id to max_event_id and mask listeners match event IDs for which (event ID & mask) == event_id
+  union
+  {
+    int max_event_id;
+    int mask;
+  }                                pattern;
+  size_t                           count;
+  size_t                           removed;
+  size_t                           capacity;
+  // records from this index were added during dispatch and are not invoked until it is done
+  size_t                           committed;
+  // amount of emit calls currently iterating the records, while set the array is not compacted or freed
+  unsigned int                     dispatching;
+  // one of the EVENTEMITTER_LISTENERS_* types, kept next to the dispatch counter so the struct fits a cache line
+  unsigned char                    type;
+  // set when records were appended out of priority order, they are sorted before the next dispatch
+  bool                             unsorted;
+  // set while the listeners are empty and kept for reuse by the retention policy
+  bool                             retained;
+  // set when the listeners were removed from the emitter while dispatched, they are freed once the dispatch is done
+  bool                             detached;
+  // amount of listeners about to be added by a bulk add, used to grow the array once
+  size_t                           pending;
+  struct EventEmitterEventListener *listeners;
+#ifdef EVENTEMITTER_STATS
+  // the event counters, NULL for the unhandled, range and mask listeners
+  struct EventEmitterStats         *stats;
+#endif
+};
+
+// points to the current position of a listener record, slots never move so they can be referenced directly
+struct EventEmitterListenerSlot
+{
+  struct EventEmitterEventListeners *listeners;
+  // the position in the listeners array, or the next free slot for free slots
+  size_t                            position;
+  // incremented each time the slot is freed, so listener handles of previous uses are rejected
+  unsigned int                      generation;
+};
+
+// a mask used by mask listeners and the amount of listeners structs using it
+struct EventEmitterMask
+{
+  int    mask;
+  size_t listeners;
+};
+
+struct EventEmitter
+{
+  struct EventEmitterAllocator      allocator;
+  // pools for the event listeners structs and for listener arrays of the initial capacity
+  struct EventEmitterPool           event_listeners_pool;
+  struct EventEmitterPool           listener_records_pool;
+  unsigned int                      next_callback_id;
+  // set once the callback IDs wrapped around, from then on IDs still in use are skipped
+  bool                              callback_ids_wrapped;
+  struct EventEmitterMap            event_listeners;
+  struct EventEmitterEventListeners **range_listeners;
+  int                               range_min;
+  size_t                            range_size;
+  struct EventEmitterEventListeners unhandled_listeners;
+  // range listeners by range and mask listeners by mask and value, with the masks in order of first use
+  struct EventEmitterIntervals      interval_listeners;
+  struct EventEmitterMap            mask_listeners;
+  struct EventEmitterMask           *masks;
+  size_t                            masks_count;
+  size_t                            masks_capacity;
+  // amount of emits currently iterating the masks, while set unused masks are not removed
+  size_t                            masks_dispatching;
+  // callback ID to listener slot index, enables removing listeners without scanning
+  struct EventEmitterMap            listener_index;
+  struct EventEmitterListenerSlot   **listener_slot_pages;
+  size_t                            listener_slot_pages_count;
+  size_t                            listener_slots_count;
+  size_t                            free_listener_slot;
+  // amount of empty event listeners kept (with their records array) for reuse and the max amount to keep
+  size_t                            retained_listeners;
+  size_t                            max_retained_listeners;
+  // events queue for deferred dispatch, created on demand
+  struct EventEmitterQueue          *queue;
+  // pending coalesced events, created on demand
+  struct EventEmitterCoalescing     *coalescing;
+  // worker threads for async emit, created on demand
+  struct EventEmitterWorkers        *workers;
+  // arena for small owned payloads, which are created and released on any thread so it is guarded by a spin lock
+  struct EventEmitterPool           payload_pool;
+#ifdef EVENTEMITTER_THREADS
+  atomic_flag                       payload_pool_lock;
+#endif
+  // read only dispatch table used by emit once frozen, listeners can no longer change
+  struct EventEmitterFrozen         *frozen;
+#ifdef EVENTEMITTER_STATS
+  struct EventEmitterStats          stats;
+  // event ID to the event counters, kept until the emitter is released
+  struct EventEmitterMap            event_stats;
+  struct EventEmitterPool           event_stats_pool;
+#endif
+#ifdef EVENTEMITTER_TRACE
+  // copy of the trace hooks, only used while tracing is set
+  struct EventEmitterTraceHooks     trace_hooks;
+  bool                              tracing;
+#endif
+};
+
+/**
+ * Compiles the given listeners into a read only dispatch table.
+ * The records are copied so the table does not reference the listeners.
+ *
+ * @param allocator - The allocator used for the table memory
+ * @param listeners - The listeners of each event, all with at least one record which is not removed
+ * @param count - The amount of events
+ * @param unhandled listeners - The unhandled events listeners
+ * @returns the table or NULL in case of allocation failure
+ */
+struct EventEmitterFrozen *_eventemitter_frozen_new(const struct EventEmitterAllocator *, struct EventEmitterEventListeners ** /* listeners */, size_t /* count */, const struct EventEmitterEventListeners * /* unhandled listeners */);
+
+/**
+ * Frees the table memory.
+ *
+ * @param allocator - The allocator used to create the table
+ * @param frozen - The table
+ */
+void _eventemitter_frozen_release(const struct EventEmitterAllocator *, struct EventEmitterFrozen *);
+
+/**
+ * Invokes the listeners of the given event ID or the unhandled events listeners.
+ * The table is only read, so it can be called from any amount of threads concurrently.
+ *
+ * @param frozen - The table
+ * @param event ID - The event ID
+ * @param event data - The event data passed to all relevant listeners
+ * @returns the amount of callbacks invoked (including unhandled)
+ */
+int _eventemitter_frozen_emit(const struct EventEmitterFrozen *, int /* event ID */, void * /* event data */);
+
+#ifdef EVENTEMITTER_TRACE
+
+/**
+ * Same as frozen emit, while invoking the given trace hooks around the dispatch and each listener.
+ *
+ * @param frozen - The table
+ * @param event ID - The event ID
+ * @param event data - The event data passed to all relevant listeners
+ * @param hooks - The trace hooks of the emitter
+ * @returns the amount of callbacks invoked (including unhandled)
+ */
+int _eventemitter_frozen_trace_emit(const struct EventEmitterFrozen *, int /* event ID */, void * /* event data */, const struct EventEmitterTraceHooks *);
+
+/**
+ * Returns the current trace timestamp.
+ *
+ * @returns the nanoseconds from a monotonic clock
+ */
+uint64_t _eventemitter_trace_now(void);
+
+#endif
+
+/**
+ * Frees the coalesced events and the coalescing state, pending events are not dispatched.
+ *
+ * @param event emitter - The emitter struct
+ */
+void _eventemitter_coalescing_release(struct EventEmitter *);
+
+#ifdef EVENTEMITTER_THREADS
+
+/**
+ * Frees the events queue, the owned payloads of pending events are released.
+ *
+ * @param event emitter - The emitter struct
+ */
+void _eventemitter_queue_release(struct EventEmitter *);
+
+#endif
+
+#ifdef EVENTEMITTER_STATS
+
+/**
+ * Returns the counters of the given event ID, created on first use.
+ *
+ * @param event emitter - The emitter struct
+ * @param event ID - The event ID
+ * @returns the event counters or NULL in case of allocation failure
+ */
+struct EventEmitterStats *_eventemitter_stats_for_event_id(struct EventEmitter *, int /* event ID */);
+
+#endif
+
+#endif
+
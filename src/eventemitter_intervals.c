@@ -0,0 +1,236 @@
+#include "eventemitter_intervals.h"
+#include <limits.h>
+#include <stdint.h>
+#include <string.h>
+
+#define EVENTEMITTER_INTERVALS_MIN_CAPACITY    8
+
+// private functions
+static int _eventemitter_intervals_compare(const struct EventEmitterInterval *, int, int);
+static size_t _eventemitter_intervals_search(const struct EventEmitterIntervals *, int, int);
+static int _eventemitter_intervals_build(struct EventEmitterInterval *, size_t, size_t);
+static void _eventemitter_intervals_collect(const struct EventEmitterInterval *, size_t, size_t, int, struct EventEmitterIntervalsCursor *, void **, size_t, size_t *);
+
+void _eventemitter_intervals_init(struct EventEmitterIntervals *intervals, const struct EventEmitterAllocator *allocator)
+{
+  intervals->allocator = allocator;
+  intervals->entries   = NULL;
+  intervals->count     = 0;
+  intervals->capacity  = 0;
+  intervals->dirty     = false;
+}
+
+
+void _eventemitter_intervals_release(struct EventEmitterIntervals *intervals)
+{
+  if (intervals->entries != NULL)
+  {
+    intervals->allocator->deallocate(intervals->entries, intervals->allocator->context);
+  }
+  intervals->entries  = NULL;
+  intervals->count    = 0;
+  intervals->capacity = 0;
+  intervals->dirty    = false;
+}
+
+
+void _eventemitter_intervals_clear(struct EventEmitterIntervals *intervals)
+{
+  intervals->count = 0;
+  intervals->dirty = false;
+}
+
+
+void *_eventemitter_intervals_get(const struct EventEmitterIntervals *intervals, int min, int max)
+{
+  size_t index = _eventemitter_intervals_search(intervals, min, max);
+
+  if (index < intervals->count && !_eventemitter_intervals_compare(&intervals->entries[index], min, max))
+  {
+    return(intervals->entries[index].value);
+  }
+
+  return(NULL);
+}
+
+
+bool _eventemitter_intervals_put(struct EventEmitterIntervals *intervals, int min, int max, void *value)
+{
+  if (max < min || value == NULL)
+  {
+    return(false);
+  }
+
+  size_t index = _eventemitter_intervals_search(intervals, min, max);
+  if (index < intervals->count && !_eventemitter_intervals_compare(&intervals->entries[index], min, max))
+  {
+    intervals->entries[index].value = value;
+    return(true);
+  }
+
+  if (intervals->count == intervals->capacity)
+  {
+    size_t capacity = intervals->capacity ? intervals->capacity * 2 : EVENTEMITTER_INTERVALS_MIN_CAPACITY;
+    if (capacity > SIZE_MAX / sizeof(struct EventEmitterInterval))
+    {
+      return(false);
+    }
+
+    struct EventEmitterInterval *entries = intervals->allocator->reallocate(intervals->entries, capacity * sizeof(struct EventEmitterInterval), intervals->allocator->context);
+    if (entries == NULL)
+    {
+      return(false);
+    }
+    intervals->entries  = entries;
+    intervals->capacity = capacity;
+  }
+
+  memmove(&intervals->entries[index + 1], &intervals->entries[index], (intervals->count - index) * sizeof(struct EventEmitterInterval));
+  intervals->entries[index].min         = min;
+  intervals->entries[index].max         = max;
+  intervals->entries[index].subtree_max = max;
+  intervals->entries[index].value       = value;
+  intervals->count++;
+  intervals->dirty = true;
+
+  return(true);
+} /* _eventemitter_intervals_put */
+
+
+void *_eventemitter_intervals_remove(struct EventEmitterIntervals *intervals, int min, int max)
+{
+  size_t index = _eventemitter_intervals_search(intervals, min, max);
+
+  if (index >= intervals->count || _eventemitter_intervals_compare(&intervals->entries[index], min, max))
+  {
+    return(NULL);
+  }
+
+  void *value = intervals->entries[index].value;
+  intervals->count--;
+  memmove(&intervals->entries[index], &intervals->entries[index + 1], (intervals->count - index) * sizeof(struct EventEmitterInterval));
+  intervals->dirty = true;
+
+  return(value);
+}
+
+
+size_t _eventemitter_intervals_find(struct EventEmitterIntervals *intervals, int point, struct EventEmitterIntervalsCursor *cursor, void **values, size_t capacity)
+{
+  if (intervals->dirty)
+  {
+    _eventemitter_intervals_build(intervals->entries, 0, intervals->count);
+    intervals->dirty = false;
+  }
+
+  size_t found = 0;
+  _eventemitter_intervals_collect(intervals->entries, 0, intervals->count, point, cursor, values, capacity, &found);
+
+  return(found);
+}
+
+
+static int _eventemitter_intervals_compare(const struct EventEmitterInterval *entry, int min, int max)
+{
+  if (entry->min != min)
+  {
+    return(entry->min < min ? -1 : 1);
+  }
+  if (entry->max != max)
+  {
+    return(entry->max < max ? -1 : 1);
+  }
+
+  return(0);
+}
+
+
+static size_t _eventemitter_intervals_search(const struct EventEmitterIntervals *intervals, int min, int max)
+{
+  // the first entry which is not lower than the given range
+  size_t start = 0;
+  size_t end   = intervals->count;
+
+  while (start < end)
+  {
+    size_t middle = start + (end - start) / 2;
+    if (_eventemitter_intervals_compare(&intervals->entries[middle], min, max) < 0)
+    {
+      start = middle + 1;
+    }
+    else
+    {
+      end = middle;
+    }
+  }
+
+  return(start);
+}
+
+
+static int _eventemitter_intervals_build(struct EventEmitterInterval *entries, size_t start, size_t end)
+{
+  if (start >= end)
+  {
+    return(INT_MIN);
+  }
+
+  // the implicit tree root of a range is its middle entry
+  size_t middle      = start + (end - start) / 2;
+  int    left_max    = _eventemitter_intervals_build(entries, start, middle);
+  int    right_max   = _eventemitter_intervals_build(entries, middle + 1, end);
+  int    subtree_max = entries[middle].max;
+
+  if (left_max > subtree_max)
+  {
+    subtree_max = left_max;
+  }
+  if (right_max > subtree_max)
+  {
+    subtree_max = right_max;
+  }
+  entries[middle].subtree_max = subtree_max;
+
+  return(subtree_max);
+}
+
+
+static void _eventemitter_intervals_collect(const struct EventEmitterInterval *entries, size_t start, size_t end, int point, struct EventEmitterIntervalsCursor *cursor, void **values, size_t capacity, size_t *found)
+{
+  if (start >= end || *found >= capacity)
+  {
+    return;
+  }
+
+  size_t                            middle = start + (end - start) / 2;
+  const struct EventEmitterInterval *entry = &entries[middle];
+  if (entry->subtree_max < point)
+  {
+    return;
+  }
+
+  // all entries of the left subtree are lower than this entry, so they are skipped with it
+  bool after_cursor = !cursor->started || _eventemitter_intervals_compare(entry, cursor->min, cursor->max) > 0;
+  if (after_cursor)
+  {
+    _eventemitter_intervals_collect(entries, start, middle, point, cursor, values, capacity, found);
+  }
+
+  // all entries of the right subtree start after this entry
+  if (entry->min > point || *found >= capacity)
+  {
+    return;
+  }
+
+  if (after_cursor && entry->max >= point)
+  {
+    values[*found]  = entry->value;
+    cursor->started = true;
+    cursor->min     = entry->min;
+    cursor->max     = entry->max;
+    (*found)++;
+  }
+
+  _eventemitter_intervals_collect(entries, middle + 1, end, point, cursor, values, capacity, found);
+} /* _eventemitter_intervals_collect */
+
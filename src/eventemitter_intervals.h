@@ -0,0 +1,111 @@
+#ifndef EVENTEMITTER_INTERVALS_H
+#define EVENTEMITTER_INTERVALS_H
+
+#include "eventemitter.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * Internal interval index from inclusive [min, max] int ranges to non NULL pointers.
+ * Entries are kept in an array sorted by (min, max) which is used as an implicit
+ * balanced search tree, each entry holds the max of its subtree so stabbing queries
+ * only visit O(log n) entries in addition to the matching ones.
+ */
+struct EventEmitterInterval
+{
+  int  min;
+  int  max;
+  // the highest max of all entries in the implicit subtree rooted at this entry
+  int  subtree_max;
+  void *value;
+};
+
+struct EventEmitterIntervals
+{
+  const struct EventEmitterAllocator *allocator;
+  struct EventEmitterInterval        *entries;
+  size_t                             count;
+  size_t                             capacity;
+  // set when entries were added or removed and the subtree max values are stale
+  bool                               dirty;
+};
+
+/**
+ * Position of a query, so matches can be fetched in several calls.
+ * The index may be modified between the calls.
+ */
+struct EventEmitterIntervalsCursor
+{
+  bool started;
+  int  min;
+  int  max;
+};
+
+/**
+ * Initializes an empty index, no memory is allocated until the first entry is added.
+ *
+ * @param intervals - The index to initialize
+ * @param allocator - The allocator used for the index memory (must outlive the index)
+ */
+void _eventemitter_intervals_init(struct EventEmitterIntervals *, const struct EventEmitterAllocator *);
+
+/**
+ * Frees the internal index memory (but not the stored values).
+ *
+ * @param intervals - The index to release
+ */
+void _eventemitter_intervals_release(struct EventEmitterIntervals *);
+
+/**
+ * Removes all entries (but does not free the stored values).
+ *
+ * @param intervals - The index to clear
+ */
+void _eventemitter_intervals_clear(struct EventEmitterIntervals *);
+
+/**
+ * Returns the value of the given range or NULL if not found.
+ *
+ * @param intervals - The index
+ * @param min - The range min
+ * @param max - The range max
+ * @returns the value or NULL
+ */
+void *_eventemitter_intervals_get(const struct EventEmitterIntervals *, int /* min */, int /* max */);
+
+/**
+ * Adds or replaces the value of the given range.
+ *
+ * @param intervals - The index
+ * @param min - The range min
+ * @param max - The range max (not lower than min)
+ * @param value - The non NULL value
+ * @returns true if stored, false in case of invalid input or allocation failure
+ */
+bool _eventemitter_intervals_put(struct EventEmitterIntervals *, int /* min */, int /* max */, void * /* value */);
+
+/**
+ * Removes the entry of the given range.
+ *
+ * @param intervals - The index
+ * @param min - The range min
+ * @param max - The range max
+ * @returns the removed value or NULL if not found
+ */
+void *_eventemitter_intervals_remove(struct EventEmitterIntervals *, int /* min */, int /* max */);
+
+/**
+ * Finds the values of the ranges containing the given point, ordered by (min, max).
+ * Only ranges after the cursor are returned and the cursor is moved past the last returned range.
+ *
+ * @param intervals - The index
+ * @param point - The point to look up
+ * @param cursor - The query position, zeroed for the first call
+ * @param values - Populated with the found values
+ * @param capacity - The max amount of values to find
+ * @returns the amount of found values, all matches were found if lower than the capacity
+ */
+size_t _eventemitter_intervals_find(struct EventEmitterIntervals *, int /* point */, struct EventEmitterIntervalsCursor *, void ** /* values */, size_t /* capacity */);
+
+#endif
+
@@ -0,0 +1,208 @@
+#include "eventemitter_map.h"
+#include <string.h>
+
+#define EVENTEMITTER_MAP_MIN_CAPACITY    8
+
+// private functions
+static bool _eventemitter_map_resize(struct EventEmitterMap *, size_t);
+static void _eventemitter_map_insert(struct EventEmitterMap *, uint64_t, void *);
+
+bool _eventemitter_map_init(struct EventEmitterMap *map, const struct EventEmitterAllocator *allocator, size_t capacity)
+{
+  if (map == NULL || allocator == NULL)
+  {
+    return(false);
+  }
+
+  map->allocator = allocator;
+  map->entries   = NULL;
+  map->capacity  = 0;
+  map->size      = 0;
+  map->shift     = 64;
+
+  // keep the load factor under 70%
+  size_t minimum_capacity = capacity + capacity / 2;
+  size_t new_capacity     = EVENTEMITTER_MAP_MIN_CAPACITY;
+  while (new_capacity < minimum_capacity)
+  {
+    new_capacity = new_capacity * 2;
+  }
+
+  return(_eventemitter_map_resize(map, new_capacity));
+}
+
+
+void _eventemitter_map_release(struct EventEmitterMap *map)
+{
+  if (map == NULL)
+  {
+    return;
+  }
+
+  if (map->entries != NULL)
+  {
+    map->allocator->deallocate(map->entries, map->allocator->context);
+  }
+  map->entries  = NULL;
+  map->capacity = 0;
+  map->size     = 0;
+}
+
+
+void _eventemitter_map_clear(struct EventEmitterMap *map)
+{
+  if (map == NULL || !map->size)
+  {
+    return;
+  }
+
+  for (size_t index = 0; index < map->capacity; index++)
+  {
+    map->entries[index].value = NULL;
+  }
+  map->size = 0;
+}
+
+
+bool _eventemitter_map_reserve(struct EventEmitterMap *map, size_t size)
+{
+  size_t new_capacity = map->capacity;
+
+  while (size * 10 > new_capacity * 7)
+  {
+    new_capacity = new_capacity * 2;
+  }
+
+  if (new_capacity == map->capacity)
+  {
+    return(true);
+  }
+
+  return(_eventemitter_map_resize(map, new_capacity));
+}
+
+
+bool _eventemitter_map_put(struct EventEmitterMap *map, uint64_t key, void *value)
+{
+  if (map == NULL || value == NULL)
+  {
+    return(false);
+  }
+
+  if ((map->size + 1) * 10 > map->capacity * 7)
+  {
+    if (!_eventemitter_map_resize(map, map->capacity * 2))
+    {
+      return(false);
+    }
+  }
+
+  _eventemitter_map_insert(map, key, value);
+
+  return(true);
+}
+
+
+void *_eventemitter_map_remove(struct EventEmitterMap *map, uint64_t key)
+{
+  if (map == NULL || !map->size)
+  {
+    return(NULL);
+  }
+
+  size_t mask  = map->capacity - 1;
+  size_t index = _eventemitter_map_index(map, key);
+  while (map->entries[index].value != NULL && map->entries[index].key != key)
+  {
+    index = (index + 1) & mask;
+  }
+
+  void *value = map->entries[index].value;
+  if (value == NULL)
+  {
+    return(NULL);
+  }
+
+  // shift back the following entries of the probe sequence to fill the hole
+  size_t hole = index;
+  index = (index + 1) & mask;
+  while (map->entries[index].value != NULL)
+  {
+    size_t home = _eventemitter_map_index(map, map->entries[index].key);
+
+    // move the entry only if its home position is not between the hole and its current position
+    if (((index - home) & mask) >= ((index - hole) & mask))
+    {
+      map->entries[hole] = map->entries[index];
+      hole               = index;
+    }
+
+    index = (index + 1) & mask;
+  }
+  map->entries[hole].value = NULL;
+  map->size--;
+
+  return(value);
+} /* _eventemitter_map_remove */
+
+static bool _eventemitter_map_resize(struct EventEmitterMap *map, size_t capacity)
+{
+  struct EventEmitterMapEntry *entries = map->allocator->allocate(capacity * sizeof(struct EventEmitterMapEntry), map->allocator->context);
+
+  if (entries == NULL)
+  {
+    return(false);
+  }
+  memset(entries, 0, capacity * sizeof(struct EventEmitterMapEntry));
+
+  struct EventEmitterMapEntry *old_entries  = map->entries;
+  size_t                      old_capacity = map->capacity;
+
+  unsigned int                bits = 0;
+  while (((size_t)1 << bits) < capacity)
+  {
+    bits++;
+  }
+
+  map->entries  = entries;
+  map->capacity = capacity;
+  map->size     = 0;
+  map->shift    = 64 - bits;
+
+  for (size_t index = 0; index < old_capacity; index++)
+  {
+    if (old_entries[index].value != NULL)
+    {
+      _eventemitter_map_insert(map, old_entries[index].key, old_entries[index].value);
+    }
+  }
+  if (old_entries != NULL)
+  {
+    map->allocator->deallocate(old_entries, map->allocator->context);
+  }
+
+  return(true);
+}
+
+
+static void _eventemitter_map_insert(struct EventEmitterMap *map, uint64_t key, void *value)
+{
+  size_t mask  = map->capacity - 1;
+  size_t index = _eventemitter_map_index(map, key);
+
+  while (map->entries[index].value != NULL)
+  {
+    if (map->entries[index].key == key)
+    {
+      map->entries[index].value = value;
+      return;
+    }
+
+    index = (index + 1) & mask;
+  }
+
+  map->entries[index].key   = key;
+  map->entries[index].value = value;
+  map->size++;
+}
+
@@ -0,0 +1,108 @@
+#ifndef EVENTEMITTER_MAP_H
+#define EVENTEMITTER_MAP_H
+
+#include "eventemitter.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Internal open addressing (linear probing) hash map from 64 bit keys to non NULL pointers.
+ * Removal uses backward shift deletion so lookups never have to skip tombstones.
+ */
+struct EventEmitterMapEntry
+{
+  uint64_t key;
+  void     *value;
+};
+
+struct EventEmitterMap
+{
+  const struct EventEmitterAllocator *allocator;
+  struct EventEmitterMapEntry        *entries;
+  size_t                             capacity;
+  size_t                             size;
+  unsigned int                       shift;
+};
+
+/**
+ * Initializes the map with room for at least the requested amount of entries.
+ *
+ * @param map - The map to initialize
+ * @param allocator - The allocator used for the map memory (must outlive the map)
+ * @param capacity - The minimum amount of entries
+ * @returns true if initialized
+ */
+bool _eventemitter_map_init(struct EventEmitterMap *, const struct EventEmitterAllocator *, size_t /* capacity */);
+
+/**
+ * Frees the internal map memory (but not the stored values).
+ *
+ * @param map - The map to release
+ */
+void _eventemitter_map_release(struct EventEmitterMap *);
+
+/**
+ * Removes all entries (but does not free the stored values).
+ *
+ * @param map - The map to clear
+ */
+void _eventemitter_map_clear(struct EventEmitterMap *);
+
+/**
+ * Grows the map so it can hold the requested amount of entries without further resizing.
+ *
+ * @param map - The map
+ * @param size - The minimum amount of entries
+ * @returns true if the map has enough room, false in case of allocation failure
+ */
+bool _eventemitter_map_reserve(struct EventEmitterMap *, size_t /* size */);
+
+/**
+ * Adds or replaces the value for the given key.
+ *
+ * @param map - The map
+ * @param key - The entry key
+ * @param value - The non NULL entry value
+ * @returns true if stored, false in case of invalid input or allocation failure
+ */
+bool _eventemitter_map_put(struct EventEmitterMap *, uint64_t /* key */, void * /* value */);
+
+/**
+ * Removes the entry for the given key.
+ *
+ * @param map - The map
+ * @param key - The entry key
+ * @returns the removed value or NULL if not found
+ */
+void *_eventemitter_map_remove(struct EventEmitterMap *, uint64_t /* key */);
+
+static inline size_t _eventemitter_map_index(const struct EventEmitterMap *map, uint64_t key)
+{
+  return((size_t)((key * 0x9E3779B97F4A7C15ULL) >> map->shift));
+}
+
+
+/**
+ * Returns the value for the given key or NULL if not found.
+ */
+static inline void *_eventemitter_map_get(const struct EventEmitterMap *map, uint64_t key)
+{
+  size_t mask  = map->capacity - 1;
+  size_t index = _eventemitter_map_index(map, key);
+
+  while (map->entries[index].value != NULL)
+  {
+    if (map->entries[index].key == key)
+    {
+      return(map->entries[index].value);
+    }
+
+    index = (index + 1) & mask;
+  }
+
+  return(NULL);
+}
+
+#endif
+
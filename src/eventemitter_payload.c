@@ -0,0 +1,198 @@
+#include "eventemitter_internal.h"
+#include <stdint.h>
+
+#ifdef EVENTEMITTER_THREADS
+#include <sched.h>
+#endif
+
+// the header in front of each owned payload, the payload starts at the next max aligned offset
+struct EventEmitterPayload
+{
+  struct EventEmitter *event_emitter;
+  void                (*release)(void *payload);
+#ifdef EVENTEMITTER_THREADS
+  atomic_size_t       references;
+#else
+  size_t              references;
+#endif
+  // allocated from the emitter payload arena
+  bool                pooled;
+};
+
+#define EVENTEMITTER_PAYLOAD_HEADER_SIZE    ((sizeof(struct EventEmitterPayload) + sizeof(max_align_t) - 1) & ~(sizeof(max_align_t) - 1))
+
+// private functions
+static struct EventEmitterPayload *_eventemitter_payload_header(void *);
+static void *_eventemitter_payload_pool_alloc(struct EventEmitter *);
+static void _eventemitter_payload_pool_free(struct EventEmitter *, void *);
+#ifdef EVENTEMITTER_THREADS
+static void _eventemitter_payload_async_done(int, void *);
+#endif
+
+void *eventemitter_payload_new(struct EventEmitter *event_emitter, size_t size, void (*release)(void *payload))
+{
+  if (event_emitter == NULL || size > SIZE_MAX - EVENTEMITTER_PAYLOAD_HEADER_SIZE)
+  {
+    return(NULL);
+  }
+
+  bool                       pooled  = size <= EVENTEMITTER_PAYLOAD_CHUNK_SIZE - EVENTEMITTER_PAYLOAD_HEADER_SIZE;
+  struct EventEmitterPayload *header = NULL;
+  if (pooled)
+  {
+    header = _eventemitter_payload_pool_alloc(event_emitter);
+  }
+  else
+  {
+    header = event_emitter->allocator.allocate(EVENTEMITTER_PAYLOAD_HEADER_SIZE + size, event_emitter->allocator.context);
+  }
+  if (header == NULL)
+  {
+    return(NULL);
+  }
+
+  header->event_emitter = event_emitter;
+  header->release       = release;
+  header->pooled        = pooled;
+#ifdef EVENTEMITTER_THREADS
+  atomic_init(&header->references, 1);
+#else
+  header->references = 1;
+#endif
+
+  return((char *)header + EVENTEMITTER_PAYLOAD_HEADER_SIZE);
+}
+
+
+void *eventemitter_payload_retain(void *payload)
+{
+  if (payload == NULL)
+  {
+    return(NULL);
+  }
+
+  struct EventEmitterPayload *header = _eventemitter_payload_header(payload);
+#ifdef EVENTEMITTER_THREADS
+  atomic_fetch_add_explicit(&header->references, 1, memory_order_relaxed);
+#else
+  header->references++;
+#endif
+
+  return(payload);
+}
+
+
+void eventemitter_payload_release(void *payload)
+{
+  if (payload == NULL)
+  {
+    return;
+  }
+
+  // the last reference frees the payload, a sole owner can not race with other owners so it skips the atomic decrement
+  struct EventEmitterPayload *header = _eventemitter_payload_header(payload);
+#ifdef EVENTEMITTER_THREADS
+  if (  atomic_load_explicit(&header->references, memory_order_acquire) != 1
+     && atomic_fetch_sub_explicit(&header->references, 1, memory_order_acq_rel) != 1)
+  {
+    return;
+  }
+#else
+  if (--header->references)
+  {
+    return;
+  }
+#endif
+
+  if (header->release != NULL)
+  {
+    header->release(payload);
+  }
+
+  struct EventEmitter *event_emitter = header->event_emitter;
+  if (header->pooled)
+  {
+    _eventemitter_payload_pool_free(event_emitter, header);
+  }
+  else
+  {
+    event_emitter->allocator.deallocate(header, event_emitter->allocator.context);
+  }
+} /* eventemitter_payload_release */
+
+
+int eventemitter_emit_owned(struct EventEmitter *event_emitter, int event_id, void *payload)
+{
+  if (event_emitter == NULL || payload == NULL)
+  {
+    return(-1);
+  }
+
+  // listeners borrow the payload during emit and retain it to keep it longer
+  int callback_counter = eventemitter_emit(event_emitter, event_id, payload);
+  eventemitter_payload_release(payload);
+
+  return(callback_counter);
+}
+
+#ifdef EVENTEMITTER_THREADS
+
+
+bool eventemitter_emit_async_owned(struct EventEmitter *event_emitter, int event_id, void *payload)
+{
+  if (payload == NULL)
+  {
+    return(false);
+  }
+
+  return(eventemitter_emit_async_with_callback(event_emitter, event_id, payload, _eventemitter_payload_async_done, payload));
+}
+
+#endif
+
+static struct EventEmitterPayload *_eventemitter_payload_header(void *payload)
+{
+  return((struct EventEmitterPayload *)(void *)((char *)payload - EVENTEMITTER_PAYLOAD_HEADER_SIZE));
+}
+
+static void *_eventemitter_payload_pool_alloc(struct EventEmitter *event_emitter)
+{
+#ifdef EVENTEMITTER_THREADS
+  while (atomic_flag_test_and_set_explicit(&event_emitter->payload_pool_lock, memory_order_acquire))
+  {
+    sched_yield();
+  }
+#endif
+  void *chunk = _eventemitter_pool_alloc(&event_emitter->payload_pool);
+#ifdef EVENTEMITTER_THREADS
+  atomic_flag_clear_explicit(&event_emitter->payload_pool_lock, memory_order_release);
+#endif
+
+  return(chunk);
+}
+
+static void _eventemitter_payload_pool_free(struct EventEmitter *event_emitter, void *chunk)
+{
+#ifdef EVENTEMITTER_THREADS
+  while (atomic_flag_test_and_set_explicit(&event_emitter->payload_pool_lock, memory_order_acquire))
+  {
+    sched_yield();
+  }
+#endif
+  _eventemitter_pool_free(&event_emitter->payload_pool, chunk);
+#ifdef EVENTEMITTER_THREADS
+  atomic_flag_clear_explicit(&event_emitter->payload_pool_lock, memory_order_release);
+#endif
+}
+
+#ifdef EVENTEMITTER_THREADS
+
+static void _eventemitter_payload_async_done(int callback_counter, void *context)
+{
+  (void)callback_counter;
+
+  eventemitter_payload_release(context);
+}
+
+#endif
+
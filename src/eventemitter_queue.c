@@ -0,0 +1,288 @@
+#include "eventemitter_internal.h"
+
+#ifdef EVENTEMITTER_THREADS
+
+#include <limits.h>
+#include <stdatomic.h>
+#include <stdint.h>
+
+#ifdef __linux__
+#include <sys/eventfd.h>
+#include <unistd.h>
+#endif
+
+// each cell sequence tells whether it is free for the producer of a position or ready for the consumer
+struct EventEmitterQueueCell
+{
+  atomic_size_t sequence;
+  int           event_id;
+  // owned event data is released once dispatched
+  bool          owned;
+  void          *event_data;
+};
+
+// bounded multi producer single consumer ring, the producer and consumer positions are on different cache lines
+struct EventEmitterQueue
+{
+  struct EventEmitterQueueCell *cells;
+  size_t                       mask;
+  size_t                       dequeue_position;
+  // eventfd readable while events are pending, created on demand
+  int                          fd;
+  char                         consumer_padding[EVENTEMITTER_CACHE_LINE_SIZE - sizeof(void *) - 2 * sizeof(size_t) - sizeof(int)];
+  atomic_size_t                enqueue_position;
+  // set by the first producer after the consumer drained the queue, so a burst of events writes the eventfd once
+  atomic_bool                  signaled;
+  char                         producer_padding[EVENTEMITTER_CACHE_LINE_SIZE - sizeof(atomic_size_t) - sizeof(atomic_bool)];
+};
+
+// private functions
+static bool _eventemitter_enqueue(struct EventEmitter *, int, void *, bool);
+
+bool eventemitter_init_queue(struct EventEmitter *event_emitter, size_t capacity)
+{
+  if (event_emitter == NULL || !capacity || capacity > SIZE_MAX / 2 / sizeof(struct EventEmitterQueueCell) || event_emitter->queue != NULL)
+  {
+    return(false);
+  }
+
+  size_t cell_count = 2;
+  while (cell_count < capacity)
+  {
+    cell_count = cell_count * 2;
+  }
+
+  struct EventEmitterQueue *queue = _eventemitter_aligned_alloc(&event_emitter->allocator, sizeof(struct EventEmitterQueue) + cell_count * sizeof(struct EventEmitterQueueCell));
+  if (queue == NULL)
+  {
+    return(false);
+  }
+
+  queue->cells            = (struct EventEmitterQueueCell *)(void *)((char *)queue + sizeof(struct EventEmitterQueue));
+  queue->mask             = cell_count - 1;
+  queue->dequeue_position = 0;
+  queue->fd               = -1;
+  atomic_init(&queue->enqueue_position, 0);
+  atomic_init(&queue->signaled, false);
+  for (size_t index = 0; index < cell_count; index++)
+  {
+    atomic_init(&queue->cells[index].sequence, index);
+  }
+
+  event_emitter->queue = queue;
+
+  return(true);
+}
+
+
+bool eventemitter_enqueue(struct EventEmitter *event_emitter, int event_id, void *event_data)
+{
+  return(_eventemitter_enqueue(event_emitter, event_id, event_data, false));
+}
+
+
+bool eventemitter_enqueue_owned(struct EventEmitter *event_emitter, int event_id, void *payload)
+{
+  if (payload == NULL)
+  {
+    return(false);
+  }
+
+  return(_eventemitter_enqueue(event_emitter, event_id, payload, true));
+}
+
+
+int eventemitter_dispatch(struct EventEmitter *event_emitter, size_t max_events)
+{
+  if (event_emitter == NULL)
+  {
+    return(-1);
+  }
+
+  struct EventEmitterQueue *queue = event_emitter->queue;
+  if (queue == NULL)
+  {
+    return(0);
+  }
+
+  // without a limit, only the events queued before the call are dispatched so producers can not keep it running
+  if (!max_events)
+  {
+    max_events = atomic_load_explicit(&queue->enqueue_position, memory_order_relaxed) - queue->dequeue_position;
+  }
+  if (max_events > INT_MAX)
+  {
+    max_events = INT_MAX;
+  }
+
+  size_t count = 0;
+  while (count < max_events)
+  {
+    size_t                       position = queue->dequeue_position;
+    struct EventEmitterQueueCell *cell    = &queue->cells[position & queue->mask];
+    if (atomic_load_explicit(&cell->sequence, memory_order_acquire) != position + 1)
+    {
+      break;
+    }
+
+    // the cell is handed back to the producers before emitting so callbacks can enqueue more events
+    int  event_id    = cell->event_id;
+    bool owned       = cell->owned;
+    void *event_data = cell->event_data;
+    atomic_store_explicit(&cell->sequence, position + queue->mask + 1, memory_order_release);
+    queue->dequeue_position = position + 1;
+
+    eventemitter_emit(event_emitter, event_id, event_data);
+    if (owned)
+    {
+      eventemitter_payload_release(event_data);
+    }
+    count++;
+  }
+
+  return((int)count);
+} /* eventemitter_dispatch */
+
+
+int eventemitter_get_fd(struct EventEmitter *event_emitter)
+{
+  if (event_emitter == NULL || event_emitter->queue == NULL)
+  {
+    return(-1);
+  }
+
+#ifdef __linux__
+  struct EventEmitterQueue *queue = event_emitter->queue;
+  if (queue->fd < 0)
+  {
+    queue->fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  }
+
+  return(queue->fd);
+#else
+  return(-1);
+#endif
+}
+
+
+int eventemitter_dispatch_pending(struct EventEmitter *event_emitter)
+{
+  if (event_emitter == NULL)
+  {
+    return(-1);
+  }
+
+  struct EventEmitterQueue *queue = event_emitter->queue;
+  if (queue == NULL)
+  {
+    return(0);
+  }
+
+#ifdef __linux__
+  if (queue->fd >= 0 && atomic_load_explicit(&queue->signaled, memory_order_relaxed))
+  {
+    // a single read acknowledges the whole burst, producers signal again once the flag is cleared
+    uint64_t value  = 0;
+    ssize_t  result = read(queue->fd, &value, sizeof(uint64_t));
+    (void)result;
+    atomic_store_explicit(&queue->signaled, false, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+  }
+#endif
+
+  return(eventemitter_dispatch(event_emitter, 0));
+}
+
+
+void _eventemitter_queue_release(struct EventEmitter *event_emitter)
+{
+  struct EventEmitterQueue *queue = event_emitter->queue;
+
+  if (queue == NULL)
+  {
+    return;
+  }
+
+  // pending events are not dispatched, but their owned payloads are still released
+  for (size_t position = queue->dequeue_position; ; position++)
+  {
+    struct EventEmitterQueueCell *cell = &queue->cells[position & queue->mask];
+    if (atomic_load_explicit(&cell->sequence, memory_order_acquire) != position + 1)
+    {
+      break;
+    }
+
+    if (cell->owned)
+    {
+      eventemitter_payload_release(cell->event_data);
+    }
+  }
+
+#ifdef __linux__
+  if (queue->fd >= 0)
+  {
+    close(queue->fd);
+  }
+#endif
+  _eventemitter_aligned_free(&event_emitter->allocator, queue);
+  event_emitter->queue = NULL;
+}
+
+static bool _eventemitter_enqueue(struct EventEmitter *event_emitter, int event_id, void *event_data, bool owned)
+{
+  if (event_emitter == NULL || event_emitter->queue == NULL)
+  {
+    return(false);
+  }
+
+  struct EventEmitterQueue     *queue    = event_emitter->queue;
+  struct EventEmitterQueueCell *cell     = NULL;
+  size_t                       position = atomic_load_explicit(&queue->enqueue_position, memory_order_relaxed);
+  for ( ; ; )
+  {
+    cell = &queue->cells[position & queue->mask];
+
+    // the cell is free when its sequence equals the position, and still used by the previous lap when it is behind
+    size_t   sequence   = atomic_load_explicit(&cell->sequence, memory_order_acquire);
+    intptr_t difference = (intptr_t)(sequence - position);
+    if (!difference)
+    {
+      if (atomic_compare_exchange_weak_explicit(&queue->enqueue_position, &position, position + 1, memory_order_relaxed, memory_order_relaxed))
+      {
+        break;
+      }
+    }
+    else if (difference < 0)
+    {
+      return(false);
+    }
+    else
+    {
+      position = atomic_load_explicit(&queue->enqueue_position, memory_order_relaxed);
+    }
+  }
+
+  cell->event_id   = event_id;
+  cell->owned      = owned;
+  cell->event_data = event_data;
+  atomic_store_explicit(&cell->sequence, position + 1, memory_order_release);
+
+#ifdef __linux__
+  // pairs with the fence of the consumer clearing the flag, so either it dispatches the event or the event signals again
+  if (queue->fd >= 0)
+  {
+    atomic_thread_fence(memory_order_seq_cst);
+    if (!atomic_load_explicit(&queue->signaled, memory_order_relaxed) && !atomic_exchange_explicit(&queue->signaled, true, memory_order_relaxed))
+    {
+      uint64_t value  = 1;
+      ssize_t  result = write(queue->fd, &value, sizeof(uint64_t));
+      (void)result;
+    }
+  }
+#endif
+
+  return(true);
+}
+
+#endif
+
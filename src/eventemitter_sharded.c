@@ -0,0 +1,152 @@
+#include "eventemitter_internal.h"
+#include "eventemitter_sharded.h"
+
+#ifdef EVENTEMITTER_THREADS
+
+#include <stdint.h>
+
+// the shards are separate emitters, each with its own allocations and inbox, so owner threads do not share cache lines
+struct EventEmitterSharded
+{
+  struct EventEmitterAllocator allocator;
+  size_t                       shard_count;
+  struct EventEmitter          **shards;
+};
+
+// private functions
+static struct EventEmitterSharded *_eventemitter_sharded_new(const struct EventEmitterAllocator *, size_t, size_t);
+
+struct EventEmitterSharded *eventemitter_sharded_new(size_t shard_count, size_t inbox_capacity)
+{
+  return(_eventemitter_sharded_new(&_eventemitter_default_allocator, shard_count, inbox_capacity));
+}
+
+
+struct EventEmitterSharded *eventemitter_sharded_new_with_allocator(const struct EventEmitterAllocator *allocator, size_t shard_count, size_t inbox_capacity)
+{
+  if (allocator == NULL || allocator->allocate == NULL || allocator->reallocate == NULL || allocator->deallocate == NULL)
+  {
+    return(NULL);
+  }
+
+  return(_eventemitter_sharded_new(allocator, shard_count, inbox_capacity));
+}
+
+
+void eventemitter_sharded_release(struct EventEmitterSharded *event_emitter)
+{
+  if (event_emitter == NULL)
+  {
+    return;
+  }
+
+  for (size_t index = 0; index < event_emitter->shard_count; index++)
+  {
+    eventemitter_release(event_emitter->shards[index]);
+  }
+
+  // the emitter is freed with its own allocator so a copy is needed
+  struct EventEmitterAllocator allocator = event_emitter->allocator;
+  allocator.deallocate(event_emitter, allocator.context);
+}
+
+
+size_t eventemitter_sharded_shards_count(struct EventEmitterSharded *event_emitter)
+{
+  if (event_emitter == NULL)
+  {
+    return(0);
+  }
+
+  return(event_emitter->shard_count);
+}
+
+
+struct EventEmitter *eventemitter_sharded_get_shard(struct EventEmitterSharded *event_emitter, size_t shard)
+{
+  if (event_emitter == NULL || shard >= event_emitter->shard_count)
+  {
+    return(NULL);
+  }
+
+  return(event_emitter->shards[shard]);
+}
+
+
+bool eventemitter_sharded_emit_to(struct EventEmitterSharded *event_emitter, size_t shard, int event_id, void *event_data)
+{
+  if (event_emitter == NULL || shard >= event_emitter->shard_count)
+  {
+    return(false);
+  }
+
+  return(eventemitter_enqueue(event_emitter->shards[shard], event_id, event_data));
+}
+
+
+size_t eventemitter_sharded_broadcast(struct EventEmitterSharded *event_emitter, int event_id, void *event_data)
+{
+  if (event_emitter == NULL)
+  {
+    return(0);
+  }
+
+  size_t queued = 0;
+  for (size_t index = 0; index < event_emitter->shard_count; index++)
+  {
+    if (eventemitter_enqueue(event_emitter->shards[index], event_id, event_data))
+    {
+      queued++;
+    }
+  }
+
+  return(queued);
+}
+
+
+int eventemitter_sharded_dispatch(struct EventEmitterSharded *event_emitter, size_t shard, size_t max_events)
+{
+  if (event_emitter == NULL || shard >= event_emitter->shard_count)
+  {
+    return(-1);
+  }
+
+  return(eventemitter_dispatch(event_emitter->shards[shard], max_events));
+}
+
+static struct EventEmitterSharded *_eventemitter_sharded_new(const struct EventEmitterAllocator *allocator, size_t shard_count, size_t inbox_capacity)
+{
+  if (!shard_count || !inbox_capacity || shard_count > (SIZE_MAX - sizeof(struct EventEmitterSharded)) / sizeof(struct EventEmitter *))
+  {
+    return(NULL);
+  }
+
+  // the shard pointers are stored right after the struct
+  struct EventEmitterSharded *event_emitter = allocator->allocate(sizeof(struct EventEmitterSharded) + shard_count * sizeof(struct EventEmitter *), allocator->context);
+  if (event_emitter == NULL)
+  {
+    return(NULL);
+  }
+
+  event_emitter->allocator   = *allocator;
+  event_emitter->shard_count = 0;
+  event_emitter->shards      = (struct EventEmitter **)(void *)(event_emitter + 1);
+
+  for (size_t index = 0; index < shard_count; index++)
+  {
+    struct EventEmitter *shard = eventemitter_new_with_allocator(&event_emitter->allocator);
+    if (shard == NULL || !eventemitter_init_queue(shard, inbox_capacity))
+    {
+      eventemitter_release(shard);
+      eventemitter_sharded_release(event_emitter);
+      return(NULL);
+    }
+
+    event_emitter->shards[index] = shard;
+    event_emitter->shard_count++;
+  }
+
+  return(event_emitter);
+}
+
+#endif
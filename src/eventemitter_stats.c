@@ -0,0 +1,86 @@
+#include "eventemitter_internal.h"
+
+#ifdef EVENTEMITTER_STATS
+
+#include <string.h>
+
+bool eventemitter_get_stats(struct EventEmitter *event_emitter, struct EventEmitterStats *stats)
+{
+  if (event_emitter == NULL || stats == NULL)
+  {
+    return(false);
+  }
+
+  *stats = event_emitter->stats;
+
+  return(true);
+}
+
+
+bool eventemitter_get_event_stats(struct EventEmitter *event_emitter, int event_id, struct EventEmitterStats *stats)
+{
+  if (event_emitter == NULL || stats == NULL)
+  {
+    return(false);
+  }
+
+  struct EventEmitterStats *event_stats = _eventemitter_map_get(&event_emitter->event_stats, (uint64_t)(unsigned int)event_id);
+  if (event_stats == NULL)
+  {
+    return(false);
+  }
+
+  *stats = *event_stats;
+
+  return(true);
+}
+
+
+bool eventemitter_iterate_event_stats(struct EventEmitter *event_emitter, void (*callback)(int event_id, const struct EventEmitterStats *stats, void *context), void *context)
+{
+  if (event_emitter == NULL || callback == NULL)
+  {
+    return(false);
+  }
+
+  struct EventEmitterMap *map = &event_emitter->event_stats;
+  for (size_t index = 0; index < map->capacity; index++)
+  {
+    if (map->entries[index].value != NULL)
+    {
+      callback((int)(unsigned int)map->entries[index].key, (const struct EventEmitterStats *)map->entries[index].value, context);
+    }
+  }
+
+  return(true);
+}
+
+
+struct EventEmitterStats *_eventemitter_stats_for_event_id(struct EventEmitter *event_emitter, int event_id)
+{
+  uint64_t                 key    = (uint64_t)(unsigned int)event_id;
+  struct EventEmitterStats *stats = _eventemitter_map_get(&event_emitter->event_stats, key);
+
+  if (stats != NULL)
+  {
+    return(stats);
+  }
+
+  stats = _eventemitter_pool_alloc(&event_emitter->event_stats_pool);
+  if (stats == NULL)
+  {
+    return(NULL);
+  }
+  memset(stats, 0, sizeof(struct EventEmitterStats));
+
+  if (!_eventemitter_map_put(&event_emitter->event_stats, key, stats))
+  {
+    _eventemitter_pool_free(&event_emitter->event_stats_pool, stats);
+    return(NULL);
+  }
+
+  return(stats);
+}
+
+#endif
+
@@ -0,0 +1,374 @@
+#include "eventemitter_alloc.h"
+
+#ifdef EVENTEMITTER_THREADS
+
+#include "eventemitter_workers.h"
+#include <pthread.h>
+#include <stdint.h>
+
+#define EVENTEMITTER_WORKER_DEQUE_CAPACITY    256
+
+// Chase-Lev deque, the owner pushes and pops at the bottom while thieves steal from the top
+struct EventEmitterWorkerDeque
+{
+  atomic_size_t                           top;
+  char                                    top_padding[EVENTEMITTER_CACHE_LINE_SIZE - sizeof(atomic_size_t)];
+  atomic_size_t                           bottom;
+  char                                    bottom_padding[EVENTEMITTER_CACHE_LINE_SIZE - sizeof(atomic_size_t)];
+  _Atomic(struct EventEmitterWorkerTask *)tasks[EVENTEMITTER_WORKER_DEQUE_CAPACITY];
+};
+
+struct EventEmitterWorker
+{
+  struct EventEmitterWorkerDeque deque;
+  struct EventEmitterWorkers     *workers;
+  size_t                         index;
+  pthread_t                      thread;
+};
+
+struct EventEmitterWorkers
+{
+  const struct EventEmitterAllocator *allocator;
+  struct EventEmitterWorker          *workers;
+  size_t                             count;
+  pthread_mutex_t                    lock;
+  pthread_cond_t                     work_available;
+  pthread_cond_t                     done;
+  // submitted groups not yet taken by a worker, protected by the lock
+  struct EventEmitterWorkerTask      *first_group;
+  struct EventEmitterWorkerTask      *last_group;
+  atomic_size_t                      idle;
+  bool                               stopping;
+};
+
+// private functions
+static void _eventemitter_workers_stop(struct EventEmitterWorkers *, size_t);
+static void *_eventemitter_worker_run(void *);
+static struct EventEmitterWorkerTask *_eventemitter_worker_find_task(struct EventEmitterWorker *);
+static struct EventEmitterWorkerTask *_eventemitter_worker_take_group(struct EventEmitterWorker *);
+static void _eventemitter_workers_wake(struct EventEmitterWorkers *);
+static bool _eventemitter_deque_push(struct EventEmitterWorkerDeque *, struct EventEmitterWorkerTask *);
+static struct EventEmitterWorkerTask *_eventemitter_deque_pop(struct EventEmitterWorkerDeque *);
+static struct EventEmitterWorkerTask *_eventemitter_deque_steal(struct EventEmitterWorkerDeque *);
+
+struct EventEmitterWorkers *_eventemitter_workers_new(const struct EventEmitterAllocator *allocator, size_t count)
+{
+  if (allocator == NULL || !count || count > SIZE_MAX / sizeof(struct EventEmitterWorker))
+  {
+    return(NULL);
+  }
+
+  struct EventEmitterWorkers *workers = allocator->allocate(sizeof(struct EventEmitterWorkers), allocator->context);
+  if (workers == NULL)
+  {
+    return(NULL);
+  }
+
+  workers->allocator   = allocator;
+  workers->count       = count;
+  workers->first_group = NULL;
+  workers->last_group  = NULL;
+  workers->stopping    = false;
+  atomic_init(&workers->idle, 0);
+  workers->workers = _eventemitter_aligned_alloc(allocator, count * sizeof(struct EventEmitterWorker));
+  if (workers->workers == NULL)
+  {
+    allocator->deallocate(workers, allocator->context);
+    return(NULL);
+  }
+  pthread_mutex_init(&workers->lock, NULL);
+  pthread_cond_init(&workers->work_available, NULL);
+  pthread_cond_init(&workers->done, NULL);
+
+  for (size_t index = 0; index < count; index++)
+  {
+    struct EventEmitterWorker *worker = &workers->workers[index];
+    worker->workers = workers;
+    worker->index   = index;
+    atomic_init(&worker->deque.top, 0);
+    atomic_init(&worker->deque.bottom, 0);
+  }
+
+  // deques of workers that failed to start stay empty, so the other workers can still try to steal from them
+  size_t started = 0;
+  for ( ; started < count; started++)
+  {
+    if (pthread_create(&workers->workers[started].thread, NULL, _eventemitter_worker_run, &workers->workers[started]))
+    {
+      break;
+    }
+  }
+
+  if (started < count)
+  {
+    _eventemitter_workers_stop(workers, started);
+    return(NULL);
+  }
+
+  return(workers);
+} /* _eventemitter_workers_new */
+
+
+void _eventemitter_workers_release(struct EventEmitterWorkers *workers)
+{
+  if (workers != NULL)
+  {
+    _eventemitter_workers_stop(workers, workers->count);
+  }
+}
+
+
+void _eventemitter_workers_submit(struct EventEmitterWorkers *workers, struct EventEmitterWorkerTask *tasks)
+{
+  tasks->next_group = NULL;
+
+  pthread_mutex_lock(&workers->lock);
+  if (workers->last_group == NULL)
+  {
+    workers->first_group = tasks;
+  }
+  else
+  {
+    workers->last_group->next_group = tasks;
+  }
+  workers->last_group = tasks;
+  pthread_cond_signal(&workers->work_available);
+  pthread_mutex_unlock(&workers->lock);
+}
+
+
+void _eventemitter_workers_notify(struct EventEmitterWorkers *workers, atomic_bool *done)
+{
+  pthread_mutex_lock(&workers->lock);
+  atomic_store(done, true);
+  pthread_cond_broadcast(&workers->done);
+  pthread_mutex_unlock(&workers->lock);
+}
+
+
+void _eventemitter_workers_wait(struct EventEmitterWorkers *workers, atomic_bool *done)
+{
+  pthread_mutex_lock(&workers->lock);
+  while (!atomic_load(done))
+  {
+    pthread_cond_wait(&workers->done, &workers->lock);
+  }
+  pthread_mutex_unlock(&workers->lock);
+}
+
+
+static void _eventemitter_workers_stop(struct EventEmitterWorkers *workers, size_t started)
+{
+  // the workers exit once no task is left
+  pthread_mutex_lock(&workers->lock);
+  workers->stopping = true;
+  pthread_cond_broadcast(&workers->work_available);
+  pthread_mutex_unlock(&workers->lock);
+
+  for (size_t index = 0; index < started; index++)
+  {
+    pthread_join(workers->workers[index].thread, NULL);
+  }
+
+  pthread_cond_destroy(&workers->done);
+  pthread_cond_destroy(&workers->work_available);
+  pthread_mutex_destroy(&workers->lock);
+  _eventemitter_aligned_free(workers->allocator, workers->workers);
+  workers->allocator->deallocate(workers, workers->allocator->context);
+}
+
+
+static void *_eventemitter_worker_run(void *context)
+{
+  struct EventEmitterWorker  *worker  = (struct EventEmitterWorker *)context;
+  struct EventEmitterWorkers *workers = worker->workers;
+
+  for ( ; ; )
+  {
+    struct EventEmitterWorkerTask *task = _eventemitter_worker_find_task(worker);
+
+    if (task == NULL)
+    {
+      // the worker is marked idle before checking again, so a worker pushing tasks either sees it and wakes it up
+      // or the tasks are found here
+      pthread_mutex_lock(&workers->lock);
+      atomic_fetch_add(&workers->idle, 1);
+      for ( ; ; )
+      {
+        task = _eventemitter_worker_take_group(worker);
+        if (task == NULL)
+        {
+          task = _eventemitter_worker_find_task(worker);
+        }
+        if (task != NULL || workers->stopping)
+        {
+          break;
+        }
+        pthread_cond_wait(&workers->work_available, &workers->lock);
+      }
+      atomic_fetch_sub(&workers->idle, 1);
+      pthread_mutex_unlock(&workers->lock);
+
+      if (task == NULL)
+      {
+        return(NULL);
+      }
+    }
+
+    task->run(task);
+  }
+}
+
+
+static struct EventEmitterWorkerTask *_eventemitter_worker_find_task(struct EventEmitterWorker *worker)
+{
+  struct EventEmitterWorkerTask *task = _eventemitter_deque_pop(&worker->deque);
+
+  if (task != NULL)
+  {
+    return(task);
+  }
+
+  struct EventEmitterWorkers *workers = worker->workers;
+  for (size_t offset = 1; offset < workers->count; offset++)
+  {
+    task = _eventemitter_deque_steal(&workers->workers[(worker->index + offset) % workers->count].deque);
+    if (task != NULL)
+    {
+      return(task);
+    }
+  }
+
+  return(NULL);
+}
+
+
+static struct EventEmitterWorkerTask *_eventemitter_worker_take_group(struct EventEmitterWorker *worker)
+{
+  // called with the lock held
+  struct EventEmitterWorkers    *workers = worker->workers;
+  struct EventEmitterWorkerTask *task    = workers->first_group;
+
+  if (task == NULL)
+  {
+    return(NULL);
+  }
+
+  workers->first_group = task->next_group;
+  if (workers->first_group == NULL)
+  {
+    workers->last_group = NULL;
+  }
+
+  // the other tasks of the group are pushed to the worker deque so idle workers can steal them
+  struct EventEmitterWorkerTask *rest = task->next;
+  while (rest != NULL)
+  {
+    struct EventEmitterWorkerTask *next = rest->next;
+    if (!_eventemitter_deque_push(&worker->deque, rest))
+    {
+      // the deque is full, the remaining tasks are put back as a group
+      rest->next_group     = workers->first_group;
+      workers->first_group = rest;
+      if (workers->last_group == NULL)
+      {
+        workers->last_group = rest;
+      }
+      break;
+    }
+    rest = next;
+  }
+
+  if (task->next != NULL)
+  {
+    _eventemitter_workers_wake(workers);
+  }
+
+  return(task);
+} /* _eventemitter_worker_take_group */
+
+
+static void _eventemitter_workers_wake(struct EventEmitterWorkers *workers)
+{
+  // called with the lock held by an idle worker, so it only wakes up if there are other idle workers
+  if (atomic_load(&workers->idle) > 1)
+  {
+    pthread_cond_broadcast(&workers->work_available);
+  }
+}
+
+
+static bool _eventemitter_deque_push(struct EventEmitterWorkerDeque *deque, struct EventEmitterWorkerTask *task)
+{
+  size_t bottom = atomic_load_explicit(&deque->bottom, memory_order_relaxed);
+  size_t top    = atomic_load_explicit(&deque->top, memory_order_acquire);
+
+  if (bottom - top >= EVENTEMITTER_WORKER_DEQUE_CAPACITY)
+  {
+    return(false);
+  }
+
+  atomic_store_explicit(&deque->tasks[bottom % EVENTEMITTER_WORKER_DEQUE_CAPACITY], task, memory_order_relaxed);
+  atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_release);
+
+  return(true);
+}
+
+
+static struct EventEmitterWorkerTask *_eventemitter_deque_pop(struct EventEmitterWorkerDeque *deque)
+{
+  size_t bottom = atomic_load_explicit(&deque->bottom, memory_order_relaxed);
+  size_t top    = atomic_load(&deque->top);
+
+  if (bottom == top)
+  {
+    return(NULL);
+  }
+
+  // reserve the last task before checking for thieves
+  bottom--;
+  atomic_store(&deque->bottom, bottom);
+  top = atomic_load(&deque->top);
+
+  struct EventEmitterWorkerTask *task = NULL;
+  if ((ptrdiff_t)(bottom - top) >= 0)
+  {
+    task = atomic_load_explicit(&deque->tasks[bottom % EVENTEMITTER_WORKER_DEQUE_CAPACITY], memory_order_relaxed);
+    if (bottom != top)
+    {
+      return(task);
+    }
+
+    // last task, race with the thieves for it
+    if (!atomic_compare_exchange_strong(&deque->top, &top, top + 1))
+    {
+      task = NULL;
+    }
+  }
+  atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_relaxed);
+
+  return(task);
+}
+
+
+static struct EventEmitterWorkerTask *_eventemitter_deque_steal(struct EventEmitterWorkerDeque *deque)
+{
+  size_t top    = atomic_load(&deque->top);
+  size_t bottom = atomic_load(&deque->bottom);
+
+  if ((ptrdiff_t)(bottom - top) <= 0)
+  {
+    return(NULL);
+  }
+
+  struct EventEmitterWorkerTask *task = atomic_load_explicit(&deque->tasks[top % EVENTEMITTER_WORKER_DEQUE_CAPACITY], memory_order_relaxed);
+  if (!atomic_compare_exchange_strong(&deque->top, &top, top + 1))
+  {
+    return(NULL);
+  }
+
+  return(task);
+}
+
+#endif
+
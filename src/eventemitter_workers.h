@@ -0,0 +1,70 @@
+#ifndef EVENTEMITTER_WORKERS_H
+#define EVENTEMITTER_WORKERS_H
+
+#include "eventemitter.h"
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * A unit of work, embedded in the caller structs.
+ * The tasks of a submitted group are linked via the next pointer.
+ */
+struct EventEmitterWorkerTask
+{
+  void                          (*run)(struct EventEmitterWorkerTask *);
+  struct EventEmitterWorkerTask *next;
+  // links the submitted groups while they wait in the shared queue
+  struct EventEmitterWorkerTask *next_group;
+};
+
+/**
+ * Internal work stealing thread pool.
+ * Each worker owns a deque which it pushes to and pops from, idle workers steal from the other deques.
+ * Submitted groups wait in a shared queue until a worker takes them, that worker pushes the group tasks
+ * to its own deque so the other workers can steal them.
+ */
+struct EventEmitterWorkers;
+
+/**
+ * Creates the pool and starts its threads.
+ *
+ * @param allocator - The allocator used for the pool memory (must outlive the pool)
+ * @param worker count - The amount of threads
+ * @returns the pool or NULL in case of invalid input or failure
+ */
+struct EventEmitterWorkers *_eventemitter_workers_new(const struct EventEmitterAllocator *, size_t /* worker count */);
+
+/**
+ * Runs all submitted tasks, stops the threads and frees the pool.
+ *
+ * @param workers - The pool (may be NULL)
+ */
+void _eventemitter_workers_release(struct EventEmitterWorkers *);
+
+/**
+ * Submits a group of tasks (linked via the next pointer) to be run by the workers.
+ *
+ * @param workers - The pool
+ * @param tasks - The first task of the group
+ */
+void _eventemitter_workers_submit(struct EventEmitterWorkers *, struct EventEmitterWorkerTask *);
+
+/**
+ * Sets the flag and wakes up the threads waiting for it.
+ *
+ * @param workers - The pool
+ * @param done - The flag to set
+ */
+void _eventemitter_workers_notify(struct EventEmitterWorkers *, atomic_bool *);
+
+/**
+ * Blocks until the flag is set via notify.
+ *
+ * @param workers - The pool
+ * @param done - The flag to wait for
+ */
+void _eventemitter_workers_wait(struct EventEmitterWorkers *, atomic_bool *);
+
+#endif
+
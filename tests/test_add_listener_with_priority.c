@@ -0,0 +1,163 @@
+#include "test.h"
+#include <string.h>
+
+#define TEST_LISTENERS    200
+
+struct TestAllocatorLimit
+{
+  bool failing;
+};
+
+struct EventEmitter *_test_global_emitter = NULL;
+char                _test_global_order[256];
+int                 *_test_global_invoked[TEST_LISTENERS];
+int                 _test_global_counter = 0;
+
+
+void *_test_allocate(size_t size, void *context)
+{
+  struct TestAllocatorLimit *limit = (struct TestAllocatorLimit *)context;
+
+  return(limit->failing ? NULL : malloc(size));
+}
+
+
+void *_test_reallocate(void *pointer, size_t size, void *context)
+{
+  struct TestAllocatorLimit *limit = (struct TestAllocatorLimit *)context;
+
+  return(limit->failing ? NULL : realloc(pointer, size));
+}
+
+
+void _test_deallocate(void *pointer, void *context)
+{
+  (void)context;
+
+  free(pointer);
+}
+
+
+void _test_cb(void *event_data, void *context)
+{
+  assert_string_equal((char *)event_data, "event");
+
+  strcat(_test_global_order, (char *)context);
+}
+
+
+void _test_add_cb(void *event_data, void *context)
+{
+  _test_cb(event_data, context);
+
+  // added during emit, invoked from the next emit in priority order
+  assert_true(eventemitter_add_listener_with_priority(_test_global_emitter, 1, 5, _test_cb, "X") > 0);
+  assert_true(eventemitter_prepend_listener(_test_global_emitter, 1, _test_cb, "Y") > 0);
+  assert_true(eventemitter_add_listener_with_priority(_test_global_emitter, 1, -5, _test_cb, "Z") > 0);
+}
+
+
+void _test_priority_cb(void *event_data, void *context)
+{
+  (void)event_data;
+
+  _test_global_invoked[_test_global_counter] = (int *)context;
+  _test_global_counter++;
+}
+
+
+void _test_check_many(struct EventEmitter *event_emitter, struct TestAllocatorLimit *limit)
+{
+  int priorities[TEST_LISTENERS];
+
+  for (int index = 0; index < TEST_LISTENERS; index++)
+  {
+    priorities[index] = (index * 37) % 11 - 5;
+    assert_true(eventemitter_add_listener_with_priority(event_emitter, 2, priorities[index], _test_priority_cb, &priorities[index]) > 0);
+  }
+
+  // out of order listeners are sorted even when no memory is available for sorting
+  if (limit != NULL)
+  {
+    limit->failing = true;
+  }
+  _test_global_counter = 0;
+  assert_num_equal(eventemitter_emit(event_emitter, 2, "event"), TEST_LISTENERS);
+  assert_num_equal(_test_global_counter, TEST_LISTENERS);
+  if (limit != NULL)
+  {
+    limit->failing = false;
+  }
+
+  // the contexts point into the priorities array, so a lower address means an earlier registration
+  for (int index = 1; index < TEST_LISTENERS; index++)
+  {
+    int *previous = _test_global_invoked[index - 1];
+    int *current  = _test_global_invoked[index];
+    assert_true(*previous > *current || (*previous == *current && previous < current));
+  }
+
+  assert_true(eventemitter_remove_all_event_listeners(event_emitter, 2));
+}
+
+
+void test_impl()
+{
+  _test_global_emitter = eventemitter_new();
+
+  assert_num_equal(eventemitter_add_listener_with_priority(NULL, 1, 1, _test_cb, "A"), 0);
+  assert_num_equal(eventemitter_add_listener_with_priority(_test_global_emitter, 1, 1, NULL, "A"), 0);
+
+  // higher priorities first, equal priorities by registration order, plain listeners have priority 0
+  assert_num_equal(eventemitter_add_listener(_test_global_emitter, 1, _test_cb, "A"), 1);
+  assert_num_equal(eventemitter_add_listener_with_priority(_test_global_emitter, 1, 10, _test_cb, "B"), 2);
+  assert_num_equal(eventemitter_add_listener_with_priority(_test_global_emitter, 1, -10, _test_cb, "C"), 3);
+  assert_num_equal(eventemitter_add_listener_with_priority(_test_global_emitter, 1, 10, _test_cb, "D"), 4);
+  assert_num_equal(eventemitter_add_listener_with_priority(_test_global_emitter, 1, 0, _test_cb, "E"), 5);
+  _test_global_order[0] = 0;
+  assert_num_equal(eventemitter_emit(_test_global_emitter, 1, "event"), 5);
+  assert_string_equal(_test_global_order, "BDAEC");
+
+  // prepended listeners are first among the priority 0 listeners
+  assert_num_equal(eventemitter_prepend_listener(_test_global_emitter, 1, _test_cb, "F"), 6);
+  assert_num_equal(eventemitter_add_listener_with_priority(_test_global_emitter, 1, 20, _test_cb, "G"), 7);
+  _test_global_order[0] = 0;
+  assert_num_equal(eventemitter_emit(_test_global_emitter, 1, "event"), 7);
+  assert_string_equal(_test_global_order, "GBDFAEC");
+
+  // removals keep the order
+  assert_num_equal(eventemitter_remove_listener_by_id(_test_global_emitter, 2), 1);
+  assert_num_equal(eventemitter_remove_listener(_test_global_emitter, 1, 6), 1);
+  _test_global_order[0] = 0;
+  assert_num_equal(eventemitter_emit(_test_global_emitter, 1, "event"), 5);
+  assert_string_equal(_test_global_order, "GDAEC");
+
+  // listeners added during emit
+  assert_true(eventemitter_remove_all_event_listeners(_test_global_emitter, 1));
+  assert_true(eventemitter_add_listener_with_priority(_test_global_emitter, 1, 1, _test_add_cb, "A") > 0);
+  assert_true(eventemitter_add_listener(_test_global_emitter, 1, _test_cb, "B") > 0);
+  _test_global_order[0] = 0;
+  assert_num_equal(eventemitter_emit(_test_global_emitter, 1, "event"), 2);
+  assert_string_equal(_test_global_order, "AB");
+  assert_num_equal(eventemitter_remove_listener_by_id(_test_global_emitter, 8), 1);
+  _test_global_order[0] = 0;
+  assert_num_equal(eventemitter_emit(_test_global_emitter, 1, "event"), 4);
+  assert_string_equal(_test_global_order, "XYBZ");
+
+  _test_check_many(_test_global_emitter, NULL);
+
+  eventemitter_release(_test_global_emitter);
+
+  struct TestAllocatorLimit    limit     = { false };
+  struct EventEmitterAllocator allocator = { _test_allocate, _test_reallocate, _test_deallocate, &limit };
+  struct EventEmitter          *emitter  = eventemitter_new_with_allocator(&allocator);
+  _test_check_many(emitter, &limit);
+  eventemitter_release(emitter);
+} /* test_impl */
+
+
+int main()
+{
+  test_run(test_impl);
+}
+
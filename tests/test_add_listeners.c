@@ -0,0 +1,215 @@
+#include "test.h"
+#include <stdint.h>
+#include <string.h>
+
+#define TEST_SPECS    64
+
+struct TestAllocatorLimit
+{
+  size_t remaining;
+};
+
+char _test_global_order[64];
+
+
+void *_test_allocate(size_t size, void *context)
+{
+  struct TestAllocatorLimit *limit = (struct TestAllocatorLimit *)context;
+
+  if (!limit->remaining)
+  {
+    return(NULL);
+  }
+  limit->remaining--;
+
+  return(malloc(size));
+}
+
+
+void *_test_reallocate(void *pointer, size_t size, void *context)
+{
+  struct TestAllocatorLimit *limit = (struct TestAllocatorLimit *)context;
+
+  if (!limit->remaining)
+  {
+    return(NULL);
+  }
+  limit->remaining--;
+
+  return(realloc(pointer, size));
+}
+
+
+void _test_deallocate(void *pointer, void *context)
+{
+  (void)context;
+
+  free(pointer);
+}
+
+
+void _test_cb(void *event_data, void *context)
+{
+  assert_string_equal((char *)event_data, "event");
+
+  strcat(_test_global_order, (char *)context);
+}
+
+
+void _test_unhandled_cb(int event_id, void *event_data, void *context)
+{
+  (void)event_id;
+  (void)event_data;
+  (void)context;
+}
+
+
+void test_impl()
+{
+  struct EventEmitter *event_emitter = eventemitter_new();
+
+  struct EventEmitterListenerSpec specs[] =
+  {
+    { 1, _test_cb, "A", false, false },
+    { 2, _test_cb, "B", false, false },
+    { 1, _test_cb, "C", true,  false },
+    { 1, _test_cb, "D", false, true  },
+    { 1, _test_cb, "E", false, true  },
+  };
+  unsigned int callback_ids[5];
+
+  assert_true(!eventemitter_add_listeners(NULL, specs, 5, callback_ids));
+  assert_true(!eventemitter_add_listeners(event_emitter, NULL, 5, callback_ids));
+  assert_true(eventemitter_add_listeners(event_emitter, NULL, 0, NULL));
+  specs[1].callback = NULL;
+  assert_true(!eventemitter_add_listeners(event_emitter, specs, 5, callback_ids));
+  assert_num_equal(eventemitter_listeners_count(event_emitter, 1), 0);
+  specs[1].callback = _test_cb;
+
+  // same as adding one by one
+  assert_true(eventemitter_add_listeners(event_emitter, specs, 5, callback_ids));
+  assert_num_equal(eventemitter_listeners_count(event_emitter, 1), 4);
+  assert_num_equal(eventemitter_listeners_count(event_emitter, 2), 1);
+  for (size_t index = 1; index < 5; index++)
+  {
+    assert_num_equal(callback_ids[index], callback_ids[index - 1] + 1);
+  }
+  _test_global_order[0] = 0;
+  assert_num_equal(eventemitter_emit(event_emitter, 1, "event"), 4);
+  assert_string_equal(_test_global_order, "EDAC");
+  _test_global_order[0] = 0;
+  assert_num_equal(eventemitter_emit(event_emitter, 1, "event"), 3);
+  assert_string_equal(_test_global_order, "EDA");
+
+  // bulk remove, including unknown and unhandled listener IDs
+  unsigned int unhandled_id   = eventemitter_else(event_emitter, _test_unhandled_cb, NULL);
+  unsigned int remove_ids[]   = { callback_ids[0], callback_ids[1], callback_ids[2], 0, unhandled_id, callback_ids[0] };
+  assert_num_equal(eventemitter_remove_listeners(NULL, remove_ids, 6), -1);
+  assert_num_equal(eventemitter_remove_listeners(event_emitter, NULL, 6), -1);
+  assert_num_equal(eventemitter_remove_listeners(event_emitter, remove_ids, 6), 3);
+  assert_num_equal(eventemitter_listeners_count(event_emitter, 1), 2);
+  assert_num_equal(eventemitter_listeners_count(event_emitter, 2), 0);
+  assert_num_equal(eventemitter_emit(event_emitter, 3, "event"), 0);
+
+  eventemitter_release(event_emitter);
+
+  // mixed prepends and appends next to existing listeners of other priorities
+  event_emitter = eventemitter_new();
+  assert_true(eventemitter_add_listener_with_priority(event_emitter, 1, 5, _test_cb, "H") > 0);
+  assert_true(eventemitter_on(event_emitter, 1, _test_cb, "M") > 0);
+  assert_true(eventemitter_add_listener_with_priority(event_emitter, 1, -5, _test_cb, "L") > 0);
+  struct EventEmitterListenerSpec mixed_specs[] =
+  {
+    { 1, _test_cb, "a", false, true  },
+    { 1, _test_cb, "b", false, false },
+    { 2, _test_cb, "x", false, true  },
+    { 1, _test_cb, "c", false, true  },
+    { 1, _test_cb, "d", true,  false },
+    { 1, _test_cb, "e", false, true  },
+  };
+  unsigned int mixed_ids[6];
+  assert_true(eventemitter_add_listeners(event_emitter, mixed_specs, 6, mixed_ids));
+  for (size_t index = 1; index < 6; index++)
+  {
+    assert_num_equal(mixed_ids[index], mixed_ids[index - 1] + 1);
+  }
+  _test_global_order[0] = 0;
+  assert_num_equal(eventemitter_emit(event_emitter, 1, "event"), 8);
+  assert_string_equal(_test_global_order, "HecaMbdL");
+  _test_global_order[0] = 0;
+  assert_num_equal(eventemitter_emit(event_emitter, 1, "event"), 7);
+  assert_string_equal(_test_global_order, "HecaMbL");
+  assert_num_equal(eventemitter_remove_listeners(event_emitter, &mixed_ids[3], 1), 1);
+  _test_global_order[0] = 0;
+  assert_num_equal(eventemitter_emit(event_emitter, 1, "event"), 6);
+  assert_string_equal(_test_global_order, "HeaMbL");
+
+  eventemitter_release(event_emitter);
+
+  // either all listeners are added or none
+  struct EventEmitterListenerSpec many_specs[TEST_SPECS];
+  for (int index = 0; index < TEST_SPECS; index++)
+  {
+    many_specs[index].event_id = index % 3;
+    many_specs[index].callback = _test_cb;
+    many_specs[index].context  = "X";
+    many_specs[index].once     = false;
+    many_specs[index].prepend  = index % 2;
+  }
+
+  struct TestAllocatorLimit    limit     = { SIZE_MAX };
+  struct EventEmitterAllocator allocator = { _test_allocate, _test_reallocate, _test_deallocate, &limit };
+  event_emitter = eventemitter_new_with_allocator(&allocator);
+  assert_true(eventemitter_on(event_emitter, 0, _test_cb, "Y") > 0);
+
+  bool added = false;
+  for (size_t allocations = 0; !added; allocations++)
+  {
+    limit.remaining = allocations;
+    added           = eventemitter_add_listeners(event_emitter, many_specs, TEST_SPECS, NULL);
+    limit.remaining = SIZE_MAX;
+
+    if (!added)
+    {
+      assert_num_equal(eventemitter_listeners_count(event_emitter, 0), 1);
+      assert_num_equal(eventemitter_listeners_count(event_emitter, 1), 0);
+      assert_num_equal(eventemitter_listeners_count(event_emitter, 2), 0);
+    }
+  }
+  assert_num_equal(eventemitter_listeners_count(event_emitter, 0), 1 + (TEST_SPECS + 2) / 3);
+  assert_num_equal(eventemitter_listeners_count(event_emitter, 1), (TEST_SPECS + 1) / 3);
+  assert_num_equal(eventemitter_listeners_count(event_emitter, 2), TEST_SPECS / 3);
+
+  eventemitter_release(event_emitter);
+
+  // a failed add keeps the retained events and releases only the events it created
+  event_emitter = eventemitter_new_with_allocator(&allocator);
+  assert_true(eventemitter_set_retention(event_emitter, 4));
+  added = false;
+  for (size_t allocations = 0; !added; allocations++)
+  {
+    eventemitter_remove_listener_by_id(event_emitter, eventemitter_on(event_emitter, 1, _test_cb, "Y"));
+
+    limit.remaining = allocations;
+    added           = eventemitter_add_listeners(event_emitter, many_specs, TEST_SPECS, NULL);
+    limit.remaining = SIZE_MAX;
+
+    if (!added)
+    {
+      assert_num_equal(eventemitter_listeners_count(event_emitter, 0), 0);
+      assert_num_equal(eventemitter_listeners_count(event_emitter, 1), 0);
+      assert_num_equal(eventemitter_compact(event_emitter), 1);
+    }
+  }
+  assert_num_equal(eventemitter_listeners_count(event_emitter, 1), (TEST_SPECS + 1) / 3);
+  assert_num_equal(eventemitter_compact(event_emitter), 0);
+
+  eventemitter_release(event_emitter);
+} /* test_impl */
+
+
+int main()
+{
+  test_run(test_impl);
+}
+
@@ -0,0 +1,106 @@
+#include "test.h"
+
+struct TestAllocatorStats
+{
+  size_t allocations;
+  size_t reallocations;
+  size_t outstanding;
+};
+
+int _test_global_counter = 0;
+
+
+void *_test_allocate(size_t size, void *context)
+{
+  struct TestAllocatorStats *stats = (struct TestAllocatorStats *)context;
+
+  stats->allocations++;
+  stats->outstanding++;
+
+  return(malloc(size));
+}
+
+
+void *_test_reallocate(void *pointer, size_t size, void *context)
+{
+  struct TestAllocatorStats *stats = (struct TestAllocatorStats *)context;
+
+  stats->reallocations++;
+  if (pointer == NULL)
+  {
+    stats->outstanding++;
+  }
+
+  return(realloc(pointer, size));
+}
+
+
+void _test_deallocate(void *pointer, void *context)
+{
+  struct TestAllocatorStats *stats = (struct TestAllocatorStats *)context;
+
+  stats->outstanding--;
+
+  free(pointer);
+}
+
+
+void _test_cb(void *event_data, void *context)
+{
+  assert_string_equal((char *)event_data, "event");
+  assert_true(context == NULL);
+
+  _test_global_counter++;
+}
+
+
+void test_impl()
+{
+  struct TestAllocatorStats    stats     = { 0, 0, 0 };
+  struct EventEmitterAllocator allocator = { _test_allocate, _test_reallocate, _test_deallocate, &stats };
+
+  assert_true(eventemitter_new_with_allocator(NULL) == NULL);
+  allocator.reallocate = NULL;
+  assert_true(eventemitter_new_with_allocator(&allocator) == NULL);
+  allocator.reallocate = _test_reallocate;
+
+  struct EventEmitter *event_emitter = eventemitter_new_with_allocator(&allocator);
+  assert_true(event_emitter != NULL);
+  assert_true(stats.allocations > 0);
+
+  // grow a single event past the pooled capacity so the realloc hook is used
+  for (size_t index = 0; index < 100; index++)
+  {
+    assert_true(eventemitter_on(event_emitter, 1, _test_cb, NULL) > 0);
+  }
+  assert_true(stats.reallocations > 0);
+  assert_num_equal(eventemitter_emit(event_emitter, 1, "event"), 100);
+  assert_num_equal(_test_global_counter, 100);
+
+  // add/remove churn on other events is served from the pools once warmed up
+  unsigned int id = 0;
+  for (int index = 0; index < 8; index++)
+  {
+    id = eventemitter_once(event_emitter, 2 + index, _test_cb, NULL);
+    assert_num_equal(eventemitter_remove_listener(event_emitter, 2 + index, id), 1);
+  }
+  size_t allocations = stats.allocations;
+  for (int index = 0; index < 1000; index++)
+  {
+    id = eventemitter_once(event_emitter, 2 + index % 8, _test_cb, NULL);
+    assert_true(id > 0);
+    assert_num_equal(eventemitter_emit(event_emitter, 2 + index % 8, "event"), 1);
+  }
+  assert_num_equal(stats.allocations, allocations);
+  assert_num_equal(_test_global_counter, 1100);
+
+  eventemitter_release(event_emitter);
+  assert_num_equal(stats.outstanding, 0);
+} /* test_impl */
+
+
+int main()
+{
+  test_run(test_impl);
+}
+
@@ -0,0 +1,201 @@
+#include "eventemitter_bus.h"
+#include "test.h"
+
+#if defined(EVENTEMITTER_THREADS) && defined(__linux__)
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#define TEST_EVENTS    10000
+
+size_t _test_global_counter = 0;
+size_t _test_global_ended   = 0;
+
+
+void _test_cb(void *event_data, void *context)
+{
+  struct EventEmitterBusPayload *payload = (struct EventEmitterBusPayload *)event_data;
+
+  assert_true(context == NULL);
+  assert_num_equal(payload->size, sizeof(size_t));
+
+  // events of a single producer arrive in order
+  size_t value;
+  memcpy(&value, payload->data, sizeof(size_t));
+  assert_num_equal(value, _test_global_counter);
+
+  _test_global_counter++;
+}
+
+
+void _test_end_cb(void *event_data, void *context)
+{
+  struct EventEmitterBusPayload *payload = (struct EventEmitterBusPayload *)event_data;
+
+  assert_true(context == NULL);
+  assert_num_equal(payload->size, 0);
+
+  _test_global_ended++;
+}
+
+
+void _test_child(int fd)
+{
+  struct EventEmitterBus *bus = eventemitter_bus_open(fd);
+
+  assert_true(bus != NULL);
+  assert_num_equal(eventemitter_bus_max_payload_size(bus), 32);
+  for (size_t index = 0; index < TEST_EVENTS; index++)
+  {
+    while (!eventemitter_bus_emit(bus, 1, &index, sizeof(size_t)))
+    {
+      usleep(10);
+    }
+  }
+  while (!eventemitter_bus_emit(bus, 2, NULL, 0))
+  {
+    usleep(10);
+  }
+  eventemitter_bus_release(bus);
+}
+
+
+int _test_forge(size_t mask, size_t cell_size, size_t max_payload_size, size_t file_size)
+{
+  // the shared header starts with the magic, mask, cell size and max payload size
+  FILE   *file       = tmpfile();
+  size_t settings[4] = { 0x45454255u, mask, cell_size, max_payload_size };
+
+  assert_true(file != NULL);
+  int fd = dup(fileno(file));
+  fclose(file);
+  assert_true(fd >= 0);
+  assert_num_equal(ftruncate(fd, (off_t)file_size), 0);
+  assert_num_equal(pwrite(fd, settings, sizeof(settings), 0), sizeof(settings));
+
+  return(fd);
+}
+
+
+void _test_check_forged()
+{
+  // a well formed header is accepted, so the rejections below are due to the forged settings
+  int                    fd   = _test_forge(1, 64, 8, 3 * 64 + 2 * 64);
+  struct EventEmitterBus *bus = eventemitter_bus_open(fd);
+  assert_true(bus != NULL);
+  eventemitter_bus_release(bus);
+  close(fd);
+
+  // a mask wrapping the cell count to 0, which matches a file without cells
+  fd = _test_forge(SIZE_MAX, (size_t)1 << 30, 0, 3 * 64);
+  assert_true(eventemitter_bus_open(fd) == NULL);
+  close(fd);
+
+  // cells which are not cache line aligned
+  fd = _test_forge(1, 40, 8, 3 * 64 + 2 * 40);
+  assert_true(eventemitter_bus_open(fd) == NULL);
+  close(fd);
+}
+
+
+void test_impl()
+{
+  assert_true(eventemitter_bus_create(0, 8) == NULL);
+  assert_true(eventemitter_bus_open(-1) == NULL);
+  assert_true(eventemitter_bus_open(STDIN_FILENO) == NULL);
+  assert_num_equal(eventemitter_bus_get_fd(NULL), -1);
+  assert_num_equal(eventemitter_bus_max_payload_size(NULL), 0);
+  assert_true(!eventemitter_bus_emit(NULL, 1, NULL, 0));
+  assert_num_equal(eventemitter_bus_dispatch(NULL, NULL, 0), -1);
+  assert_num_equal(eventemitter_bus_wait(NULL, 0), -1);
+  eventemitter_bus_release(NULL);
+  _test_check_forged();
+
+  struct EventEmitterBus *bus           = eventemitter_bus_create(16, 32);
+  struct EventEmitter    *event_emitter = eventemitter_new();
+  assert_true(bus != NULL);
+  assert_true(eventemitter_bus_get_fd(bus) >= 0);
+  assert_num_equal(eventemitter_bus_dispatch(bus, NULL, 0), -1);
+  assert_true(eventemitter_on(event_emitter, 1, _test_cb, NULL) > 0);
+  assert_true(eventemitter_on(event_emitter, 2, _test_end_cb, NULL) > 0);
+
+  // payload limits, a full bus and an empty bus
+  char payload[33] = { 0 };
+  assert_true(!eventemitter_bus_emit(bus, 3, payload, 33));
+  assert_true(!eventemitter_bus_emit(bus, 3, NULL, 1));
+  for (size_t index = 0; index < 16; index++)
+  {
+    assert_true(eventemitter_bus_emit(bus, 3, payload, 32));
+  }
+  assert_true(!eventemitter_bus_emit(bus, 3, payload, 32));
+  assert_num_equal(eventemitter_bus_wait(bus, 0), 1);
+  assert_num_equal(eventemitter_bus_dispatch(bus, event_emitter, 10), 10);
+  assert_num_equal(eventemitter_bus_dispatch(bus, event_emitter, 0), 6);
+  assert_num_equal(eventemitter_bus_wait(bus, 0), 0);
+  assert_num_equal(eventemitter_bus_wait(bus, 20), 0);
+  assert_num_equal(eventemitter_bus_dispatch(bus, event_emitter, 0), 0);
+
+  // settings rewritten in the shared header after the bus was opened are ignored
+  struct EventEmitterBus *opened = eventemitter_bus_open(eventemitter_bus_get_fd(bus));
+  assert_true(opened != NULL);
+  size_t *settings = mmap(NULL, 4 * sizeof(size_t), PROT_READ | PROT_WRITE, MAP_SHARED, eventemitter_bus_get_fd(bus), 0);
+  assert_true(settings != MAP_FAILED);
+  size_t original[3];
+  memcpy(original, &settings[1], sizeof(original));
+  settings[1] = (size_t)-1;
+  settings[2] = (size_t)-1;
+  settings[3] = (size_t)-1;
+  assert_num_equal(eventemitter_bus_max_payload_size(opened), 32);
+  assert_true(!eventemitter_bus_emit(opened, 3, payload, 33));
+  for (size_t index = 0; index < 16; index++)
+  {
+    assert_true(eventemitter_bus_emit(opened, 3, payload, 32));
+  }
+  assert_num_equal(eventemitter_bus_dispatch(opened, event_emitter, 0), 16);
+  assert_true(eventemitter_bus_open(eventemitter_bus_get_fd(bus)) == NULL);
+  memcpy(&settings[1], original, sizeof(original));
+  munmap(settings, 4 * sizeof(size_t));
+  eventemitter_bus_release(opened);
+
+  // events from another process
+  pid_t pid = fork();
+  if (!pid)
+  {
+    _test_child(eventemitter_bus_get_fd(bus));
+    _exit(0);
+  }
+  assert_true(pid > 0);
+  while (!_test_global_ended)
+  {
+    assert_num_equal(eventemitter_bus_wait(bus, -1), 1);
+    assert_true(eventemitter_bus_dispatch(bus, event_emitter, 0) > 0);
+  }
+  assert_num_equal(_test_global_counter, TEST_EVENTS);
+  assert_num_equal(_test_global_ended, 1);
+
+  int status = 0;
+  assert_true(waitpid(pid, &status, 0) == pid);
+  assert_true(WIFEXITED(status) && !WEXITSTATUS(status));
+
+  eventemitter_release(event_emitter);
+  eventemitter_bus_release(bus);
+} /* test_impl */
+
+#else
+
+
+void test_impl()
+{
+}
+
+#endif
+
+
+int main()
+{
+  test_run(test_impl);
+}
@@ -0,0 +1,179 @@
+#include "test.h"
+#include <string.h>
+
+struct TestAllocatorLimit
+{
+  bool failing;
+};
+
+struct EventEmitter *_test_global_emitter = NULL;
+char                _test_global_order[64];
+int                 _test_global_merges = 0;
+
+
+void *_test_allocate(size_t size, void *context)
+{
+  struct TestAllocatorLimit *limit = (struct TestAllocatorLimit *)context;
+
+  return(limit->failing ? NULL : malloc(size));
+}
+
+
+void *_test_reallocate(void *pointer, size_t size, void *context)
+{
+  struct TestAllocatorLimit *limit = (struct TestAllocatorLimit *)context;
+
+  return(limit->failing ? NULL : realloc(pointer, size));
+}
+
+
+void _test_deallocate(void *pointer, void *context)
+{
+  (void)context;
+
+  free(pointer);
+}
+
+
+void _test_cb(void *event_data, void *context)
+{
+  (void)context;
+
+  strcat(_test_global_order, (char *)event_data);
+}
+
+
+void _test_requeue_cb(void *event_data, void *context)
+{
+  _test_cb(event_data, context);
+
+  // queued for the next dispatch
+  assert_true(eventemitter_coalesce(_test_global_emitter, 1, 0, "R"));
+  assert_true(eventemitter_coalesce(_test_global_emitter, 3, 0, "S"));
+  assert_num_equal(eventemitter_dispatch_coalesced(_test_global_emitter), 0);
+}
+
+
+void *_test_merge(int event_id, void *queued_data, void *event_data, void *context)
+{
+  assert_num_equal(event_id, 1);
+  assert_string_equal((char *)context, "merge");
+
+  _test_global_merges++;
+
+  return((void *)((size_t)queued_data + (size_t)event_data));
+}
+
+
+void _test_sum_cb(void *event_data, void *context)
+{
+  assert_num_equal((size_t)event_data, 10);
+  assert_true(context == NULL);
+
+  _test_global_merges = _test_global_merges + 100;
+}
+
+
+void test_impl()
+{
+  _test_global_emitter = eventemitter_new();
+
+  assert_true(!eventemitter_init_coalescing(NULL, EVENTEMITTER_COALESCE_KEEP_LAST, NULL, NULL));
+  assert_true(!eventemitter_init_coalescing(_test_global_emitter, EVENTEMITTER_COALESCE_MERGE, NULL, NULL));
+  assert_true(!eventemitter_coalesce(NULL, 1, 0, "A"));
+  assert_true(!eventemitter_coalesce(_test_global_emitter, 1, 0, "A"));
+  assert_num_equal(eventemitter_dispatch_coalesced(NULL), -1);
+  assert_num_equal(eventemitter_dispatch_coalesced(_test_global_emitter), 0);
+
+  assert_true(eventemitter_init_coalescing(_test_global_emitter, EVENTEMITTER_COALESCE_KEEP_LAST, NULL, NULL));
+  assert_true(!eventemitter_init_coalescing(_test_global_emitter, EVENTEMITTER_COALESCE_KEEP_LAST, NULL, NULL));
+  assert_true(eventemitter_on(_test_global_emitter, 1, _test_cb, NULL) > 0);
+  assert_true(eventemitter_on(_test_global_emitter, 2, _test_cb, NULL) > 0);
+  assert_true(eventemitter_on(_test_global_emitter, -2, _test_cb, NULL) > 0);
+
+  // keep last, dispatched in the order of first occurrence, keys and event IDs are not merged together
+  assert_true(eventemitter_coalesce(_test_global_emitter, 2, 0, "A"));
+  assert_true(eventemitter_coalesce(_test_global_emitter, 1, 0, "B"));
+  assert_true(eventemitter_coalesce(_test_global_emitter, 2, 0, "C"));
+  assert_true(eventemitter_coalesce(_test_global_emitter, 2, 7, "D"));
+  assert_true(eventemitter_coalesce(_test_global_emitter, -2, 0, "E"));
+  assert_true(eventemitter_coalesce(_test_global_emitter, 1, 0, "F"));
+  assert_true(eventemitter_coalesce(_test_global_emitter, 2, 7, "G"));
+  _test_global_order[0] = 0;
+  assert_num_equal(eventemitter_dispatch_coalesced(_test_global_emitter), 4);
+  assert_string_equal(_test_global_order, "CFGE");
+  assert_num_equal(eventemitter_dispatch_coalesced(_test_global_emitter), 0);
+
+  // events coalesced during dispatch
+  assert_true(eventemitter_on(_test_global_emitter, 3, _test_requeue_cb, NULL) > 0);
+  assert_true(eventemitter_coalesce(_test_global_emitter, 3, 0, "H"));
+  assert_true(eventemitter_coalesce(_test_global_emitter, 1, 0, "I"));
+  _test_global_order[0] = 0;
+  assert_num_equal(eventemitter_dispatch_coalesced(_test_global_emitter), 2);
+  assert_string_equal(_test_global_order, "HI");
+  _test_global_order[0] = 0;
+  assert_num_equal(eventemitter_dispatch_coalesced(_test_global_emitter), 2);
+  assert_string_equal(_test_global_order, "RS");
+  assert_num_equal(eventemitter_dispatch_coalesced(_test_global_emitter), 2);
+
+  // pending events are dropped on release
+  eventemitter_release(_test_global_emitter);
+
+  // keep first
+  struct EventEmitter *event_emitter = eventemitter_new();
+  assert_true(eventemitter_init_coalescing(event_emitter, EVENTEMITTER_COALESCE_KEEP_FIRST, NULL, NULL));
+  assert_true(eventemitter_on(event_emitter, 1, _test_cb, NULL) > 0);
+  for (size_t index = 0; index < 100; index++)
+  {
+    assert_true(eventemitter_coalesce(event_emitter, 1, 0, index ? "K" : "J"));
+  }
+  _test_global_order[0] = 0;
+  assert_num_equal(eventemitter_dispatch_coalesced(event_emitter), 1);
+  assert_string_equal(_test_global_order, "J");
+  eventemitter_release(event_emitter);
+
+  // merge
+  event_emitter = eventemitter_new();
+  assert_true(eventemitter_init_coalescing(event_emitter, EVENTEMITTER_COALESCE_MERGE, _test_merge, "merge"));
+  assert_true(eventemitter_on(event_emitter, 1, _test_sum_cb, NULL) > 0);
+  for (size_t index = 1; index <= 4; index++)
+  {
+    assert_true(eventemitter_coalesce(event_emitter, 1, 0, (void *)index));
+  }
+  assert_num_equal(eventemitter_dispatch_coalesced(event_emitter), 1);
+  assert_num_equal(_test_global_merges, 103);
+  eventemitter_release(event_emitter);
+
+  // many keys and allocation failures
+  struct TestAllocatorLimit    limit     = { false };
+  struct EventEmitterAllocator allocator = { _test_allocate, _test_reallocate, _test_deallocate, &limit };
+  event_emitter = eventemitter_new_with_allocator(&allocator);
+  limit.failing = true;
+  assert_true(!eventemitter_init_coalescing(event_emitter, EVENTEMITTER_COALESCE_KEEP_LAST, NULL, NULL));
+  limit.failing = false;
+  assert_true(eventemitter_init_coalescing(event_emitter, EVENTEMITTER_COALESCE_KEEP_LAST, NULL, NULL));
+  assert_true(eventemitter_on(event_emitter, 1, _test_cb, NULL) > 0);
+  for (unsigned int key = 0; key < 1000; key++)
+  {
+    assert_true(eventemitter_coalesce(event_emitter, 1, key, ""));
+    assert_true(eventemitter_coalesce(event_emitter, 1, key / 2, ""));
+  }
+  limit.failing = true;
+  assert_true(eventemitter_coalesce(event_emitter, 1, 5, ""));
+  unsigned int key = 1000;
+  while (key < 5000 && eventemitter_coalesce(event_emitter, 1, key, ""))
+  {
+    key++;
+  }
+  assert_true(key < 5000);
+  limit.failing = false;
+  assert_true(eventemitter_coalesce(event_emitter, 1, 5000, ""));
+  assert_true(eventemitter_dispatch_coalesced(event_emitter) > 1001);
+  eventemitter_release(event_emitter);
+} /* test_impl */
+
+
+int main()
+{
+  test_run(test_impl);
+}
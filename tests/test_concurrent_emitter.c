@@ -0,0 +1,151 @@
+#include "eventemitter_concurrent.h"
+#include "test.h"
+
+#ifdef EVENTEMITTER_THREADS
+
+#include <pthread.h>
+#include <stdatomic.h>
+
+#define TEST_THREADS             4
+#define TEST_EMITS_PER_THREAD    20000
+
+struct EventEmitterConcurrent *_test_global_emitter = NULL;
+atomic_int                    _test_global_counter = 0;
+int                           _test_global_order   = 0;
+unsigned int                  _test_global_id      = 0;
+
+
+void _test_cb_count(void *event_data, void *context)
+{
+  assert_string_equal((char *)event_data, "event");
+  assert_true(context == NULL);
+
+  atomic_fetch_add(&_test_global_counter, 1);
+}
+
+
+void _test_cb_order(void *event_data, void *context)
+{
+  assert_string_equal((char *)event_data, "event");
+
+  int order = (int)(size_t)context;
+  assert_num_equal(_test_global_order, order);
+  _test_global_order++;
+}
+
+
+void _test_cb_remove_self(void *event_data, void *context)
+{
+  assert_string_equal((char *)event_data, "event");
+  assert_true(context == NULL);
+
+  // changes from within callbacks apply to the next emits
+  assert_num_equal(eventemitter_concurrent_remove_listener(_test_global_emitter, _test_global_id), 1);
+  assert_true(eventemitter_concurrent_add_listener(_test_global_emitter, 3, _test_cb_count, NULL) > 0);
+}
+
+
+void _test_unhandled_cb(int event_id, void *event_data, void *context)
+{
+  assert_num_equal(event_id, 100);
+  assert_string_equal((char *)event_data, "event");
+  assert_string_equal((char *)context, "unhandled");
+
+  atomic_fetch_add(&_test_global_counter, 1);
+}
+
+
+void *_test_emit_thread(void *context)
+{
+  size_t invoked = 0;
+
+  (void)context;
+
+  for (int index = 0; index < TEST_EMITS_PER_THREAD; index++)
+  {
+    int count = eventemitter_concurrent_emit(_test_global_emitter, 1, "event");
+    assert_true(count >= 1 && count <= 2);
+    invoked = invoked + (size_t)count;
+  }
+
+  return((void *)invoked);
+}
+
+
+void test_impl()
+{
+  assert_true(eventemitter_concurrent_new_with_allocator(NULL) == NULL);
+  assert_num_equal(eventemitter_concurrent_emit(NULL, 1, "event"), -1);
+  assert_num_equal(eventemitter_concurrent_add_listener(NULL, 1, _test_cb_count, NULL), 0);
+
+  _test_global_emitter = eventemitter_concurrent_new();
+  assert_num_equal(eventemitter_concurrent_add_listener(_test_global_emitter, 1, NULL, NULL), 0);
+  assert_num_equal(eventemitter_concurrent_remove_listener(_test_global_emitter, 0), -1);
+  assert_num_equal(eventemitter_concurrent_remove_listener(_test_global_emitter, 1), 0);
+  assert_num_equal(eventemitter_concurrent_emit(_test_global_emitter, 1, "event"), 0);
+
+  // order and unhandled listeners
+  assert_true(eventemitter_concurrent_add_listener(_test_global_emitter, 2, _test_cb_order, (void *)1) > 0);
+  assert_true(eventemitter_concurrent_add_listener(_test_global_emitter, 2, _test_cb_order, (void *)2) > 0);
+  assert_true(eventemitter_concurrent_prepend_listener(_test_global_emitter, 2, _test_cb_order, (void *)0) > 0);
+  unsigned int unhandled_id = eventemitter_concurrent_add_unhandled_listener(_test_global_emitter, _test_unhandled_cb, "unhandled");
+  assert_true(unhandled_id > 0);
+  assert_num_equal(eventemitter_concurrent_listeners_count(_test_global_emitter, 2), 3);
+  assert_num_equal(eventemitter_concurrent_emit(_test_global_emitter, 2, "event"), 3);
+  assert_num_equal(_test_global_order, 3);
+  assert_num_equal(eventemitter_concurrent_emit(_test_global_emitter, 100, "event"), 1);
+  assert_num_equal(eventemitter_concurrent_remove_listener(_test_global_emitter, unhandled_id), 1);
+  assert_num_equal(eventemitter_concurrent_emit(_test_global_emitter, 100, "event"), 0);
+  assert_true(eventemitter_concurrent_remove_all_event_listeners(_test_global_emitter, 2));
+  assert_num_equal(eventemitter_concurrent_listeners_count(_test_global_emitter, 2), 0);
+
+  // listener changes from within a callback
+  _test_global_id = eventemitter_concurrent_add_listener(_test_global_emitter, 3, _test_cb_remove_self, NULL);
+  assert_num_equal(eventemitter_concurrent_emit(_test_global_emitter, 3, "event"), 1);
+  assert_num_equal(eventemitter_concurrent_emit(_test_global_emitter, 3, "event"), 1);
+  assert_num_equal(atomic_load(&_test_global_counter), 2);
+  assert_true(eventemitter_concurrent_remove_all_listeners(_test_global_emitter));
+  assert_num_equal(eventemitter_concurrent_listeners_count(_test_global_emitter, 3), 0);
+
+  // emit from many threads while listeners are changed
+  atomic_store(&_test_global_counter, 0);
+  assert_true(eventemitter_concurrent_add_listener(_test_global_emitter, 1, _test_cb_count, NULL) > 0);
+  pthread_t threads[TEST_THREADS];
+  for (int index = 0; index < TEST_THREADS; index++)
+  {
+    assert_num_equal(pthread_create(&threads[index], NULL, _test_emit_thread, NULL), 0);
+  }
+  for (int index = 0; index < 1000; index++)
+  {
+    unsigned int id = eventemitter_concurrent_add_listener(_test_global_emitter, 1 + index % 2, _test_cb_count, NULL);
+    assert_true(id > 0);
+    assert_num_equal(eventemitter_concurrent_remove_listener(_test_global_emitter, id), 1);
+  }
+  size_t invoked = 0;
+  for (int index = 0; index < TEST_THREADS; index++)
+  {
+    void *result = NULL;
+    assert_num_equal(pthread_join(threads[index], &result), 0);
+    invoked = invoked + (size_t)result;
+  }
+  assert_num_equal((size_t)atomic_load(&_test_global_counter), invoked);
+  assert_true(invoked >= TEST_THREADS * TEST_EMITS_PER_THREAD);
+
+  eventemitter_concurrent_release(_test_global_emitter);
+} /* test_impl */
+
+#else
+
+
+void test_impl()
+{
+}
+
+#endif
+
+
+int main()
+{
+  test_run(test_impl);
+}
+
@@ -0,0 +1,141 @@
+#include "test.h"
+
+#ifdef EVENTEMITTER_THREADS
+
+#include <sched.h>
+#include <stdatomic.h>
+
+#define TEST_LISTENERS    8
+#define TEST_EMITS        100
+
+atomic_int _test_global_counter   = 0;
+atomic_int _test_global_unhandled = 0;
+atomic_int _test_global_completed = 0;
+atomic_int _test_global_patterns  = 0;
+
+
+void _test_cb(void *event_data, void *context)
+{
+  assert_string_equal((char *)event_data, "event");
+  assert_string_equal((char *)context, "test");
+
+  atomic_fetch_add(&_test_global_counter, 1);
+}
+
+
+void _test_unhandled_cb(int event_id, void *event_data, void *context)
+{
+  assert_num_equal(event_id, 2);
+  assert_string_equal((char *)event_data, "event");
+  assert_true(context == NULL);
+
+  atomic_fetch_add(&_test_global_unhandled, 1);
+}
+
+
+void _test_pattern_cb(int event_id, void *event_data, void *context)
+{
+  assert_true(event_id == 1 || event_id == 15);
+  assert_string_equal((char *)event_data, "event");
+  assert_string_equal((char *)context, "pattern");
+
+  atomic_fetch_add(&_test_global_patterns, 1);
+}
+
+
+void _test_done_cb(int callback_counter, void *context)
+{
+  assert_num_equal(callback_counter, *(int *)context);
+
+  atomic_fetch_add(&_test_global_completed, 1);
+}
+
+
+void test_impl()
+{
+  struct EventEmitter *event_emitter = eventemitter_new();
+
+  assert_true(eventemitter_emit_async(event_emitter, 1, "event") == NULL);
+  assert_true(!eventemitter_start_workers(NULL, 4));
+  assert_true(!eventemitter_start_workers(event_emitter, 0));
+  assert_true(eventemitter_start_workers(event_emitter, 4));
+  assert_true(!eventemitter_start_workers(event_emitter, 4));
+  assert_num_equal(eventemitter_wait_async_emit(NULL), -1);
+
+  // no listeners at all
+  int expected = 0;
+  assert_num_equal(eventemitter_wait_async_emit(eventemitter_emit_async(event_emitter, 1, "event")), 0);
+  assert_true(eventemitter_emit_async_with_callback(event_emitter, 1, "event", _test_done_cb, &expected));
+  assert_num_equal(atomic_load(&_test_global_completed), 1);
+
+  for (int index = 0; index < TEST_LISTENERS; index++)
+  {
+    assert_true(eventemitter_on(event_emitter, 1, _test_cb, "test") > 0);
+  }
+  assert_true(eventemitter_once(event_emitter, 1, _test_cb, "test") > 0);
+  assert_true(eventemitter_else(event_emitter, _test_unhandled_cb, NULL) > 0);
+
+  // the 'once' listener is removed when the event is triggered
+  struct EventEmitterAsyncEmit *handle = eventemitter_emit_async(event_emitter, 1, "event");
+  assert_true(handle != NULL);
+  assert_num_equal(eventemitter_listeners_count(event_emitter, 1), TEST_LISTENERS);
+  assert_num_equal(eventemitter_wait_async_emit(handle), TEST_LISTENERS + 1);
+  assert_num_equal(atomic_load(&_test_global_counter), TEST_LISTENERS + 1);
+
+  // many events in flight
+  struct EventEmitterAsyncEmit *handles[TEST_EMITS];
+  for (int index = 0; index < TEST_EMITS; index++)
+  {
+    handles[index] = eventemitter_emit_async(event_emitter, 1 + index % 2, "event");
+    assert_true(handles[index] != NULL);
+  }
+  for (int index = 0; index < TEST_EMITS; index++)
+  {
+    assert_num_equal(eventemitter_wait_async_emit(handles[index]), index % 2 ? 1 : TEST_LISTENERS);
+  }
+  assert_num_equal(atomic_load(&_test_global_counter), TEST_LISTENERS + 1 + TEST_LISTENERS * TEST_EMITS / 2);
+  assert_num_equal(atomic_load(&_test_global_unhandled), TEST_EMITS / 2);
+
+  expected = TEST_LISTENERS;
+  for (int index = 0; index < TEST_EMITS; index++)
+  {
+    assert_true(eventemitter_emit_async_with_callback(event_emitter, 1, "event", _test_done_cb, &expected));
+  }
+  while (atomic_load(&_test_global_completed) < TEST_EMITS + 1)
+  {
+    sched_yield();
+  }
+
+  // range and mask listeners handle the event, and follow the listeners of the exact event ID
+  assert_true(eventemitter_on_range(event_emitter, 10, 20, _test_pattern_cb, "pattern") > 0);
+  assert_true(eventemitter_on_mask(event_emitter, 0xf, 0xf, _test_pattern_cb, "pattern") > 0);
+  assert_true(eventemitter_on_range(event_emitter, 1, 1, _test_pattern_cb, "pattern") > 0);
+  atomic_store(&_test_global_unhandled, 0);
+  assert_num_equal(eventemitter_emit(event_emitter, 15, "event"), 2);
+  assert_num_equal(eventemitter_wait_async_emit(eventemitter_emit_async(event_emitter, 15, "event")), 2);
+  assert_num_equal(atomic_load(&_test_global_patterns), 4);
+  atomic_store(&_test_global_counter, 0);
+  assert_num_equal(eventemitter_wait_async_emit(eventemitter_emit_async(event_emitter, 1, "event")), TEST_LISTENERS + 1);
+  assert_num_equal(atomic_load(&_test_global_counter), TEST_LISTENERS);
+  assert_num_equal(atomic_load(&_test_global_patterns), 5);
+  assert_num_equal(eventemitter_wait_async_emit(eventemitter_emit_async(event_emitter, 2, "event")), 1);
+  assert_num_equal(atomic_load(&_test_global_unhandled), 1);
+
+  eventemitter_release(event_emitter);
+} /* test_impl */
+
+#else
+
+
+void test_impl()
+{
+}
+
+#endif
+
+
+int main()
+{
+  test_run(test_impl);
+}
+
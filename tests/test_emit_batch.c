@@ -0,0 +1,118 @@
+#include "test.h"
+#include <string.h>
+
+struct EventEmitter *_test_global_emitter = NULL;
+char                _test_global_order[64];
+
+
+void _test_cb(void *event_data, void *context)
+{
+  strcat(_test_global_order, (char *)context);
+  strcat(_test_global_order, event_data != NULL ? (char *)event_data : "-");
+}
+
+
+void _test_cb_remove_all(void *event_data, void *context)
+{
+  _test_cb(event_data, context);
+
+  // the listeners struct is pinned by the batch so it is not freed while still referenced
+  assert_true(eventemitter_remove_all_event_listeners(_test_global_emitter, 2));
+  assert_num_equal(eventemitter_listeners_count(_test_global_emitter, 2), 0);
+}
+
+
+void _test_cb_add(void *event_data, void *context)
+{
+  _test_cb(event_data, context);
+
+  // not invoked by the current batch
+  assert_true(eventemitter_on(_test_global_emitter, 3, _test_cb, "N") > 0);
+}
+
+
+void _test_cb_replace(void *event_data, void *context)
+{
+  _test_cb(event_data, context);
+
+  // the next events of the batch are delivered to the new listener and not reported as unhandled
+  assert_true(eventemitter_remove_all_event_listeners(_test_global_emitter, 6));
+  assert_true(eventemitter_on(_test_global_emitter, 6, _test_cb, "C") > 0);
+}
+
+
+void _test_cb_nested(void *event_data, void *context)
+{
+  _test_cb(event_data, context);
+
+  // the listeners of event 1 are already pinned by the outer batch
+  int event_ids[] = { 1 };
+  assert_num_equal(eventemitter_emit_batch(_test_global_emitter, event_ids, NULL, 1), 1);
+}
+
+
+void _test_unhandled_cb(int event_id, void *event_data, void *context)
+{
+  assert_true(event_id == 4 || event_id == 2);
+  _test_cb(event_data, context);
+}
+
+
+void test_impl()
+{
+  _test_global_emitter = eventemitter_new();
+
+  int  event_ids[]  = { 1, 2, 1, 4, 3, 1, 2, 3 };
+  void *event_data[] = { "a", "b", "c", "d", "e", "f", "g", "h" };
+
+  assert_num_equal(eventemitter_emit_batch(NULL, event_ids, event_data, 8), -1);
+  assert_num_equal(eventemitter_emit_batch(_test_global_emitter, NULL, event_data, 8), -1);
+  assert_num_equal(eventemitter_emit_batch(_test_global_emitter, NULL, NULL, 0), 0);
+  assert_num_equal(eventemitter_emit_batch(_test_global_emitter, event_ids, event_data, 8), 0);
+
+  assert_true(eventemitter_on(_test_global_emitter, 1, _test_cb, "A") > 0);
+  assert_true(eventemitter_once(_test_global_emitter, 1, _test_cb, "O") > 0);
+  assert_true(eventemitter_on(_test_global_emitter, 2, _test_cb_remove_all, "R") > 0);
+  assert_true(eventemitter_on(_test_global_emitter, 3, _test_cb_add, "X") > 0);
+  assert_true(eventemitter_else(_test_global_emitter, _test_unhandled_cb, "U") > 0);
+
+  // events are delivered in order, the 'once' listener only for the first event
+  _test_global_order[0] = 0;
+  assert_num_equal(eventemitter_emit_batch(_test_global_emitter, event_ids, event_data, 8), 9);
+  assert_string_equal(_test_global_order, "AaOaRbAcUdXeAfUgXh");
+  assert_num_equal(eventemitter_listeners_count(_test_global_emitter, 1), 1);
+  assert_num_equal(eventemitter_listeners_count(_test_global_emitter, 2), 0);
+  assert_num_equal(eventemitter_listeners_count(_test_global_emitter, 3), 3);
+
+  // the added listeners are invoked once the batch is done
+  _test_global_order[0] = 0;
+  assert_num_equal(eventemitter_emit_batch(_test_global_emitter, &event_ids[4], &event_data[4], 1), 3);
+  assert_string_equal(_test_global_order, "XeNeNe");
+
+  // nested batches, without event data
+  assert_true(eventemitter_remove_all_listeners(_test_global_emitter));
+  assert_true(eventemitter_on(_test_global_emitter, 1, _test_cb, "A") > 0);
+  assert_true(eventemitter_on(_test_global_emitter, 5, _test_cb_nested, "B") > 0);
+  int nested_ids[] = { 1, 5, 1 };
+  _test_global_order[0] = 0;
+  assert_num_equal(eventemitter_emit_batch(_test_global_emitter, nested_ids, event_data, 3), 3);
+  assert_string_equal(_test_global_order, "AaBbA-Ac");
+
+  // listeners replaced by a callback
+  assert_true(eventemitter_else(_test_global_emitter, _test_unhandled_cb, "U") > 0);
+  assert_true(eventemitter_on(_test_global_emitter, 6, _test_cb_replace, "R") > 0);
+  int replace_ids[] = { 6, 6, 6 };
+  _test_global_order[0] = 0;
+  assert_num_equal(eventemitter_emit_batch(_test_global_emitter, replace_ids, event_data, 3), 3);
+  assert_string_equal(_test_global_order, "RaCbCc");
+  assert_num_equal(eventemitter_listeners_count(_test_global_emitter, 6), 1);
+
+  eventemitter_release(_test_global_emitter);
+} /* test_impl */
+
+
+int main()
+{
+  test_run(test_impl);
+}
+
@@ -0,0 +1,231 @@
+#include "test.h"
+#include <string.h>
+
+#ifdef EVENTEMITTER_THREADS
+#include <pthread.h>
+#include <stdatomic.h>
+#endif
+
+#define TEST_EVENTS              1000
+#define TEST_THREADS             4
+#define TEST_EMITS_PER_THREAD    20000
+
+struct EventEmitter *_test_global_emitter = NULL;
+char                _test_global_order[128];
+int                 _test_global_event_counters[TEST_EVENTS];
+int                 _test_global_unhandled_counter = 0;
+
+
+void _test_cb(void *event_data, void *context)
+{
+  assert_string_equal((char *)event_data, "event");
+
+  strcat(_test_global_order, (char *)context);
+}
+
+
+void _test_modify_cb(void *event_data, void *context)
+{
+  _test_cb(event_data, context);
+
+  // listeners can not change once frozen, but nested emits are fine
+  assert_num_equal(eventemitter_on(_test_global_emitter, 1, _test_cb, "X"), 0);
+  assert_num_equal(eventemitter_remove_listener_by_id(_test_global_emitter, 1), -1);
+  assert_num_equal(eventemitter_emit(_test_global_emitter, 2, "event"), 1);
+}
+
+
+void _test_freeze_cb(void *event_data, void *context)
+{
+  _test_cb(event_data, context);
+
+  assert_true(!eventemitter_freeze(_test_global_emitter));
+}
+
+
+void _test_event_cb(void *event_data, void *context)
+{
+  (void)event_data;
+
+  _test_global_event_counters[*(int *)context]++;
+}
+
+
+void _test_unhandled_cb(int event_id, void *event_data, void *context)
+{
+  (void)event_data;
+  (void)context;
+
+  assert_true(event_id < 0 || event_id >= TEST_EVENTS * 7);
+  _test_global_unhandled_counter++;
+}
+
+#ifdef EVENTEMITTER_THREADS
+
+atomic_int _test_global_counter = 0;
+
+
+void _test_thread_cb(void *event_data, void *context)
+{
+  (void)event_data;
+  (void)context;
+
+  atomic_fetch_add(&_test_global_counter, 1);
+}
+
+
+void *_test_emit_thread(void *context)
+{
+  struct EventEmitter *event_emitter = (struct EventEmitter *)context;
+
+  for (int index = 0; index < TEST_EMITS_PER_THREAD; index++)
+  {
+    eventemitter_emit(event_emitter, index % 3, NULL);
+  }
+
+  return(NULL);
+}
+
+
+void _test_threads(void)
+{
+  struct EventEmitter *event_emitter = eventemitter_new();
+
+  assert_true(eventemitter_on(event_emitter, 0, _test_thread_cb, NULL) > 0);
+  assert_true(eventemitter_on(event_emitter, 0, _test_thread_cb, NULL) > 0);
+  assert_true(eventemitter_on(event_emitter, 1, _test_thread_cb, NULL) > 0);
+  assert_true(eventemitter_freeze(event_emitter));
+
+  pthread_t threads[TEST_THREADS];
+  for (size_t index = 0; index < TEST_THREADS; index++)
+  {
+    assert_num_equal(pthread_create(&threads[index], NULL, _test_emit_thread, event_emitter), 0);
+  }
+  for (size_t index = 0; index < TEST_THREADS; index++)
+  {
+    assert_num_equal(pthread_join(threads[index], NULL), 0);
+  }
+
+  // events 0, 1 and 2 are emitted in turns, event 2 has no listeners
+  int per_thread = (TEST_EMITS_PER_THREAD / 3) * 3 + (TEST_EMITS_PER_THREAD % 3 >= 1 ? 2 : 0) + (TEST_EMITS_PER_THREAD % 3 >= 2 ? 1 : 0);
+  assert_num_equal(atomic_load(&_test_global_counter), per_thread * TEST_THREADS);
+
+  eventemitter_release(event_emitter);
+}
+
+#endif
+
+
+void test_impl()
+{
+  assert_true(!eventemitter_freeze(NULL));
+  assert_true(!eventemitter_is_frozen(NULL));
+
+  _test_global_emitter = eventemitter_new();
+
+  assert_num_equal(eventemitter_on(_test_global_emitter, 1, _test_modify_cb, "A"), 1);
+  assert_num_equal(eventemitter_on(_test_global_emitter, 1, _test_cb, "B"), 2);
+  assert_num_equal(eventemitter_add_listener_with_priority(_test_global_emitter, 1, 5, _test_cb, "C"), 3);
+  assert_num_equal(eventemitter_on(_test_global_emitter, 2, _test_cb, "D"), 4);
+  assert_num_equal(eventemitter_on(_test_global_emitter, 3, _test_cb, "E"), 5);
+  assert_num_equal(eventemitter_remove_listener_by_id(_test_global_emitter, 5), 1);
+
+  // not supported listeners and freezing during emit
+  assert_num_equal(eventemitter_once(_test_global_emitter, 2, _test_cb, "O"), 6);
+  assert_true(!eventemitter_freeze(_test_global_emitter));
+  assert_num_equal(eventemitter_remove_listener_by_id(_test_global_emitter, 6), 1);
+  assert_num_equal(eventemitter_on_range(_test_global_emitter, 10, 20, NULL, "R"), 0);
+  assert_num_equal(eventemitter_on(_test_global_emitter, 4, _test_freeze_cb, "F"), 7);
+  _test_global_order[0] = 0;
+  assert_num_equal(eventemitter_emit(_test_global_emitter, 4, "event"), 1);
+  assert_string_equal(_test_global_order, "F");
+  assert_num_equal(eventemitter_remove_listener_by_id(_test_global_emitter, 7), 1);
+  assert_true(!eventemitter_is_frozen(_test_global_emitter));
+
+  assert_true(eventemitter_freeze(_test_global_emitter));
+  assert_true(eventemitter_freeze(_test_global_emitter));
+  assert_true(eventemitter_is_frozen(_test_global_emitter));
+
+  _test_global_order[0] = 0;
+  assert_num_equal(eventemitter_emit(_test_global_emitter, 1, "event"), 3);
+  assert_string_equal(_test_global_order, "CADB");
+  _test_global_order[0] = 0;
+  assert_num_equal(eventemitter_emit(_test_global_emitter, 3, "event"), 0);
+  assert_num_equal(eventemitter_emit(_test_global_emitter, 4, "event"), 0);
+  assert_num_equal(eventemitter_emit_batch(_test_global_emitter, (int[]){ 2, 5, 2 }, (void *[]){ "event", "event", "event" }, 3), 2);
+  assert_string_equal(_test_global_order, "DD");
+  assert_num_equal(eventemitter_listeners_count(_test_global_emitter, 1), 3);
+
+  // all changes fail
+  assert_num_equal(eventemitter_on(_test_global_emitter, 1, _test_cb, "X"), 0);
+  assert_num_equal(eventemitter_prepend_listener(_test_global_emitter, 1, _test_cb, "X"), 0);
+  assert_num_equal(eventemitter_else(_test_global_emitter, _test_unhandled_cb, NULL), 0);
+  assert_num_equal(eventemitter_on_mask(_test_global_emitter, 1, 1, _test_unhandled_cb, NULL), 0);
+  assert_num_equal(eventemitter_remove_listener(_test_global_emitter, 1, 2), -1);
+  assert_num_equal(eventemitter_remove_unhandled_listener(_test_global_emitter, 2), -1);
+  assert_num_equal(eventemitter_remove_listeners(_test_global_emitter, (unsigned int[]){ 2 }, 1), -1);
+  assert_true(!eventemitter_remove_all_event_listeners(_test_global_emitter, 1));
+  assert_true(!eventemitter_remove_all_unhandled_listeners(_test_global_emitter));
+  assert_true(!eventemitter_remove_all_listeners(_test_global_emitter));
+  assert_num_equal(eventemitter_listeners_count(_test_global_emitter, 1), 3);
+
+  eventemitter_release(_test_global_emitter);
+
+  // many sparse event IDs, each with its own amount of listeners
+  struct EventEmitter *event_emitter = eventemitter_new();
+  int                 contexts[TEST_EVENTS];
+  for (int index = 0; index < TEST_EVENTS; index++)
+  {
+    contexts[index] = index;
+    for (int listener = 0; listener <= index % 3; listener++)
+    {
+      assert_true(eventemitter_on(event_emitter, index * 7, _test_event_cb, &contexts[index]) > 0);
+    }
+  }
+  assert_true(eventemitter_else(event_emitter, _test_unhandled_cb, NULL) > 0);
+  assert_true(eventemitter_freeze(event_emitter));
+
+  memset(_test_global_event_counters, 0, sizeof(_test_global_event_counters));
+  for (int index = 0; index < TEST_EVENTS; index++)
+  {
+    assert_num_equal(eventemitter_emit(event_emitter, index * 7, "event"), index % 3 + 1);
+    assert_num_equal(_test_global_event_counters[index], index % 3 + 1);
+  }
+  for (int index = 1; index < TEST_EVENTS * 7; index++)
+  {
+    if (index % 7)
+    {
+      assert_num_equal(eventemitter_emit(event_emitter, -index, "event"), 1);
+      assert_num_equal(eventemitter_emit(event_emitter, TEST_EVENTS * 7 + index, "event"), 1);
+    }
+  }
+  assert_num_equal(_test_global_unhandled_counter, 2 * (TEST_EVENTS * 7 - 1 - (TEST_EVENTS - 1)));
+
+  eventemitter_release(event_emitter);
+
+  // emitters without listeners and with an ID range
+  event_emitter = eventemitter_new_with_id_range(0, 16);
+  assert_true(eventemitter_freeze(event_emitter));
+  assert_num_equal(eventemitter_emit(event_emitter, 3, "event"), 0);
+  eventemitter_release(event_emitter);
+  event_emitter = eventemitter_new_with_id_range(0, 16);
+  assert_true(eventemitter_on(event_emitter, 3, _test_cb, "G") > 0);
+  assert_true(eventemitter_on(event_emitter, 300, _test_cb, "H") > 0);
+  assert_true(eventemitter_freeze(event_emitter));
+  _test_global_order[0] = 0;
+  assert_num_equal(eventemitter_emit(event_emitter, 3, "event"), 1);
+  assert_num_equal(eventemitter_emit(event_emitter, 300, "event"), 1);
+  assert_string_equal(_test_global_order, "GH");
+  eventemitter_release(event_emitter);
+
+#ifdef EVENTEMITTER_THREADS
+  _test_threads();
+#endif
+} /* test_impl */
+
+
+int main()
+{
+  test_run(test_impl);
+}
+
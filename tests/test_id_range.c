@@ -0,0 +1,82 @@
+#include "test.h"
+#include <limits.h>
+
+int _test_global_counter           = 0;
+int _test_global_unhandled_counter = 0;
+
+
+void _test_cb(void *event_data, void *context)
+{
+  assert_string_equal((char *)event_data, "event");
+  assert_string_equal((char *)context, "test");
+
+  _test_global_counter++;
+}
+
+
+void _test_unhandled_cb(int event_id, void *event_data, void *context)
+{
+  assert_num_equal(event_id, 50);
+  assert_string_equal((char *)event_data, "event");
+  assert_string_equal((char *)context, "unhandled");
+
+  _test_global_unhandled_counter++;
+}
+
+
+void test_impl()
+{
+  assert_true(eventemitter_new_with_id_range(10, 9) == NULL);
+  assert_true(eventemitter_new_with_id_range(INT_MIN, INT_MAX) == NULL);
+  assert_true(eventemitter_new_with_id_range(0, EVENTEMITTER_MAX_ID_RANGE) == NULL);
+
+  struct EventEmitter *largest = eventemitter_new_with_id_range(-1, EVENTEMITTER_MAX_ID_RANGE - 2);
+  assert_true(largest != NULL);
+  eventemitter_release(largest);
+
+  struct EventEmitter *event_emitter = eventemitter_new_with_id_range(-5, 20);
+
+  assert_true(event_emitter != NULL);
+
+  // lower bound, upper bound and both sides outside the range
+  int event_ids[] = { -5, 20, -6, 21, 0, INT_MIN, INT_MAX };
+  for (size_t index = 0; index < sizeof(event_ids) / sizeof(int); index++)
+  {
+    unsigned int id = eventemitter_on(event_emitter, event_ids[index], _test_cb, "test");
+    assert_num_equal(id, index + 1);
+    assert_num_equal(eventemitter_listeners_count(event_emitter, event_ids[index]), 1);
+  }
+
+  for (size_t index = 0; index < sizeof(event_ids) / sizeof(int); index++)
+  {
+    assert_num_equal(eventemitter_emit(event_emitter, event_ids[index], "event"), 1);
+  }
+  assert_num_equal(_test_global_counter, 7);
+
+  eventemitter_else(event_emitter, _test_unhandled_cb, "unhandled");
+  assert_num_equal(eventemitter_emit(event_emitter, 50, "event"), 1);
+  assert_num_equal(_test_global_unhandled_counter, 1);
+
+  assert_num_equal(eventemitter_remove_listener(event_emitter, -5, 1), 1);
+  assert_num_equal(eventemitter_listeners_count(event_emitter, -5), 0);
+  assert_num_equal(eventemitter_remove_listener(event_emitter, 21, 4), 1);
+  assert_num_equal(eventemitter_listeners_count(event_emitter, 21), 0);
+  assert_num_equal(eventemitter_listeners_count(event_emitter, 20), 1);
+  assert_num_equal(eventemitter_listeners_count(event_emitter, -6), 1);
+
+  eventemitter_release(event_emitter);
+
+  event_emitter = eventemitter_new_with_id_range(INT_MIN, INT_MIN);
+  eventemitter_on(event_emitter, INT_MIN, _test_cb, "test");
+  eventemitter_on(event_emitter, INT_MAX, _test_cb, "test");
+  assert_num_equal(eventemitter_emit(event_emitter, INT_MIN, "event"), 1);
+  assert_num_equal(eventemitter_emit(event_emitter, INT_MAX, "event"), 1);
+  eventemitter_release(event_emitter);
+} /* test_impl */
+
+
+int main()
+{
+  test_run(test_impl);
+}
+
@@ -0,0 +1,117 @@
+#include "test.h"
+
+struct EventEmitter *_test_global_emitter = NULL;
+uint64_t            _test_global_handle   = 0;
+int                 _test_global_counter  = 0;
+
+
+void _test_cb(void *event_data, void *context)
+{
+  assert_string_equal((char *)event_data, "event");
+  assert_true(context == NULL);
+
+  _test_global_counter++;
+}
+
+
+void _test_remove_cb(void *event_data, void *context)
+{
+  _test_cb(event_data, context);
+
+  // rejected as soon as removed, even while the event is dispatched
+  assert_num_equal(eventemitter_remove_listener_by_handle(_test_global_emitter, _test_global_handle), 1);
+  assert_num_equal(eventemitter_remove_listener_by_handle(_test_global_emitter, _test_global_handle), 0);
+  assert_num_equal(eventemitter_get_listener_id(_test_global_emitter, _test_global_handle), 0);
+}
+
+
+void _test_unhandled_cb(int event_id, void *event_data, void *context)
+{
+  (void)event_id;
+  (void)event_data;
+  (void)context;
+}
+
+
+void test_impl()
+{
+  _test_global_emitter = eventemitter_new();
+
+  assert_num_equal(eventemitter_on_with_handle(NULL, 1, _test_cb, NULL), 0);
+  assert_num_equal(eventemitter_on_with_handle(_test_global_emitter, 1, NULL, NULL), 0);
+  assert_num_equal(eventemitter_once_with_handle(_test_global_emitter, 1, NULL, NULL), 0);
+  assert_num_equal(eventemitter_remove_listener_by_handle(NULL, 1), -1);
+  assert_num_equal(eventemitter_remove_listener_by_handle(_test_global_emitter, 0), -1);
+  assert_num_equal(eventemitter_remove_listener_by_handle(_test_global_emitter, 12345), 0);
+  assert_num_equal(eventemitter_get_listener_handle(NULL, 1), 0);
+  assert_num_equal(eventemitter_get_listener_handle(_test_global_emitter, 0), 0);
+  assert_num_equal(eventemitter_get_listener_handle(_test_global_emitter, 1), 0);
+  assert_num_equal(eventemitter_get_listener_id(NULL, 1), 0);
+  assert_num_equal(eventemitter_get_listener_id(_test_global_emitter, 0), 0);
+
+  // handles and callback IDs of the same listeners
+  uint64_t     handle      = eventemitter_on_with_handle(_test_global_emitter, 1, _test_cb, NULL);
+  unsigned int callback_id = eventemitter_on(_test_global_emitter, 1, _test_cb, NULL);
+  assert_true(handle != 0);
+  assert_num_equal(eventemitter_get_listener_id(_test_global_emitter, handle), 1);
+  assert_true(eventemitter_get_listener_handle(_test_global_emitter, 1) == handle);
+  uint64_t other_handle = eventemitter_get_listener_handle(_test_global_emitter, callback_id);
+  assert_true(other_handle != 0 && other_handle != handle);
+  assert_num_equal(eventemitter_get_listener_id(_test_global_emitter, other_handle), callback_id);
+  assert_num_equal(eventemitter_emit(_test_global_emitter, 1, "event"), 2);
+
+  // the freed slot is reused with a new generation, so the old handle does not match the new listener
+  assert_num_equal(eventemitter_remove_listener_by_handle(_test_global_emitter, handle), 1);
+  uint64_t reused_handle = eventemitter_on_with_handle(_test_global_emitter, 2, _test_cb, NULL);
+  assert_true(reused_handle != handle);
+  assert_true((reused_handle & UINT32_MAX) == (handle & UINT32_MAX));
+  assert_num_equal(eventemitter_remove_listener_by_handle(_test_global_emitter, handle), 0);
+  assert_num_equal(eventemitter_get_listener_id(_test_global_emitter, handle), 0);
+  assert_num_equal(eventemitter_listeners_count(_test_global_emitter, 2), 1);
+  assert_num_equal(eventemitter_remove_listener_by_id(_test_global_emitter, callback_id), 1);
+  assert_num_equal(eventemitter_remove_listener_by_handle(_test_global_emitter, other_handle), 0);
+
+  // once listeners, unhandled listeners and removal during emit
+  uint64_t once_handle = eventemitter_once_with_handle(_test_global_emitter, 3, _test_cb, NULL);
+  _test_global_counter = 0;
+  assert_num_equal(eventemitter_emit(_test_global_emitter, 3, "event"), 1);
+  assert_num_equal(eventemitter_remove_listener_by_handle(_test_global_emitter, once_handle), 0);
+  uint64_t unhandled_handle = eventemitter_get_listener_handle(_test_global_emitter, eventemitter_else(_test_global_emitter, _test_unhandled_cb, NULL));
+  assert_num_equal(eventemitter_remove_listener_by_handle(_test_global_emitter, unhandled_handle), 1);
+  assert_true(eventemitter_on_with_handle(_test_global_emitter, 4, _test_remove_cb, NULL) != 0);
+  _test_global_handle = eventemitter_on_with_handle(_test_global_emitter, 4, _test_cb, NULL);
+  assert_num_equal(eventemitter_emit(_test_global_emitter, 4, "event"), 1);
+  assert_num_equal(_test_global_counter, 2);
+
+  // many listeners, each handle removes its own listener only
+  uint64_t handles[500];
+  for (size_t index = 0; index < 500; index++)
+  {
+    handles[index] = eventemitter_on_with_handle(_test_global_emitter, (int)index % 7, _test_cb, NULL);
+    assert_true(handles[index] != 0);
+  }
+  for (size_t index = 0; index < 500; index = index + 2)
+  {
+    assert_num_equal(eventemitter_remove_listener_by_handle(_test_global_emitter, handles[index]), 1);
+    assert_true(eventemitter_on_with_handle(_test_global_emitter, 5, _test_cb, NULL) != 0);
+  }
+  for (size_t index = 0; index < 500; index++)
+  {
+    assert_num_equal(eventemitter_remove_listener_by_handle(_test_global_emitter, handles[index]), index % 2);
+  }
+
+  // handles can not remove listeners once frozen
+  uint64_t frozen_handle = eventemitter_on_with_handle(_test_global_emitter, 6, _test_cb, NULL);
+  assert_true(eventemitter_freeze(_test_global_emitter));
+  assert_num_equal(eventemitter_on_with_handle(_test_global_emitter, 6, _test_cb, NULL), 0);
+  assert_num_equal(eventemitter_remove_listener_by_handle(_test_global_emitter, frozen_handle), -1);
+  assert_true(eventemitter_get_listener_id(_test_global_emitter, frozen_handle) != 0);
+
+  eventemitter_release(_test_global_emitter);
+} /* test_impl */
+
+
+int main()
+{
+  test_run(test_impl);
+}
@@ -0,0 +1,59 @@
+#include "test.h"
+
+#define TEST_EVENT_COUNT    5000
+
+int _test_global_counter = 0;
+
+
+void _test_cb(void *event_data, void *context)
+{
+  assert_num_equal((size_t)event_data, (size_t)context);
+
+  _test_global_counter++;
+}
+
+
+void test_impl()
+{
+  struct EventEmitter *event_emitter = eventemitter_new();
+
+  for (size_t index = 0; index < TEST_EVENT_COUNT; index++)
+  {
+    int          event_id = (int)index * 31 - TEST_EVENT_COUNT;
+    unsigned int id       = eventemitter_on(event_emitter, event_id, _test_cb, (void *)index);
+    assert_num_equal(id, index + 1);
+  }
+
+  for (size_t index = 0; index < TEST_EVENT_COUNT; index++)
+  {
+    int event_id = (int)index * 31 - TEST_EVENT_COUNT;
+    assert_num_equal(eventemitter_listeners_count(event_emitter, event_id), 1);
+    assert_num_equal(eventemitter_emit(event_emitter, event_id, (void *)index), 1);
+  }
+  assert_num_equal(_test_global_counter, TEST_EVENT_COUNT);
+
+  // remove every other event and ensure the rest are still found
+  for (size_t index = 0; index < TEST_EVENT_COUNT; index = index + 2)
+  {
+    int event_id = (int)index * 31 - TEST_EVENT_COUNT;
+    assert_num_equal(eventemitter_remove_listener(event_emitter, event_id, (unsigned int)index + 1), 1);
+    assert_num_equal(eventemitter_listeners_count(event_emitter, event_id), 0);
+  }
+
+  for (size_t index = 0; index < TEST_EVENT_COUNT; index++)
+  {
+    int event_id = (int)index * 31 - TEST_EVENT_COUNT;
+    assert_num_equal(eventemitter_listeners_count(event_emitter, event_id), index % 2);
+    assert_num_equal(eventemitter_emit(event_emitter, event_id, (void *)index), index % 2);
+  }
+  assert_num_equal(_test_global_counter, TEST_EVENT_COUNT + TEST_EVENT_COUNT / 2);
+
+  eventemitter_release(event_emitter);
+}
+
+
+int main()
+{
+  test_run(test_impl);
+}
+
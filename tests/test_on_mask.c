@@ -0,0 +1,98 @@
+#include "test.h"
+#include <string.h>
+
+struct EventEmitter *_test_global_emitter = NULL;
+char                _test_global_order[128];
+
+
+void _test_cb(void *event_data, void *context)
+{
+  assert_string_equal((char *)event_data, "event");
+
+  strcat(_test_global_order, (char *)context);
+}
+
+
+void _test_mask_cb(int event_id, void *event_data, void *context)
+{
+  (void)event_id;
+  _test_cb(event_data, context);
+}
+
+
+void _test_remove_all_cb(int event_id, void *event_data, void *context)
+{
+  _test_mask_cb(event_id, event_data, context);
+
+  // the masks are still iterated by the emit
+  assert_true(eventemitter_remove_all_listeners(_test_global_emitter));
+}
+
+
+void _test_unhandled_cb(int event_id, void *event_data, void *context)
+{
+  assert_num_equal(event_id, 0x201);
+  _test_cb(event_data, context);
+}
+
+
+void test_impl()
+{
+  _test_global_emitter = eventemitter_new();
+
+  assert_num_equal(eventemitter_on_mask(NULL, 0xF00, 0x100, _test_mask_cb, "A"), 0);
+  assert_num_equal(eventemitter_on_mask(_test_global_emitter, 0xF00, 0x100, NULL, "A"), 0);
+  assert_num_equal(eventemitter_on_mask(_test_global_emitter, 0xF00, 0x101, _test_mask_cb, "A"), 0);
+
+  // exact listeners, then ranges, then masks in the order the masks were first used
+  assert_num_equal(eventemitter_on_mask(_test_global_emitter, 0xF00, 0x100, _test_mask_cb, "A"), 1);
+  assert_num_equal(eventemitter_on_mask(_test_global_emitter, 0x00F, 0x001, _test_mask_cb, "B"), 2);
+  assert_num_equal(eventemitter_on_mask(_test_global_emitter, 0xF00, 0x100, _test_mask_cb, "C"), 3);
+  assert_num_equal(eventemitter_on_mask(_test_global_emitter, 0, 0, _test_mask_cb, "D"), 4);
+  assert_num_equal(eventemitter_on_range(_test_global_emitter, 0x100, 0x1FF, _test_mask_cb, "R"), 5);
+  assert_num_equal(eventemitter_on(_test_global_emitter, 0x101, _test_cb, "E"), 6);
+  assert_num_equal(eventemitter_else(_test_global_emitter, _test_unhandled_cb, "U"), 7);
+
+  _test_global_order[0] = 0;
+  assert_num_equal(eventemitter_emit(_test_global_emitter, 0x101, "event"), 6);
+  assert_string_equal(_test_global_order, "ERACBD");
+  _test_global_order[0] = 0;
+  assert_num_equal(eventemitter_emit(_test_global_emitter, 0x201, "event"), 2);
+  assert_string_equal(_test_global_order, "BD");
+
+  // the last listener of a mask removes the mask, but the other masks keep their order
+  assert_num_equal(eventemitter_remove_listener_by_id(_test_global_emitter, 2), 1);
+  assert_num_equal(eventemitter_remove_listener_by_id(_test_global_emitter, 4), 1);
+  assert_num_equal(eventemitter_remove_listener_by_id(_test_global_emitter, 4), 0);
+  _test_global_order[0] = 0;
+  assert_num_equal(eventemitter_emit(_test_global_emitter, 0x201, "event"), 1);
+  assert_string_equal(_test_global_order, "U");
+  assert_num_equal(eventemitter_on_mask(_test_global_emitter, 0x00F, 0x001, _test_mask_cb, "B"), 8);
+  _test_global_order[0] = 0;
+  assert_num_equal(eventemitter_emit(_test_global_emitter, 0x101, "event"), 5);
+  assert_string_equal(_test_global_order, "ERACB");
+
+  // negative masks and values
+  assert_num_equal(eventemitter_on_mask(_test_global_emitter, -1, -5, _test_mask_cb, "N"), 9);
+  _test_global_order[0] = 0;
+  assert_num_equal(eventemitter_emit(_test_global_emitter, -5, "event"), 1);
+  assert_string_equal(_test_global_order, "N");
+
+  // callbacks may remove all listeners during emit
+  assert_num_equal(eventemitter_on_mask(_test_global_emitter, 0x00F, 0x001, _test_remove_all_cb, "X"), 10);
+  _test_global_order[0] = 0;
+  assert_num_equal(eventemitter_emit(_test_global_emitter, 0x101, "event"), 6);
+  assert_string_equal(_test_global_order, "ERACBX");
+  _test_global_order[0] = 0;
+  assert_num_equal(eventemitter_emit(_test_global_emitter, 0x101, "event"), 0);
+  assert_string_equal(_test_global_order, "");
+
+  eventemitter_release(_test_global_emitter);
+} /* test_impl */
+
+
+int main()
+{
+  test_run(test_impl);
+}
+
@@ -0,0 +1,132 @@
+#include "test.h"
+#include <stdio.h>
+#include <string.h>
+
+#define TEST_RANGES    100
+
+struct EventEmitter *_test_global_emitter = NULL;
+char                _test_global_order[256];
+int                 _test_global_counter = 0;
+unsigned int        _test_global_remove_id = 0;
+
+
+void _test_cb(void *event_data, void *context)
+{
+  assert_string_equal((char *)event_data, "event");
+
+  strcat(_test_global_order, (char *)context);
+}
+
+
+void _test_range_cb(int event_id, void *event_data, void *context)
+{
+  assert_true(event_id >= 1000 && event_id <= 1999);
+  _test_cb(event_data, context);
+}
+
+
+void _test_any_cb(int event_id, void *event_data, void *context)
+{
+  (void)event_id;
+  _test_cb(event_data, context);
+}
+
+
+void _test_remove_cb(int event_id, void *event_data, void *context)
+{
+  _test_any_cb(event_id, event_data, context);
+
+  // removes a range listener which was not invoked yet by this emit
+  assert_num_equal(eventemitter_remove_listener_by_id(_test_global_emitter, _test_global_remove_id), 1);
+}
+
+
+void _test_unhandled_cb(int event_id, void *event_data, void *context)
+{
+  assert_num_equal(event_id, 5000);
+  _test_cb(event_data, context);
+}
+
+
+void _test_count_cb(int event_id, void *event_data, void *context)
+{
+  (void)event_data;
+
+  // all ranges containing the event ID are invoked, in range order
+  int min_event_id = *(int *)context;
+  assert_true(event_id >= min_event_id && event_id <= min_event_id + 100);
+  _test_global_counter++;
+}
+
+
+void test_impl()
+{
+  _test_global_emitter = eventemitter_new();
+
+  assert_num_equal(eventemitter_on_range(NULL, 1000, 1999, _test_range_cb, "R"), 0);
+  assert_num_equal(eventemitter_on_range(_test_global_emitter, 1000, 1999, NULL, "R"), 0);
+  assert_num_equal(eventemitter_on_range(_test_global_emitter, 1999, 1000, _test_range_cb, "R"), 0);
+
+  // exact listeners first, then ranges ordered by range and by registration within a range
+  assert_true(eventemitter_on_range(_test_global_emitter, 1500, 1999, _test_range_cb, "C") > 0);
+  assert_true(eventemitter_on_range(_test_global_emitter, 1000, 1999, _test_range_cb, "A") > 0);
+  assert_true(eventemitter_on_range(_test_global_emitter, 1000, 1200, _test_range_cb, "B") > 0);
+  assert_true(eventemitter_on_range(_test_global_emitter, 1000, 1999, _test_range_cb, "D") > 0);
+  assert_true(eventemitter_on(_test_global_emitter, 1500, _test_cb, "E") > 0);
+  assert_true(eventemitter_else(_test_global_emitter, _test_unhandled_cb, "U") > 0);
+
+  _test_global_order[0] = 0;
+  assert_num_equal(eventemitter_emit(_test_global_emitter, 1500, "event"), 4);
+  assert_string_equal(_test_global_order, "EADC");
+  _test_global_order[0] = 0;
+  assert_num_equal(eventemitter_emit(_test_global_emitter, 1000, "event"), 3);
+  assert_string_equal(_test_global_order, "BAD");
+  _test_global_order[0] = 0;
+  assert_num_equal(eventemitter_emit(_test_global_emitter, 5000, "event"), 1);
+  assert_string_equal(_test_global_order, "U");
+  assert_num_equal(eventemitter_listeners_count(_test_global_emitter, 1000), 0);
+
+  // callbacks may remove ranges during emit
+  _test_global_remove_id = eventemitter_on_range(_test_global_emitter, 1400, 1600, _test_any_cb, "G");
+  assert_true(eventemitter_on_range(_test_global_emitter, 1300, 1500, _test_remove_cb, "F") > 0);
+  _test_global_order[0] = 0;
+  assert_num_equal(eventemitter_emit(_test_global_emitter, 1500, "event"), 5);
+  assert_string_equal(_test_global_order, "EADFC");
+  _test_global_order[0] = 0;
+  assert_num_equal(eventemitter_emit_batch(_test_global_emitter, (int[]){ 1100, 5000 }, (void *[]){ "event", "event" }, 2), 4);
+  assert_string_equal(_test_global_order, "BADU");
+
+  // not removed via the exact event ID
+  assert_num_equal(eventemitter_remove_listener(_test_global_emitter, 1000, 2), 0);
+  assert_num_equal(eventemitter_remove_listener_by_id(_test_global_emitter, 2), 1);
+  assert_num_equal(eventemitter_remove_listener_by_id(_test_global_emitter, 3), 1);
+  _test_global_order[0] = 0;
+  assert_num_equal(eventemitter_emit(_test_global_emitter, 1000, "event"), 1);
+  assert_string_equal(_test_global_order, "D");
+
+  assert_true(eventemitter_remove_all_listeners(_test_global_emitter));
+  _test_global_order[0] = 0;
+  assert_num_equal(eventemitter_emit(_test_global_emitter, 1500, "event"), 0);
+  assert_string_equal(_test_global_order, "");
+
+  // many overlapping ranges, fetched in more than a single window
+  int mins[TEST_RANGES];
+  for (int index = 0; index < TEST_RANGES; index++)
+  {
+    mins[index] = index * 10;
+    assert_true(eventemitter_on_range(_test_global_emitter, mins[index], mins[index] + 100, _test_count_cb, &mins[index]) > 0);
+  }
+  assert_num_equal(eventemitter_emit(_test_global_emitter, 500, "event"), 11);
+  assert_num_equal(_test_global_counter, 11);
+  assert_num_equal(eventemitter_emit(_test_global_emitter, -1, "event"), 0);
+  assert_num_equal(eventemitter_emit(_test_global_emitter, 2000, "event"), 0);
+
+  eventemitter_release(_test_global_emitter);
+} /* test_impl */
+
+
+int main()
+{
+  test_run(test_impl);
+}
+
@@ -0,0 +1,166 @@
+#include "test.h"
+#include <string.h>
+
+#ifdef EVENTEMITTER_THREADS
+#include <sched.h>
+#include <stdatomic.h>
+#endif
+
+struct EventEmitter *_test_global_emitter  = NULL;
+void                *_test_global_retained = NULL;
+int                 _test_global_counter   = 0;
+#ifdef EVENTEMITTER_THREADS
+atomic_int _test_global_released = 0;
+#else
+int _test_global_released = 0;
+#endif
+
+
+void _test_release(void *payload)
+{
+  assert_string_equal((char *)payload, "payload");
+
+  _test_global_released++;
+}
+
+
+void _test_cb(void *event_data, void *context)
+{
+  assert_string_equal((char *)event_data, "payload");
+  assert_true(context == NULL);
+
+  _test_global_counter++;
+}
+
+
+void _test_retain_cb(void *event_data, void *context)
+{
+  _test_cb(event_data, context);
+
+  // kept after the emit returns
+  _test_global_retained = eventemitter_payload_retain(event_data);
+}
+
+
+void *_test_new_payload(size_t size)
+{
+  char *payload = eventemitter_payload_new(_test_global_emitter, size, _test_release);
+
+  assert_true(payload != NULL);
+  strcpy(payload, "payload");
+
+  return(payload);
+}
+
+#ifdef EVENTEMITTER_THREADS
+
+
+void _test_async_cb(void *event_data, void *context)
+{
+  assert_string_equal((char *)event_data, "payload");
+  assert_true(context == NULL);
+}
+
+
+void _test_check_threads()
+{
+  // every queued delivery holds a reference, the last dispatched one frees the payload
+  assert_true(!eventemitter_enqueue_owned(_test_global_emitter, 1, NULL));
+  assert_true(eventemitter_init_queue(_test_global_emitter, 8));
+  void *payload = _test_new_payload(16);
+  eventemitter_payload_retain(payload);
+  eventemitter_payload_retain(payload);
+  for (size_t index = 0; index < 3; index++)
+  {
+    assert_true(eventemitter_enqueue_owned(_test_global_emitter, 1, payload));
+  }
+  _test_global_released = 0;
+  _test_global_counter  = 0;
+  assert_num_equal(eventemitter_dispatch(_test_global_emitter, 2), 2);
+  assert_num_equal(_test_global_released, 0);
+  assert_num_equal(eventemitter_dispatch(_test_global_emitter, 0), 1);
+  assert_num_equal(_test_global_counter, 6);
+  assert_num_equal(_test_global_released, 1);
+
+  // the payload is released after the last async listener is done
+  assert_true(!eventemitter_emit_async_owned(_test_global_emitter, 2, NULL));
+  payload = _test_new_payload(500);
+  assert_true(!eventemitter_emit_async_owned(_test_global_emitter, 2, payload));
+  assert_true(eventemitter_start_workers(_test_global_emitter, 2));
+  for (size_t index = 0; index < 4; index++)
+  {
+    assert_true(eventemitter_on(_test_global_emitter, 2, _test_async_cb, NULL) > 0);
+  }
+  _test_global_released = 0;
+  for (size_t index = 0; index < 100; index++)
+  {
+    assert_true(eventemitter_emit_async_owned(_test_global_emitter, 2, index ? _test_new_payload(16) : payload));
+  }
+  while (atomic_load(&_test_global_released) < 100)
+  {
+    sched_yield();
+  }
+
+  // pending queued payloads are released with the emitter
+  assert_true(eventemitter_enqueue_owned(_test_global_emitter, 1, _test_new_payload(16)));
+  assert_true(eventemitter_enqueue_owned(_test_global_emitter, 1, _test_new_payload(500)));
+  _test_global_released = 0;
+  eventemitter_release(_test_global_emitter);
+  assert_num_equal(_test_global_released, 2);
+} /* _test_check_threads */
+
+#endif
+
+
+void test_impl()
+{
+  assert_true(eventemitter_payload_new(NULL, 8, NULL) == NULL);
+  assert_true(eventemitter_payload_retain(NULL) == NULL);
+  eventemitter_payload_release(NULL);
+
+  _test_global_emitter = eventemitter_new();
+  assert_num_equal(eventemitter_emit_owned(NULL, 1, NULL), -1);
+  assert_num_equal(eventemitter_emit_owned(_test_global_emitter, 1, NULL), -1);
+  assert_true(eventemitter_on(_test_global_emitter, 1, _test_cb, NULL) > 0);
+  assert_true(eventemitter_on(_test_global_emitter, 1, _test_cb, NULL) > 0);
+
+  // payloads from the arena and from the allocator, released once the listeners are done
+  size_t sizes[] = { 8, 96, 97, 4096 };
+  for (size_t index = 0; index < sizeof(sizes) / sizeof(size_t); index++)
+  {
+    void *payload = _test_new_payload(sizes[index]);
+    assert_true(((size_t)payload % sizeof(void *)) == 0);
+    _test_global_released = 0;
+    assert_num_equal(eventemitter_emit_owned(_test_global_emitter, 1, payload), 2);
+    assert_num_equal(_test_global_released, 1);
+  }
+
+  // a listener keeps the payload beyond the emit
+  unsigned int callback_id = eventemitter_on(_test_global_emitter, 1, _test_retain_cb, NULL);
+  _test_global_released = 0;
+  _test_global_counter  = 0;
+  assert_num_equal(eventemitter_emit_owned(_test_global_emitter, 1, _test_new_payload(32)), 3);
+  assert_num_equal(_test_global_counter, 3);
+  assert_num_equal(_test_global_released, 0);
+  assert_string_equal(_test_global_retained, "payload");
+  eventemitter_payload_release(_test_global_retained);
+  assert_num_equal(_test_global_released, 1);
+  assert_num_equal(eventemitter_remove_listener_by_id(_test_global_emitter, callback_id), 1);
+
+  // no release callback and no listeners
+  void *payload = eventemitter_payload_new(_test_global_emitter, 0, NULL);
+  assert_true(payload != NULL);
+  assert_num_equal(eventemitter_emit_owned(_test_global_emitter, 2, payload), 0);
+
+#ifdef EVENTEMITTER_THREADS
+  _test_check_threads();
+#else
+  eventemitter_release(_test_global_emitter);
+#endif
+} /* test_impl */
+
+
+int main()
+{
+  test_run(test_impl);
+}
@@ -0,0 +1,135 @@
+#include "test.h"
+
+#ifdef EVENTEMITTER_THREADS
+
+#include <pthread.h>
+#include <sched.h>
+
+#define TEST_PRODUCERS             4
+#define TEST_EVENTS_PER_PRODUCER   10000
+
+struct EventEmitter *_test_global_emitter  = NULL;
+size_t              _test_global_received[TEST_PRODUCERS];
+size_t              _test_global_counter   = 0;
+int                 _test_global_unhandled = 0;
+
+
+void _test_cb(void *event_data, void *context)
+{
+  assert_true(context == NULL);
+
+  // events of each producer are dispatched in their queue order
+  size_t value    = (size_t)event_data;
+  size_t producer = value / TEST_EVENTS_PER_PRODUCER;
+  assert_true(producer < TEST_PRODUCERS);
+  assert_num_equal(value % TEST_EVENTS_PER_PRODUCER, _test_global_received[producer]);
+  _test_global_received[producer]++;
+  _test_global_counter++;
+}
+
+
+void _test_cb_requeue(void *event_data, void *context)
+{
+  assert_string_equal((char *)event_data, "event");
+  assert_true(context == NULL);
+
+  // cells are released before emitting so callbacks may queue more events
+  assert_true(eventemitter_enqueue(_test_global_emitter, 3, "event"));
+}
+
+
+void _test_unhandled_cb(int event_id, void *event_data, void *context)
+{
+  assert_num_equal(event_id, 3);
+  assert_string_equal((char *)event_data, "event");
+  assert_true(context == NULL);
+
+  _test_global_unhandled++;
+}
+
+
+void *_test_producer(void *context)
+{
+  size_t producer = (size_t)context;
+
+  for (size_t index = 0; index < TEST_EVENTS_PER_PRODUCER; index++)
+  {
+    // wait while the queue is full
+    while (!eventemitter_enqueue(_test_global_emitter, 1, (void *)(producer * TEST_EVENTS_PER_PRODUCER + index)))
+    {
+      sched_yield();
+    }
+  }
+
+  return(NULL);
+}
+
+
+void test_impl()
+{
+  _test_global_emitter = eventemitter_new();
+
+  assert_true(!eventemitter_init_queue(NULL, 4));
+  assert_true(!eventemitter_init_queue(_test_global_emitter, 0));
+  assert_true(!eventemitter_enqueue(_test_global_emitter, 1, NULL));
+  assert_num_equal(eventemitter_dispatch(NULL, 0), -1);
+  assert_num_equal(eventemitter_dispatch(_test_global_emitter, 0), 0);
+
+  assert_true(eventemitter_init_queue(_test_global_emitter, 3));
+  assert_true(!eventemitter_init_queue(_test_global_emitter, 3));
+
+  // capacity is rounded up to a power of 2
+  for (int index = 0; index < 4; index++)
+  {
+    assert_true(eventemitter_enqueue(_test_global_emitter, 2, "event"));
+  }
+  assert_true(!eventemitter_enqueue(_test_global_emitter, 2, "event"));
+  assert_true(eventemitter_on(_test_global_emitter, 2, _test_cb_requeue, NULL) > 0);
+  assert_true(eventemitter_else(_test_global_emitter, _test_unhandled_cb, NULL) > 0);
+  assert_num_equal(eventemitter_dispatch(_test_global_emitter, 1), 1);
+  assert_num_equal(eventemitter_dispatch(_test_global_emitter, 0), 4);
+  assert_num_equal(_test_global_unhandled, 1);
+  assert_num_equal(eventemitter_dispatch(_test_global_emitter, 0), 3);
+  assert_num_equal(_test_global_unhandled, 4);
+  assert_num_equal(eventemitter_dispatch(_test_global_emitter, 0), 0);
+
+  // many producers, single consumer
+  assert_true(eventemitter_on(_test_global_emitter, 1, _test_cb, NULL) > 0);
+  pthread_t threads[TEST_PRODUCERS];
+  for (size_t index = 0; index < TEST_PRODUCERS; index++)
+  {
+    _test_global_received[index] = 0;
+    assert_num_equal(pthread_create(&threads[index], NULL, _test_producer, (void *)index), 0);
+  }
+  while (_test_global_counter < TEST_PRODUCERS * TEST_EVENTS_PER_PRODUCER)
+  {
+    if (!eventemitter_dispatch(_test_global_emitter, 2))
+    {
+      sched_yield();
+    }
+  }
+  for (size_t index = 0; index < TEST_PRODUCERS; index++)
+  {
+    assert_num_equal(pthread_join(threads[index], NULL), 0);
+    assert_num_equal(_test_global_received[index], TEST_EVENTS_PER_PRODUCER);
+  }
+  assert_num_equal(eventemitter_dispatch(_test_global_emitter, 0), 0);
+
+  eventemitter_release(_test_global_emitter);
+} /* test_impl */
+
+#else
+
+
+void test_impl()
+{
+}
+
+#endif
+
+
+int main()
+{
+  test_run(test_impl);
+}
+
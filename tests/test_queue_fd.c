@@ -0,0 +1,135 @@
+#include "test.h"
+
+#if defined(EVENTEMITTER_THREADS) && defined(__linux__)
+
+#include <poll.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <sys/epoll.h>
+#include <unistd.h>
+
+#define TEST_THREADS              4
+#define TEST_EVENTS_PER_THREAD    5000
+
+struct EventEmitter *_test_global_emitter = NULL;
+size_t              _test_global_counter  = 0;
+
+
+void _test_cb(void *event_data, void *context)
+{
+  assert_string_equal((char *)event_data, "event");
+  assert_true(context == NULL);
+
+  _test_global_counter++;
+}
+
+
+bool _test_readable(int fd)
+{
+  struct pollfd poll_fd = { .fd = fd, .events = POLLIN, .revents = 0 };
+
+  return(poll(&poll_fd, 1, 0) == 1 && (poll_fd.revents & POLLIN));
+}
+
+
+void *_test_producer(void *context)
+{
+  (void)context;
+
+  for (size_t index = 0; index < TEST_EVENTS_PER_THREAD; index++)
+  {
+    while (!eventemitter_enqueue(_test_global_emitter, 1, "event"))
+    {
+      usleep(10);
+    }
+  }
+
+  return(NULL);
+}
+
+
+void test_impl()
+{
+  assert_num_equal(eventemitter_get_fd(NULL), -1);
+  assert_num_equal(eventemitter_dispatch_pending(NULL), -1);
+
+  _test_global_emitter = eventemitter_new();
+  assert_num_equal(eventemitter_get_fd(_test_global_emitter), -1);
+  assert_num_equal(eventemitter_dispatch_pending(_test_global_emitter), 0);
+  assert_true(eventemitter_init_queue(_test_global_emitter, 256));
+  assert_true(eventemitter_on(_test_global_emitter, 1, _test_cb, NULL) > 0);
+
+  int fd = eventemitter_get_fd(_test_global_emitter);
+  assert_true(fd >= 0);
+  assert_num_equal(eventemitter_get_fd(_test_global_emitter), fd);
+  assert_true(!_test_readable(fd));
+  assert_num_equal(eventemitter_dispatch_pending(_test_global_emitter), 0);
+
+  // a burst of events writes the eventfd once
+  for (size_t index = 0; index < 100; index++)
+  {
+    assert_true(eventemitter_enqueue(_test_global_emitter, 1, "event"));
+  }
+  assert_true(_test_readable(fd));
+  uint64_t value = 0;
+  assert_num_equal(read(fd, &value, sizeof(uint64_t)), sizeof(uint64_t));
+  assert_num_equal(value, 1);
+  assert_num_equal(eventemitter_dispatch_pending(_test_global_emitter), 100);
+  assert_num_equal(_test_global_counter, 100);
+  assert_true(!_test_readable(fd));
+
+  // readable again for the next burst and reset by the pending dispatch
+  assert_true(eventemitter_enqueue(_test_global_emitter, 1, "event"));
+  assert_true(_test_readable(fd));
+  assert_num_equal(eventemitter_dispatch(_test_global_emitter, 0), 1);
+  assert_true(_test_readable(fd));
+  assert_num_equal(eventemitter_dispatch_pending(_test_global_emitter), 0);
+  assert_true(!_test_readable(fd));
+
+  // an epoll loop woken by producer threads
+  int epoll_fd = epoll_create1(0);
+  assert_true(epoll_fd >= 0);
+  struct epoll_event epoll_event = { .events = EPOLLIN, .data = { .fd = fd } };
+  assert_num_equal(epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &epoll_event), 0);
+
+  pthread_t threads[TEST_THREADS];
+  for (size_t index = 0; index < TEST_THREADS; index++)
+  {
+    assert_num_equal(pthread_create(&threads[index], NULL, _test_producer, NULL), 0);
+  }
+  _test_global_counter = 0;
+  while (_test_global_counter < TEST_THREADS * TEST_EVENTS_PER_THREAD)
+  {
+    struct epoll_event ready;
+    if (epoll_wait(epoll_fd, &ready, 1, 1000) == 1)
+    {
+      assert_num_equal(ready.data.fd, fd);
+      assert_true(eventemitter_dispatch_pending(_test_global_emitter) >= 0);
+    }
+  }
+  for (size_t index = 0; index < TEST_THREADS; index++)
+  {
+    assert_num_equal(pthread_join(threads[index], NULL), 0);
+  }
+  assert_num_equal(_test_global_counter, TEST_THREADS * TEST_EVENTS_PER_THREAD);
+  assert_num_equal(eventemitter_dispatch_pending(_test_global_emitter), 0);
+  assert_true(!_test_readable(fd));
+
+  close(epoll_fd);
+  eventemitter_release(_test_global_emitter);
+} /* test_impl */
+
+#else
+
+
+void test_impl()
+{
+}
+
+#endif
+
+
+int main()
+{
+  test_run(test_impl);
+}
@@ -0,0 +1,144 @@
+#include "test.h"
+#include <string.h>
+
+struct EventEmitter *_test_global_emitter = NULL;
+char                _test_global_order[64];
+unsigned int        _test_global_ids[4];
+int                 _test_global_depth = 0;
+
+
+void _test_record(const char *name)
+{
+  strcat(_test_global_order, name);
+}
+
+
+void _test_cb_plain(void *event_data, void *context)
+{
+  assert_string_equal((char *)event_data, "event");
+
+  _test_record((char *)context);
+}
+
+
+void _test_cb_mutate(void *event_data, void *context)
+{
+  _test_cb_plain(event_data, context);
+
+  // remove the next listener and add new ones while the event is being dispatched
+  assert_num_equal(eventemitter_off(_test_global_emitter, 1, _test_global_ids[1]), 1);
+  assert_num_equal(eventemitter_off(_test_global_emitter, 1, _test_global_ids[1]), 0);
+  assert_true(eventemitter_on(_test_global_emitter, 1, _test_cb_plain, "D") > 0);
+  assert_true(eventemitter_prepend_listener(_test_global_emitter, 1, _test_cb_plain, "E") > 0);
+  assert_true(eventemitter_prepend_listener(_test_global_emitter, 1, _test_cb_plain, "F") > 0);
+  assert_num_equal(eventemitter_listeners_count(_test_global_emitter, 1), 5);
+}
+
+
+void _test_cb_recursive(void *event_data, void *context)
+{
+  _test_cb_plain(event_data, context);
+
+  if (_test_global_depth < 3)
+  {
+    _test_global_depth++;
+    eventemitter_emit(_test_global_emitter, 2, event_data);
+  }
+}
+
+
+void _test_cb_remove_all_event(void *event_data, void *context)
+{
+  _test_cb_plain(event_data, context);
+
+  assert_true(eventemitter_remove_all_event_listeners(_test_global_emitter, 3));
+  assert_num_equal(eventemitter_listeners_count(_test_global_emitter, 3), 0);
+
+  // new listeners are not part of the current dispatch
+  assert_true(eventemitter_on(_test_global_emitter, 3, _test_cb_plain, "N") > 0);
+}
+
+
+void _test_cb_remove_all(void *event_data, void *context)
+{
+  _test_cb_plain(event_data, context);
+
+  assert_true(eventemitter_remove_all_listeners(_test_global_emitter));
+}
+
+
+void _test_cb_unhandled(int event_id, void *event_data, void *context)
+{
+  assert_num_equal(event_id, 9);
+  _test_cb_plain(event_data, context);
+
+  assert_num_equal(eventemitter_remove_unhandled_listener(_test_global_emitter, _test_global_ids[0]), 1);
+  assert_true(eventemitter_else(_test_global_emitter, _test_cb_unhandled, "V") > 0);
+}
+
+
+void test_impl()
+{
+  _test_global_emitter = eventemitter_new();
+
+  // removals are applied immediately but staged additions only after the dispatch is done
+  _test_global_ids[0] = eventemitter_on(_test_global_emitter, 1, _test_cb_mutate, "A");
+  _test_global_ids[1] = eventemitter_on(_test_global_emitter, 1, _test_cb_plain, "B");
+  _test_global_ids[2] = eventemitter_on(_test_global_emitter, 1, _test_cb_plain, "C");
+  strcpy(_test_global_order, "");
+  assert_num_equal(eventemitter_emit(_test_global_emitter, 1, "event"), 2);
+  assert_string_equal(_test_global_order, "AC");
+  assert_num_equal(eventemitter_listeners_count(_test_global_emitter, 1), 5);
+  assert_num_equal(eventemitter_remove_listener(_test_global_emitter, 1, _test_global_ids[0]), 1);
+  strcpy(_test_global_order, "");
+  assert_num_equal(eventemitter_emit(_test_global_emitter, 1, "event"), 4);
+  assert_string_equal(_test_global_order, "FECD");
+
+  // 'once' listeners are invoked once even when the event is emitted recursively
+  assert_true(eventemitter_once(_test_global_emitter, 2, _test_cb_plain, "O") > 0);
+  assert_true(eventemitter_on(_test_global_emitter, 2, _test_cb_recursive, "R") > 0);
+  strcpy(_test_global_order, "");
+  assert_num_equal(eventemitter_emit(_test_global_emitter, 2, "event"), 2);
+  assert_string_equal(_test_global_order, "ORRRR");
+  assert_num_equal(eventemitter_listeners_count(_test_global_emitter, 2), 1);
+
+  // removing all the event listeners during dispatch
+  assert_true(eventemitter_on(_test_global_emitter, 3, _test_cb_remove_all_event, "X") > 0);
+  assert_true(eventemitter_on(_test_global_emitter, 3, _test_cb_plain, "Y") > 0);
+  strcpy(_test_global_order, "");
+  assert_num_equal(eventemitter_emit(_test_global_emitter, 3, "event"), 1);
+  assert_string_equal(_test_global_order, "X");
+  assert_num_equal(eventemitter_listeners_count(_test_global_emitter, 3), 1);
+  strcpy(_test_global_order, "");
+  assert_num_equal(eventemitter_emit(_test_global_emitter, 3, "event"), 1);
+  assert_string_equal(_test_global_order, "N");
+
+  // unhandled listeners follow the same rules
+  _test_global_ids[0] = eventemitter_else(_test_global_emitter, _test_cb_unhandled, "U");
+  strcpy(_test_global_order, "");
+  assert_num_equal(eventemitter_emit(_test_global_emitter, 9, "event"), 1);
+  assert_string_equal(_test_global_order, "U");
+  _test_global_ids[0] = 0;
+  strcpy(_test_global_order, "");
+  assert_true(eventemitter_remove_all_unhandled_listeners(_test_global_emitter));
+  assert_num_equal(eventemitter_emit(_test_global_emitter, 9, "event"), 0);
+
+  // removing everything during dispatch
+  assert_true(eventemitter_on(_test_global_emitter, 4, _test_cb_remove_all, "Z") > 0);
+  assert_true(eventemitter_on(_test_global_emitter, 4, _test_cb_plain, "W") > 0);
+  strcpy(_test_global_order, "");
+  assert_num_equal(eventemitter_emit(_test_global_emitter, 4, "event"), 1);
+  assert_string_equal(_test_global_order, "Z");
+  assert_num_equal(eventemitter_listeners_count(_test_global_emitter, 1), 0);
+  assert_num_equal(eventemitter_listeners_count(_test_global_emitter, 4), 0);
+  assert_num_equal(eventemitter_emit(_test_global_emitter, 4, "event"), 0);
+
+  eventemitter_release(_test_global_emitter);
+} /* test_impl */
+
+
+int main()
+{
+  test_run(test_impl);
+}
+
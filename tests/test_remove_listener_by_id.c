@@ -0,0 +1,109 @@
+#include "test.h"
+
+#define TEST_LISTENER_COUNT    100
+
+int _test_global_sum               = 0;
+int _test_global_last_index        = -1;
+int _test_global_unhandled_counter = 0;
+
+
+void _test_cb(void *event_data, void *context)
+{
+  assert_string_equal((char *)event_data, "event");
+
+  // listeners must keep their registration order
+  int index = (int)(size_t)context;
+  assert_true(index > _test_global_last_index);
+  _test_global_last_index = index;
+
+  _test_global_sum = _test_global_sum + index;
+}
+
+
+void _test_unhandled_cb(int event_id, void *event_data, void *context)
+{
+  assert_num_equal(event_id, 2);
+  assert_string_equal((char *)event_data, "event");
+  assert_string_equal((char *)context, "unhandled");
+
+  _test_global_unhandled_counter++;
+}
+
+
+void test_impl()
+{
+  struct EventEmitter *event_emitter = eventemitter_new();
+
+  assert_num_equal(eventemitter_remove_listener_by_id(NULL, 1), -1);
+  assert_num_equal(eventemitter_remove_listener_by_id(event_emitter, 0), -1);
+  assert_num_equal(eventemitter_remove_listener_by_id(event_emitter, 1), 0);
+
+  unsigned int ids[TEST_LISTENER_COUNT];
+  int          sum = 0;
+  for (size_t index = 0; index < TEST_LISTENER_COUNT; index++)
+  {
+    ids[index] = eventemitter_on(event_emitter, 1, _test_cb, (void *)index);
+    sum        = sum + (int)index;
+  }
+  unsigned int unhandled_id = eventemitter_else(event_emitter, _test_unhandled_cb, "unhandled");
+
+  // mismatching event ID or listener type is not removed
+  assert_num_equal(eventemitter_remove_listener(event_emitter, 2, ids[0]), 0);
+  assert_num_equal(eventemitter_remove_listener(event_emitter, 1, unhandled_id), 0);
+  assert_num_equal(eventemitter_remove_unhandled_listener(event_emitter, ids[0]), 0);
+
+  // remove most listeners using all remove functions, which triggers compaction along the way
+  for (size_t index = 0; index < TEST_LISTENER_COUNT; index++)
+  {
+    if (index % 10 == 0)
+    {
+      continue;
+    }
+
+    int removed = 0;
+    if (index % 3 == 0)
+    {
+      removed = eventemitter_remove_listener_by_id(event_emitter, ids[index]);
+    }
+    else
+    {
+      removed = eventemitter_off(event_emitter, 1, ids[index]);
+    }
+    assert_num_equal(removed, 1);
+    assert_num_equal(eventemitter_remove_listener_by_id(event_emitter, ids[index]), 0);
+    sum = sum - (int)index;
+
+    _test_global_sum        = 0;
+    _test_global_last_index = -1;
+    assert_num_equal(eventemitter_emit(event_emitter, 1, "event"), (size_t)eventemitter_listeners_count(event_emitter, 1));
+    assert_num_equal(_test_global_sum, sum);
+  }
+  assert_num_equal(eventemitter_listeners_count(event_emitter, 1), TEST_LISTENER_COUNT / 10);
+
+  assert_num_equal(eventemitter_emit(event_emitter, 2, "event"), 1);
+  assert_num_equal(eventemitter_remove_listener_by_id(event_emitter, unhandled_id), 1);
+  assert_num_equal(eventemitter_emit(event_emitter, 2, "event"), 0);
+  assert_num_equal(_test_global_unhandled_counter, 1);
+
+  for (size_t index = 0; index < TEST_LISTENER_COUNT; index = index + 10)
+  {
+    assert_num_equal(eventemitter_remove_listener_by_id(event_emitter, ids[index]), 1);
+  }
+  assert_num_equal(eventemitter_listeners_count(event_emitter, 1), 0);
+  assert_num_equal(eventemitter_emit(event_emitter, 1, "event"), 0);
+
+  // slots are reused after removal
+  unsigned int id = eventemitter_on(event_emitter, 1, _test_cb, (void *)0);
+  assert_num_equal(id, TEST_LISTENER_COUNT + 2);
+  assert_num_equal(eventemitter_listeners_count(event_emitter, 1), 1);
+  assert_num_equal(eventemitter_remove_listener_by_id(event_emitter, id), 1);
+
+  eventemitter_release(event_emitter);
+} /* test_impl */
+
+
+int main()
+{
+  test_run(test_impl);
+}
+
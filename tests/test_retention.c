@@ -0,0 +1,180 @@
+#include "test.h"
+
+struct EventEmitter *_test_global_emitter    = NULL;
+int                 _test_global_counter     = 0;
+int                 _test_global_unhandled   = 0;
+size_t              _test_global_allocations = 0;
+
+
+void *_test_allocate(size_t size, void *context)
+{
+  (void)context;
+
+  _test_global_allocations++;
+
+  return(malloc(size));
+}
+
+
+void *_test_reallocate(void *pointer, size_t size, void *context)
+{
+  (void)context;
+
+  if (pointer == NULL)
+  {
+    _test_global_allocations++;
+  }
+
+  return(realloc(pointer, size));
+}
+
+
+void _test_deallocate(void *pointer, void *context)
+{
+  (void)context;
+
+  if (pointer != NULL)
+  {
+    _test_global_allocations--;
+  }
+  free(pointer);
+}
+
+
+void _test_cb(void *event_data, void *context)
+{
+  assert_string_equal((char *)event_data, "event");
+  assert_true(context == NULL);
+
+  _test_global_counter++;
+}
+
+
+void _test_readd_cb(void *event_data, void *context)
+{
+  _test_cb(event_data, context);
+
+  // the emptied event is reused once the emit is done
+  assert_true(eventemitter_once(_test_global_emitter, 2, _test_cb, NULL) > 0);
+}
+
+
+void _test_unhandled_cb(int event_id, void *event_data, void *context)
+{
+  (void)event_id;
+  (void)event_data;
+  (void)context;
+
+  _test_global_unhandled++;
+}
+
+
+void _test_check_churn(struct EventEmitter *event_emitter, int first_event_id)
+{
+  // once listeners of the same events, triggered and added again
+  for (int round = 0; round < 100; round++)
+  {
+    for (int event_id = first_event_id; event_id < first_event_id + 4; event_id++)
+    {
+      assert_true(eventemitter_once(event_emitter, event_id, _test_cb, NULL) > 0);
+    }
+    for (int event_id = first_event_id; event_id < first_event_id + 4; event_id++)
+    {
+      assert_num_equal(eventemitter_emit(event_emitter, event_id, "event"), 1);
+      assert_num_equal(eventemitter_listeners_count(event_emitter, event_id), 0);
+    }
+  }
+}
+
+
+void test_impl()
+{
+  assert_true(!eventemitter_set_retention(NULL, 4));
+  assert_num_equal(eventemitter_compact(NULL), -1);
+
+  _test_global_emitter = eventemitter_new();
+  assert_true(eventemitter_else(_test_global_emitter, _test_unhandled_cb, NULL) > 0);
+
+  // nothing is kept by default
+  _test_check_churn(_test_global_emitter, 1);
+  assert_num_equal(eventemitter_compact(_test_global_emitter), 0);
+
+  assert_true(eventemitter_set_retention(_test_global_emitter, 3));
+  _test_check_churn(_test_global_emitter, 1);
+  assert_num_equal(_test_global_counter, 800);
+
+  // emptied events are handled as events without listeners
+  _test_global_unhandled = 0;
+  assert_num_equal(eventemitter_emit(_test_global_emitter, 1, "event"), 1);
+  assert_num_equal(_test_global_unhandled, 1);
+
+  // removed listeners, emptied during emit and removal of all listeners of kept events
+  unsigned int callback_id = eventemitter_on(_test_global_emitter, 1, _test_cb, NULL);
+  assert_num_equal(eventemitter_remove_listener(_test_global_emitter, 1, callback_id), 1);
+  assert_true(eventemitter_once(_test_global_emitter, 2, _test_readd_cb, NULL) > 0);
+  _test_global_counter = 0;
+  assert_num_equal(eventemitter_emit(_test_global_emitter, 2, "event"), 1);
+  assert_num_equal(eventemitter_emit(_test_global_emitter, 2, "event"), 1);
+  assert_num_equal(_test_global_counter, 2);
+  assert_true(eventemitter_remove_all_event_listeners(_test_global_emitter, 3));
+  assert_num_equal(eventemitter_compact(_test_global_emitter), 2);
+  assert_num_equal(eventemitter_compact(_test_global_emitter), 0);
+
+  // lowering the limit releases the kept events
+  _test_check_churn(_test_global_emitter, 10);
+  assert_true(eventemitter_set_retention(_test_global_emitter, 1));
+  assert_num_equal(eventemitter_compact(_test_global_emitter), 0);
+  _test_check_churn(_test_global_emitter, 10);
+  assert_true(eventemitter_set_retention(_test_global_emitter, 100));
+  assert_num_equal(eventemitter_compact(_test_global_emitter), 1);
+
+  // kept events are released with the emitter and ignored when frozen
+  _test_check_churn(_test_global_emitter, -20);
+  assert_true(eventemitter_on(_test_global_emitter, 5, _test_cb, NULL) > 0);
+  assert_true(eventemitter_freeze(_test_global_emitter));
+  _test_global_unhandled = 0;
+  assert_num_equal(eventemitter_emit(_test_global_emitter, -20, "event"), 1);
+  assert_num_equal(eventemitter_emit(_test_global_emitter, 5, "event"), 1);
+  assert_num_equal(_test_global_unhandled, 1);
+  eventemitter_release(_test_global_emitter);
+
+  // events in the ID range
+  struct EventEmitter *event_emitter = eventemitter_new_with_id_range(0, 7);
+  assert_true(eventemitter_set_retention(event_emitter, 8));
+  _test_check_churn(event_emitter, 4);
+  assert_num_equal(eventemitter_compact(event_emitter), 4);
+  _test_check_churn(event_emitter, 4);
+  eventemitter_release(event_emitter);
+
+  // the internal memory of released events is returned to the allocator, except memory still in use
+  struct EventEmitterAllocator allocator = { _test_allocate, _test_reallocate, _test_deallocate, NULL };
+  event_emitter = eventemitter_new_with_allocator(&allocator);
+  assert_true(eventemitter_on(event_emitter, 0, _test_cb, NULL) > 0);
+  for (int event_id = 1; event_id < 300; event_id++)
+  {
+    assert_true(eventemitter_on(event_emitter, event_id, _test_cb, NULL) > 0);
+  }
+  for (int event_id = 1; event_id < 300; event_id++)
+  {
+    assert_true(eventemitter_remove_all_event_listeners(event_emitter, event_id));
+  }
+  size_t allocations = _test_global_allocations;
+  assert_num_equal(eventemitter_compact(event_emitter), 0);
+  assert_true(_test_global_allocations < allocations);
+  allocations = _test_global_allocations;
+  assert_num_equal(eventemitter_compact(event_emitter), 0);
+  assert_num_equal(_test_global_allocations, allocations);
+  _test_global_counter = 0;
+  assert_num_equal(eventemitter_emit(event_emitter, 0, "event"), 1);
+  assert_true(eventemitter_on(event_emitter, 1, _test_cb, NULL) > 0);
+  assert_num_equal(eventemitter_emit(event_emitter, 1, "event"), 1);
+  assert_num_equal(_test_global_counter, 2);
+  eventemitter_release(event_emitter);
+  assert_num_equal(_test_global_allocations, 0);
+} /* test_impl */
+
+
+int main()
+{
+  test_run(test_impl);
+}
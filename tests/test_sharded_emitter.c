@@ -0,0 +1,146 @@
+#include "eventemitter_sharded.h"
+#include "test.h"
+
+#ifdef EVENTEMITTER_THREADS
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+
+#define TEST_SHARDS              4
+#define TEST_EMITS_PER_THREAD    10000
+
+struct TestShard
+{
+  pthread_t thread;
+  size_t    shard;
+  size_t    local;
+  size_t    remote;
+  size_t    broadcasts;
+};
+
+struct EventEmitterSharded *_test_global_emitter = NULL;
+atomic_size_t              _test_global_ready    = 0;
+atomic_size_t              _test_global_done     = 0;
+
+
+void _test_local_cb(void *event_data, void *context)
+{
+  // listeners are invoked on the thread of their own shard only
+  assert_true(event_data == context);
+
+  ((struct TestShard *)context)->local++;
+}
+
+
+void _test_remote_cb(void *event_data, void *context)
+{
+  assert_true((size_t)event_data < TEST_SHARDS);
+
+  ((struct TestShard *)context)->remote++;
+}
+
+
+void _test_broadcast_cb(void *event_data, void *context)
+{
+  assert_string_equal((char *)event_data, "broadcast");
+
+  ((struct TestShard *)context)->broadcasts++;
+}
+
+
+void *_test_shard_thread(void *context)
+{
+  struct TestShard    *test_shard    = (struct TestShard *)context;
+  struct EventEmitter *event_emitter = eventemitter_sharded_get_shard(_test_global_emitter, test_shard->shard);
+
+  assert_true(eventemitter_on(event_emitter, 1, _test_local_cb, test_shard) > 0);
+  assert_true(eventemitter_on(event_emitter, 2, _test_remote_cb, test_shard) > 0);
+  assert_true(eventemitter_on(event_emitter, 3, _test_broadcast_cb, test_shard) > 0);
+  atomic_fetch_add(&_test_global_ready, 1);
+  while (atomic_load(&_test_global_ready) < TEST_SHARDS)
+  {
+    sched_yield();
+  }
+
+  // local emits, and events for the next shard which wait in its inbox while it is full
+  size_t next_shard = (test_shard->shard + 1) % TEST_SHARDS;
+  for (size_t index = 0; index < TEST_EMITS_PER_THREAD; index++)
+  {
+    assert_num_equal(eventemitter_emit(event_emitter, 1, test_shard), 1);
+    while (!eventemitter_sharded_emit_to(_test_global_emitter, next_shard, 2, (void *)test_shard->shard))
+    {
+      eventemitter_sharded_dispatch(_test_global_emitter, test_shard->shard, 0);
+      sched_yield();
+    }
+  }
+  atomic_fetch_add(&_test_global_done, 1);
+
+  while (test_shard->remote < TEST_EMITS_PER_THREAD || test_shard->broadcasts < 1 || atomic_load(&_test_global_done) < TEST_SHARDS)
+  {
+    if (!eventemitter_sharded_dispatch(_test_global_emitter, test_shard->shard, 0))
+    {
+      sched_yield();
+    }
+  }
+
+  return(NULL);
+} /* _test_shard_thread */
+
+
+void test_impl()
+{
+  assert_true(eventemitter_sharded_new(0, 16) == NULL);
+  assert_true(eventemitter_sharded_new(2, 0) == NULL);
+  assert_true(eventemitter_sharded_new_with_allocator(NULL, 2, 16) == NULL);
+  assert_num_equal(eventemitter_sharded_shards_count(NULL), 0);
+  assert_true(eventemitter_sharded_get_shard(NULL, 0) == NULL);
+  assert_true(!eventemitter_sharded_emit_to(NULL, 0, 1, NULL));
+  assert_num_equal(eventemitter_sharded_broadcast(NULL, 1, NULL), 0);
+  assert_num_equal(eventemitter_sharded_dispatch(NULL, 0, 0), -1);
+  eventemitter_sharded_release(NULL);
+
+  _test_global_emitter = eventemitter_sharded_new(TEST_SHARDS, 64);
+  assert_num_equal(eventemitter_sharded_shards_count(_test_global_emitter), TEST_SHARDS);
+  assert_true(eventemitter_sharded_get_shard(_test_global_emitter, TEST_SHARDS) == NULL);
+  assert_true(!eventemitter_sharded_emit_to(_test_global_emitter, TEST_SHARDS, 1, NULL));
+  assert_num_equal(eventemitter_sharded_dispatch(_test_global_emitter, TEST_SHARDS, 0), -1);
+  assert_true(eventemitter_sharded_get_shard(_test_global_emitter, 0) != eventemitter_sharded_get_shard(_test_global_emitter, 1));
+
+  // the broadcast is queued before the threads start so it is dispatched by each of them
+  assert_num_equal(eventemitter_sharded_broadcast(_test_global_emitter, 3, "broadcast"), TEST_SHARDS);
+
+  struct TestShard test_shards[TEST_SHARDS];
+  for (size_t index = 0; index < TEST_SHARDS; index++)
+  {
+    test_shards[index].shard      = index;
+    test_shards[index].local      = 0;
+    test_shards[index].remote     = 0;
+    test_shards[index].broadcasts = 0;
+    assert_num_equal(pthread_create(&test_shards[index].thread, NULL, _test_shard_thread, &test_shards[index]), 0);
+  }
+  for (size_t index = 0; index < TEST_SHARDS; index++)
+  {
+    assert_num_equal(pthread_join(test_shards[index].thread, NULL), 0);
+    assert_num_equal(test_shards[index].local, TEST_EMITS_PER_THREAD);
+    assert_num_equal(test_shards[index].remote, TEST_EMITS_PER_THREAD);
+    assert_num_equal(test_shards[index].broadcasts, 1);
+  }
+
+  eventemitter_sharded_release(_test_global_emitter);
+} /* test_impl */
+
+#else
+
+
+void test_impl()
+{
+}
+
+#endif
+
+
+int main()
+{
+  test_run(test_impl);
+}
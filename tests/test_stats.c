@@ -0,0 +1,186 @@
+#include "test.h"
+
+#ifdef EVENTEMITTER_STATS
+
+#ifdef EVENTEMITTER_THREADS
+#include "eventemitter_concurrent.h"
+#endif
+
+int _test_global_counter = 0;
+int _test_global_events  = 0;
+
+
+void _test_cb(void *event_data, void *context)
+{
+  assert_string_equal((char *)event_data, "event");
+  assert_true(context == NULL);
+
+  _test_global_counter++;
+}
+
+
+void _test_unhandled_cb(int event_id, void *event_data, void *context)
+{
+  assert_true(event_id == 3 || event_id == 2);
+  assert_string_equal((char *)event_data, "event");
+  assert_true(context == NULL);
+}
+
+
+void _test_range_cb(int event_id, void *event_data, void *context)
+{
+  assert_true(event_id >= 10 && event_id <= 20);
+  assert_string_equal((char *)event_data, "event");
+  assert_true(context == NULL);
+}
+
+
+void _test_iterate_cb(int event_id, const struct EventEmitterStats *stats, void *context)
+{
+  assert_string_equal((char *)context, "test");
+
+  if (event_id == 1)
+  {
+    assert_num_equal(stats->emits, 3);
+  }
+  else
+  {
+    assert_num_equal(event_id, 2);
+    assert_num_equal(stats->emits, 1);
+  }
+  _test_global_events++;
+}
+
+
+void _test_concurrent_iterate_cb(int event_id, const struct EventEmitterStats *stats, void *context)
+{
+  assert_true(context == NULL);
+
+  assert_true(event_id == 1 || event_id == 2);
+  assert_num_equal(stats->peak_listeners, event_id == 1 ? 2 : 1);
+  _test_global_events++;
+}
+
+
+void test_impl()
+{
+  struct EventEmitter      *event_emitter = eventemitter_new();
+  struct EventEmitterStats stats;
+
+  assert_true(!eventemitter_get_stats(NULL, &stats));
+  assert_true(!eventemitter_get_stats(event_emitter, NULL));
+  assert_true(!eventemitter_get_event_stats(event_emitter, 1, &stats));
+  assert_true(!eventemitter_iterate_event_stats(event_emitter, NULL, NULL));
+
+  assert_true(eventemitter_on(event_emitter, 1, _test_cb, NULL) > 0);
+  assert_true(eventemitter_on(event_emitter, 1, _test_cb, NULL) > 0);
+  assert_true(eventemitter_once(event_emitter, 1, _test_cb, NULL) > 0);
+  assert_true(eventemitter_once(event_emitter, 2, _test_cb, NULL) > 0);
+  assert_true(eventemitter_else(event_emitter, _test_unhandled_cb, NULL) > 0);
+
+  assert_num_equal(eventemitter_emit(event_emitter, 1, "event"), 3);
+  assert_num_equal(eventemitter_emit(event_emitter, 1, "event"), 2);
+  assert_num_equal(eventemitter_emit(event_emitter, 2, "event"), 1);
+  assert_num_equal(eventemitter_emit(event_emitter, 3, "event"), 1);
+  int  event_ids[]   = { 1, 2 };
+  void *event_data[] = { "event", "event" };
+  assert_num_equal(eventemitter_emit_batch(event_emitter, event_ids, event_data, 2), 3);
+
+  assert_true(eventemitter_get_stats(event_emitter, &stats));
+  assert_num_equal(stats.emits, 6);
+  assert_num_equal(stats.invocations, 8);
+  assert_num_equal(stats.unhandled, 2);
+  assert_num_equal(stats.once_removals, 2);
+  assert_num_equal(stats.peak_listeners, 5);
+
+  assert_true(eventemitter_get_event_stats(event_emitter, 1, &stats));
+  assert_num_equal(stats.emits, 3);
+  assert_num_equal(stats.invocations, 7);
+  assert_num_equal(stats.unhandled, 0);
+  assert_num_equal(stats.once_removals, 1);
+  assert_num_equal(stats.peak_listeners, 3);
+
+  // event 2 had listeners so it is still tracked, event 3 never had listeners
+  assert_true(eventemitter_get_event_stats(event_emitter, 2, &stats));
+  assert_num_equal(stats.emits, 1);
+  assert_num_equal(stats.invocations, 1);
+  assert_num_equal(stats.once_removals, 1);
+  assert_num_equal(stats.peak_listeners, 1);
+  assert_true(!eventemitter_get_event_stats(event_emitter, 3, &stats));
+
+  assert_true(eventemitter_iterate_event_stats(event_emitter, _test_iterate_cb, "test"));
+  assert_num_equal(_test_global_events, 2);
+
+  eventemitter_release(event_emitter);
+
+  // range listeners are counted the same as the returned amount of invoked listeners
+  event_emitter = eventemitter_new();
+  assert_true(eventemitter_on_range(event_emitter, 10, 20, _test_range_cb, NULL) > 0);
+  assert_true(eventemitter_on(event_emitter, 12, _test_cb, NULL) > 0);
+  int range_ids[] = { 15, 12 };
+  int invoked     = eventemitter_emit(event_emitter, 15, "event");
+  invoked = invoked + eventemitter_emit(event_emitter, 12, "event");
+  invoked = invoked + eventemitter_emit_batch(event_emitter, range_ids, event_data, 2);
+  assert_num_equal(invoked, 6);
+  assert_true(eventemitter_get_stats(event_emitter, &stats));
+  assert_num_equal(stats.emits, 4);
+  assert_num_equal(stats.invocations, 6);
+  assert_num_equal(stats.unhandled, 0);
+  assert_true(eventemitter_get_event_stats(event_emitter, 12, &stats));
+  assert_num_equal(stats.emits, 2);
+  assert_num_equal(stats.invocations, 4);
+  eventemitter_release(event_emitter);
+
+#ifdef EVENTEMITTER_THREADS
+  struct EventEmitterConcurrent *concurrent_emitter = eventemitter_concurrent_new();
+
+  assert_true(!eventemitter_concurrent_get_stats(NULL, &stats));
+  assert_true(!eventemitter_concurrent_get_event_stats(concurrent_emitter, 1, &stats));
+
+  assert_true(eventemitter_concurrent_add_listener(concurrent_emitter, 1, _test_cb, NULL) > 0);
+  assert_true(eventemitter_concurrent_add_listener(concurrent_emitter, 1, _test_cb, NULL) > 0);
+  assert_true(eventemitter_concurrent_add_listener(concurrent_emitter, 2, _test_cb, NULL) > 0);
+  assert_true(eventemitter_concurrent_add_unhandled_listener(concurrent_emitter, _test_unhandled_cb, NULL) > 0);
+  assert_true(eventemitter_concurrent_remove_all_event_listeners(concurrent_emitter, 2));
+
+  assert_num_equal(eventemitter_concurrent_emit(concurrent_emitter, 1, "event"), 2);
+  assert_num_equal(eventemitter_concurrent_emit(concurrent_emitter, 2, "event"), 1);
+  assert_num_equal(eventemitter_concurrent_emit(concurrent_emitter, 3, "event"), 1);
+
+  assert_true(eventemitter_concurrent_get_stats(concurrent_emitter, &stats));
+  assert_num_equal(stats.emits, 3);
+  assert_num_equal(stats.invocations, 2);
+  assert_num_equal(stats.unhandled, 2);
+  assert_num_equal(stats.peak_listeners, 4);
+
+  assert_true(eventemitter_concurrent_get_event_stats(concurrent_emitter, 1, &stats));
+  assert_num_equal(stats.emits, 1);
+  assert_num_equal(stats.invocations, 2);
+  assert_num_equal(stats.peak_listeners, 2);
+  assert_true(eventemitter_concurrent_get_event_stats(concurrent_emitter, 2, &stats));
+  assert_num_equal(stats.emits, 0);
+  assert_num_equal(stats.peak_listeners, 1);
+
+  _test_global_events = 0;
+  assert_true(eventemitter_concurrent_iterate_event_stats(concurrent_emitter, _test_concurrent_iterate_cb, NULL));
+  assert_num_equal(_test_global_events, 2);
+
+  eventemitter_concurrent_release(concurrent_emitter);
+#endif
+} /* test_impl */
+
+#else
+
+
+void test_impl()
+{
+}
+
+#endif
+
+
+int main()
+{
+  test_run(test_impl);
+}
+
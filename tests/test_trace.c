@@ -0,0 +1,176 @@
+#include "test.h"
+
+#ifdef EVENTEMITTER_TRACE
+
+#include <stdio.h>
+#include <string.h>
+
+struct EventEmitter *_test_global_emitter = NULL;
+char                _test_global_log[256];
+uint64_t            _test_global_timestamp = 0;
+
+
+void _test_log(const char *prefix, int event_id, unsigned int value, uint64_t timestamp, void *context)
+{
+  assert_string_equal((char *)context, "trace");
+  assert_true(timestamp >= _test_global_timestamp);
+  _test_global_timestamp = timestamp;
+
+  char entry[32];
+  snprintf(entry, sizeof(entry), "%s%d:%u ", prefix, event_id, value);
+  strcat(_test_global_log, entry);
+}
+
+
+void _test_pre_emit(int event_id, uint64_t timestamp, void *context)
+{
+  _test_log("E", event_id, 0, timestamp, context);
+}
+
+
+void _test_post_emit(int event_id, int callback_counter, uint64_t timestamp, void *context)
+{
+  _test_log("e", event_id, (unsigned int)callback_counter, timestamp, context);
+}
+
+
+void _test_pre_listener(int event_id, unsigned int callback_id, uint64_t timestamp, void *context)
+{
+  _test_log("L", event_id, callback_id, timestamp, context);
+}
+
+
+void _test_post_listener(int event_id, unsigned int callback_id, uint64_t timestamp, void *context)
+{
+  _test_log("l", event_id, callback_id, timestamp, context);
+}
+
+
+void _test_cb(void *event_data, void *context)
+{
+  assert_string_equal((char *)event_data, "event");
+  assert_true(context == NULL);
+}
+
+
+void _test_cb_nested(void *event_data, void *context)
+{
+  _test_cb(event_data, context);
+
+  assert_num_equal(eventemitter_emit(_test_global_emitter, 1, "event"), 1);
+}
+
+
+void _test_cb_stop(void *event_data, void *context)
+{
+  _test_cb(event_data, context);
+
+  // the rest of the dispatch is not traced
+  assert_true(eventemitter_set_trace_hooks(_test_global_emitter, NULL));
+}
+
+
+void _test_unhandled_cb(int event_id, void *event_data, void *context)
+{
+  assert_num_equal(event_id, 5);
+  _test_cb(event_data, context);
+}
+
+
+void test_impl()
+{
+  _test_global_emitter = eventemitter_new();
+
+  struct EventEmitterTraceHooks hooks = { _test_pre_emit, _test_post_emit, _test_pre_listener, _test_post_listener, "trace" };
+
+  assert_true(!eventemitter_set_trace_hooks(NULL, &hooks));
+  assert_true(eventemitter_set_trace_hooks(_test_global_emitter, &hooks));
+
+  assert_num_equal(eventemitter_on(_test_global_emitter, 1, _test_cb, NULL), 1);
+  assert_num_equal(eventemitter_once(_test_global_emitter, 1, _test_cb, NULL), 2);
+  assert_num_equal(eventemitter_on(_test_global_emitter, 2, _test_cb_nested, NULL), 3);
+
+  _test_global_log[0] = 0;
+  assert_num_equal(eventemitter_emit(_test_global_emitter, 1, "event"), 2);
+  assert_string_equal(_test_global_log, "E1:0 L1:1 l1:1 L1:2 l1:2 e1:2 ");
+  assert_num_equal(eventemitter_listeners_count(_test_global_emitter, 1), 1);
+
+  // nested emits and events without listeners
+  _test_global_log[0] = 0;
+  assert_num_equal(eventemitter_emit(_test_global_emitter, 2, "event"), 1);
+  assert_num_equal(eventemitter_emit(_test_global_emitter, 5, "event"), 0);
+  assert_string_equal(_test_global_log, "E2:0 L2:3 E1:0 L1:1 l1:1 e1:1 l2:3 e2:1 E5:0 e5:0 ");
+
+  // unhandled listeners and batches
+  assert_num_equal(eventemitter_else(_test_global_emitter, _test_unhandled_cb, NULL), 4);
+  int  event_ids[]  = { 5, 1 };
+  void *event_data[] = { "event", "event" };
+  _test_global_log[0] = 0;
+  assert_num_equal(eventemitter_emit_batch(_test_global_emitter, event_ids, event_data, 2), 2);
+  assert_string_equal(_test_global_log, "E5:0 L5:4 l5:4 e5:1 E1:0 L1:1 l1:1 e1:1 ");
+
+  // hooks are optional
+  hooks.pre_emit      = NULL;
+  hooks.post_listener = NULL;
+  assert_true(eventemitter_set_trace_hooks(_test_global_emitter, &hooks));
+  _test_global_log[0] = 0;
+  assert_num_equal(eventemitter_emit(_test_global_emitter, 1, "event"), 1);
+  assert_string_equal(_test_global_log, "L1:1 e1:1 ");
+
+  // tracing may be stopped by a callback
+  assert_num_equal(eventemitter_prepend_listener(_test_global_emitter, 1, _test_cb_stop, NULL), 5);
+  _test_global_log[0] = 0;
+  assert_num_equal(eventemitter_emit(_test_global_emitter, 1, "event"), 2);
+  assert_string_equal(_test_global_log, "L1:5 ");
+  _test_global_log[0] = 0;
+  assert_num_equal(eventemitter_emit(_test_global_emitter, 1, "event"), 2);
+  assert_string_equal(_test_global_log, "");
+
+  eventemitter_release(_test_global_emitter);
+
+  // frozen emits
+  struct EventEmitterTraceHooks all_hooks = { _test_pre_emit, _test_post_emit, _test_pre_listener, _test_post_listener, "trace" };
+  _test_global_emitter = eventemitter_new();
+  assert_true(eventemitter_set_trace_hooks(_test_global_emitter, &all_hooks));
+  assert_num_equal(eventemitter_on(_test_global_emitter, 1, _test_cb, NULL), 1);
+  assert_num_equal(eventemitter_else(_test_global_emitter, _test_unhandled_cb, NULL), 2);
+  assert_true(eventemitter_freeze(_test_global_emitter));
+  _test_global_log[0] = 0;
+  assert_num_equal(eventemitter_emit(_test_global_emitter, 1, "event"), 1);
+  assert_num_equal(eventemitter_emit_batch(_test_global_emitter, event_ids, event_data, 2), 2);
+  assert_string_equal(_test_global_log, "E1:0 L1:1 l1:1 e1:1 E5:0 L5:2 l5:2 e5:1 E1:0 L1:1 l1:1 e1:1 ");
+  assert_true(eventemitter_set_trace_hooks(_test_global_emitter, NULL));
+  _test_global_log[0] = 0;
+  assert_num_equal(eventemitter_emit(_test_global_emitter, 1, "event"), 1);
+  assert_string_equal(_test_global_log, "");
+  eventemitter_release(_test_global_emitter);
+
+#ifdef EVENTEMITTER_THREADS
+  // async emits, the listener hooks are invoked on the worker thread
+  _test_global_emitter = eventemitter_new();
+  assert_true(eventemitter_set_trace_hooks(_test_global_emitter, &all_hooks));
+  assert_num_equal(eventemitter_on(_test_global_emitter, 3, _test_cb, NULL), 1);
+  assert_true(eventemitter_start_workers(_test_global_emitter, 1));
+  _test_global_log[0] = 0;
+  assert_num_equal(eventemitter_wait_async_emit(eventemitter_emit_async(_test_global_emitter, 3, "event")), 1);
+  assert_num_equal(eventemitter_wait_async_emit(eventemitter_emit_async(_test_global_emitter, 7, "event")), 0);
+  assert_string_equal(_test_global_log, "E3:0 L3:1 l3:1 e3:1 E7:0 e7:0 ");
+  eventemitter_release(_test_global_emitter);
+#endif
+} /* test_impl */
+
+#else
+
+
+void test_impl()
+{
+}
+
+#endif
+
+
+int main()
+{
+  test_run(test_impl);
+}
+
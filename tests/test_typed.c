@@ -0,0 +1,124 @@
+#include "eventemitter_typed.h"
+#include "test.h"
+#include <limits.h>
+#include <string.h>
+
+enum TestSignal
+{
+  TEST_SIGNAL_OPEN,
+  TEST_SIGNAL_CLOSE,
+  TEST_SIGNAL_COUNT,
+};
+
+struct TestPayload
+{
+  char *path;
+  int  size;
+};
+
+EVENTEMITTER_DEFINE_TYPED(test_signals, enum TestSignal, const struct TestPayload *, TEST_SIGNAL_COUNT, 4)
+EVENTEMITTER_DEFINE_TYPED(test_numbers, int, int, 2, 2)
+
+struct test_signals _test_global_emitter;
+char                _test_global_order[64];
+unsigned int        _test_global_remove_id = 0;
+int                 _test_global_sum       = 0;
+
+
+void _test_cb(const struct TestPayload *payload, void *context)
+{
+  assert_string_equal(payload->path, "file.txt");
+  assert_num_equal(payload->size, 10);
+
+  strcat(_test_global_order, (char *)context);
+}
+
+
+void _test_change_cb(const struct TestPayload *payload, void *context)
+{
+  _test_cb(payload, context);
+
+  // not invoked by this emit
+  assert_num_equal(test_signals_remove_listener(&_test_global_emitter, TEST_SIGNAL_OPEN, _test_global_remove_id), 1);
+  assert_true(test_signals_on(&_test_global_emitter, TEST_SIGNAL_OPEN, _test_cb, "N") > 0);
+  assert_num_equal(test_signals_prepend(&_test_global_emitter, TEST_SIGNAL_OPEN, _test_cb, "P"), 0);
+}
+
+
+void _test_number_cb(int value, void *context)
+{
+  _test_global_sum = _test_global_sum + value * *(int *)context;
+}
+
+
+void test_impl()
+{
+  struct TestPayload payload = { "file.txt", 10 };
+
+  test_signals_init(&_test_global_emitter);
+
+  assert_num_equal(test_signals_on(NULL, TEST_SIGNAL_OPEN, _test_cb, "A"), 0);
+  assert_num_equal(test_signals_on(&_test_global_emitter, TEST_SIGNAL_OPEN, NULL, "A"), 0);
+  assert_num_equal(test_signals_on(&_test_global_emitter, TEST_SIGNAL_COUNT, _test_cb, "A"), 0);
+  assert_num_equal(test_signals_emit(&_test_global_emitter, TEST_SIGNAL_COUNT, &payload), -1);
+  assert_num_equal(test_signals_listeners_count(&_test_global_emitter, TEST_SIGNAL_COUNT), -1);
+  assert_num_equal(test_signals_remove_listener(&_test_global_emitter, TEST_SIGNAL_OPEN, 0), -1);
+
+  assert_num_equal(test_signals_on(&_test_global_emitter, TEST_SIGNAL_OPEN, _test_cb, "A"), 1);
+  assert_num_equal(test_signals_once(&_test_global_emitter, TEST_SIGNAL_OPEN, _test_cb, "B"), 2);
+  assert_num_equal(test_signals_prepend(&_test_global_emitter, TEST_SIGNAL_OPEN, _test_cb, "C"), 3);
+  assert_num_equal(test_signals_on(&_test_global_emitter, TEST_SIGNAL_CLOSE, _test_cb, "D"), 4);
+  assert_num_equal(test_signals_listeners_count(&_test_global_emitter, TEST_SIGNAL_OPEN), 3);
+
+  _test_global_order[0] = 0;
+  assert_num_equal(test_signals_emit(&_test_global_emitter, TEST_SIGNAL_OPEN, &payload), 3);
+  assert_string_equal(_test_global_order, "CAB");
+  assert_num_equal(test_signals_listeners_count(&_test_global_emitter, TEST_SIGNAL_OPEN), 2);
+  _test_global_order[0] = 0;
+  assert_num_equal(test_signals_emit(&_test_global_emitter, TEST_SIGNAL_OPEN, &payload), 2);
+  assert_num_equal(test_signals_emit(&_test_global_emitter, TEST_SIGNAL_CLOSE, &payload), 1);
+  assert_string_equal(_test_global_order, "CAD");
+
+  // changes during emit
+  assert_num_equal(test_signals_remove_listener(&_test_global_emitter, TEST_SIGNAL_OPEN, 3), 1);
+  assert_num_equal(test_signals_remove_listener(&_test_global_emitter, TEST_SIGNAL_OPEN, 3), 0);
+  assert_num_equal(test_signals_remove_listener(&_test_global_emitter, TEST_SIGNAL_CLOSE, 1), 0);
+  assert_num_equal(test_signals_on(&_test_global_emitter, TEST_SIGNAL_OPEN, _test_change_cb, "E"), 5);
+  _test_global_remove_id = test_signals_on(&_test_global_emitter, TEST_SIGNAL_OPEN, _test_cb, "F");
+  _test_global_order[0] = 0;
+  assert_num_equal(test_signals_emit(&_test_global_emitter, TEST_SIGNAL_OPEN, &payload), 2);
+  assert_string_equal(_test_global_order, "AE");
+  assert_num_equal(test_signals_listeners_count(&_test_global_emitter, TEST_SIGNAL_OPEN), 3);
+
+  // the event table is full
+  assert_true(test_signals_on(&_test_global_emitter, TEST_SIGNAL_OPEN, _test_cb, "G") > 0);
+  assert_num_equal(test_signals_on(&_test_global_emitter, TEST_SIGNAL_OPEN, _test_cb, "H"), 0);
+
+  // integer event IDs and payloads
+  struct test_numbers numbers;
+  int                 factors[] = { 1, 10 };
+  test_numbers_init(&numbers);
+  assert_true(test_numbers_on(&numbers, 1, _test_number_cb, &factors[0]) > 0);
+  assert_true(test_numbers_on(&numbers, 1, _test_number_cb, &factors[1]) > 0);
+  assert_num_equal(test_numbers_emit(&numbers, 1, 3), 2);
+  assert_num_equal(test_numbers_emit(&numbers, 0, 3), 0);
+  assert_num_equal(test_numbers_emit(&numbers, -1, 3), -1);
+  assert_num_equal(test_numbers_emit(&numbers, 2, 3), -1);
+  assert_num_equal(_test_global_sum, 33);
+
+  // the callback ID counter skips 0 when it wraps around
+  numbers.next_callback_id = UINT_MAX;
+  assert_num_equal(test_numbers_on(&numbers, 0, _test_number_cb, &factors[0]), UINT_MAX);
+  assert_num_equal(test_numbers_on(&numbers, 0, _test_number_cb, &factors[1]), 1);
+  assert_num_equal(test_numbers_listeners_count(&numbers, 0), 2);
+  _test_global_sum = 0;
+  assert_num_equal(test_numbers_emit(&numbers, 0, 2), 2);
+  assert_num_equal(_test_global_sum, 22);
+} /* test_impl */
+
+
+int main()
+{
+  test_run(test_impl);
+}
+